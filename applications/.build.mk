@@ -11,6 +11,8 @@ $(1)_ASSETS := $$(wildcard applications/$($(1)_NAME)/*.markup) \
 
 $(1)_ASSETS := $$(patsubst applications/$($(1)_NAME)/%, $(BUILD_DIRECTORY_APPS)/$($(1)_NAME)/%, $$($(1)_ASSETS))
 
+$(1)_ASSETS += $$(patsubst %.markup, %.markup.bin, $$(filter %.markup, $$($(1)_ASSETS)))
+
 $(1)_OBJECTS = $$(patsubst applications/%.cpp, $$(BUILD_DIRECTORY)/applications/%.o, $$($(1)_SOURCES))
 
 TARGETS += $$($(1)_BINARY) $$($(1)_ASSETS)
@@ -21,7 +23,12 @@ $(BUILD_DIRECTORY_APPS)/$($(1)_NAME)/%: applications/$($(1)_NAME)/%
 	$$(DIRECTORY_GUARD)
 	cp $$< $$@
 
-$$($(1)_BINARY): $$($(1)_OBJECTS) $$(patsubst %, $$(BUILD_DIRECTORY_LIBS)/lib%.a, $$($(1)_LIBS) system) $(CRTS)
+$(BUILD_DIRECTORY_APPS)/$($(1)_NAME)/%.markup.bin: applications/$($(1)_NAME)/%.markup
+	$$(DIRECTORY_GUARD)
+	@echo [$(1)] [MARKUP-COMPILER] $$<
+	@toolbox/markup-compiler.py $$< $$@
+
+$$($(1)_BINARY): $$($(1)_OBJECTS) $$(patsubst %, $$(BUILD_DIRECTORY_LIBS)/lib%.a, $$($(1)_LIBS) system) $(CRTS) $(SHARED_LIBRARIES)
 	$$(DIRECTORY_GUARD)
 	@echo [$(1)] [LD] $($(1)_NAME)
 	@$(CXX) $(LDFLAGS) -o $$@ $$($(1)_OBJECTS) $$(patsubst %, -l%, $$($(1)_LIBS))
@@ -10,6 +10,9 @@
 #include "compositor/Renderer.h"
 #include "compositor/Window.h"
 
+// The connection buffer is small, don't let a batch outgrow it.
+#define CLIENT_MAX_PENDING_MESSAGES 16
+
 static List *_connected_client = nullptr;
 
 void client_handle_create_window(Client *client, CompositorCreateWindow create_window)
@@ -109,11 +112,11 @@ void client_handle_cursor_window(Client *client, CompositorCursorWindow cursor_w
         return;
     }
 
-    renderer_region_dirty(cursor_dirty_bound());
+    cursor_invalidate();
 
     window->cursor_state(cursor_window.state);
 
-    renderer_region_dirty(cursor_dirty_bound());
+    cursor_invalidate();
 }
 
 void client_handle_set_resolution(Client *client, CompositorSetResolution set_resolution)
@@ -215,8 +218,10 @@ void client_request_callback(Client *client, Connection *connection, PollEvent e
         client->disconnected = true;
         client_destroy_disconnected();
 
-        break;
+        return;
     }
+
+    client_flush_messages();
 }
 
 Client::Client(Connection *connection)
@@ -285,6 +290,14 @@ Result Client::send_message(CompositorMessage message)
         return ERR_STREAM_CLOSED;
     }
 
+    // Keep the messages in order with the events already queued.
+    Result result = flush_messages();
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
     connection_send(connection, &message, sizeof(CompositorMessage));
 
     if (handle_has_error(connection))
@@ -297,6 +310,61 @@ Result Client::send_message(CompositorMessage message)
     return SUCCESS;
 }
 
+void Client::queue_message(CompositorMessage message)
+{
+    if (disconnected)
+    {
+        return;
+    }
+
+    pending_messages.push_back(message);
+
+    if (pending_messages.count() >= CLIENT_MAX_PENDING_MESSAGES)
+    {
+        flush_messages();
+    }
+}
+
+Result Client::flush_messages()
+{
+    if (pending_messages.empty())
+    {
+        return SUCCESS;
+    }
+
+    if (disconnected)
+    {
+        pending_messages.clear();
+        return ERR_STREAM_CLOSED;
+    }
+
+    connection_send(connection, pending_messages.raw_storage(), pending_messages.count() * sizeof(CompositorMessage));
+
+    pending_messages.clear();
+
+    if (handle_has_error(connection))
+    {
+        logger_error("Failed to send messages to %08x: %s", this, handle_error_string(connection));
+        disconnected = true;
+        return handle_get_error(connection);
+    }
+
+    return SUCCESS;
+}
+
+void client_flush_messages()
+{
+    if (!_connected_client)
+    {
+        return;
+    }
+
+    list_foreach(Client, client, _connected_client)
+    {
+        client->flush_messages();
+    }
+}
+
 Iteration client_destroy_if_disconnected(void *target, Client *client)
 {
     __unused(target);
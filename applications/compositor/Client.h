@@ -2,6 +2,7 @@
 
 #include <libsystem/eventloop/Notifier.h>
 #include <libsystem/io/Connection.h>
+#include <libutils/Vector.h>
 
 #include "compositor/Protocol.h"
 
@@ -11,13 +12,23 @@ struct Client
     Connection *connection = nullptr;
     bool disconnected = false;
 
+    // Events are queued and written with a single call at the end of each
+    // event loop callback instead of one write per event.
+    Vector<CompositorMessage> pending_messages{};
+
     Client(Connection *connection);
 
     ~Client();
 
     Result send_message(CompositorMessage message);
+
+    void queue_message(CompositorMessage message);
+
+    Result flush_messages();
 };
 
 void client_broadcast(CompositorMessage message);
 
+void client_flush_messages();
+
 void client_destroy_disconnected();
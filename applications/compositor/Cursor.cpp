@@ -18,6 +18,14 @@ static RefPtr<Bitmap> _cursor_bitmaps[__CURSOR_COUNT] = {};
 
 static uint _last_click = 0;
 
+// Relative motion received since the last frame, applied by cursor_flush_motion().
+static Vec2i _pending_motion = Vec2i::zero();
+
+// With a hardware cursor plane moving the mouse doesn't touch the screen,
+// we only upload a new image when the cursor state changes.
+static bool _cursor_hardware = false;
+static CursorState _cursor_hardware_state = __CURSOR_COUNT;
+
 void cursor_initialize()
 {
     const char *cursor_paths[] = {
@@ -59,26 +67,33 @@ Vec2i vec2i_clamp_to_rect(Vec2i p, Rectangle rect)
     return p.clamped(rect.position(), rect.position() + rect.size());
 }
 
-Vec2i cursor_pack_mouse_position(MousePacket packet)
+Vec2i cursor_pack_mouse_position(Vec2i offset)
 {
-    return vec2i_clamp_to_rect(_mouse_position + Vec2i(packet.offx, packet.offy), renderer_bound());
+    return vec2i_clamp_to_rect(_mouse_position + offset, renderer_bound());
 }
 
-void cursor_handle_packet(MousePacket packet)
+static void cursor_apply(Vec2i offset, MouseButton buttons)
 {
     _mouse_old_position = _mouse_position;
-    _mouse_position = cursor_pack_mouse_position(packet);
+    _mouse_position = cursor_pack_mouse_position(offset);
 
     _mouse_old_buttons = _mouse_buttons;
-    _mouse_buttons = cursor_pack_mouse_buttons(packet);
+    _mouse_buttons = buttons;
 
     Window *window_under = manager_get_window_at(_mouse_position);
     Window *window_on_focus = manager_focus_window();
 
     if (_mouse_old_position != _mouse_position)
     {
-        renderer_region_dirty(cursor_dirty_bound_from_position(_mouse_old_position));
-        renderer_region_dirty(cursor_dirty_bound_from_position(_mouse_position));
+        if (_cursor_hardware)
+        {
+            renderer_move_cursor(_mouse_position);
+        }
+        else
+        {
+            renderer_region_dirty(cursor_dirty_bound_from_position(_mouse_old_position));
+            renderer_region_dirty(cursor_dirty_bound_from_position(_mouse_position));
+        }
 
         if (window_on_focus)
             window_on_focus->handle_mouse_move(_mouse_old_position, _mouse_position, _mouse_buttons);
@@ -110,6 +125,35 @@ void cursor_handle_packet(MousePacket packet)
         window_on_focus->handle_mouse_buttons(_mouse_old_buttons, _mouse_buttons, _mouse_position);
 }
 
+void cursor_handle_packet(MousePacket packet)
+{
+    MouseButton buttons = cursor_pack_mouse_buttons(packet);
+
+    // Plain motion is coalesced into one move per frame, anything else
+    // flushes it first so button transitions happen where they should.
+    if (buttons == _mouse_buttons && packet.scroll == 0)
+    {
+        _pending_motion += Vec2i(packet.offx, packet.offy);
+        return;
+    }
+
+    cursor_flush_motion();
+    cursor_apply(Vec2i(packet.offx, packet.offy), buttons);
+}
+
+void cursor_flush_motion()
+{
+    if (_pending_motion == Vec2i::zero())
+    {
+        return;
+    }
+
+    Vec2i offset = _pending_motion;
+    _pending_motion = Vec2i::zero();
+
+    cursor_apply(offset, _mouse_buttons);
+}
+
 CursorState cursor_get_state()
 {
     Window *window = manager_focus_window();
@@ -131,26 +175,69 @@ void cursor_render(Painter &painter)
     painter.blit_bitmap(*cursor_bitmap, cursor_bitmap->bound(), cursor_bound());
 }
 
-Rectangle cursor_bound_from_position(Vec2i position)
+bool cursor_is_hardware()
 {
-    CursorState state = cursor_get_state();
-
-    Rectangle bound(position, Vec2i(28, 28));
+    return _cursor_hardware;
+}
 
+Vec2i cursor_hotspot(CursorState state)
+{
     if (state == CURSOR_MOVE ||
         state == CURSOR_RESIZEH ||
         state == CURSOR_RESIZEV ||
         state == CURSOR_RESIZEHV ||
         state == CURSOR_RESIZEVH)
     {
-        bound = bound.offset({-14, -14});
+        return {14, 14};
     }
     else
     {
-        bound = bound.offset({-2, -2});
+        return {2, 2};
     }
+}
+
+void cursor_update_hardware()
+{
+    CursorState state = cursor_get_state();
+
+    if (state == _cursor_hardware_state)
+    {
+        return;
+    }
+
+    bool was_hardware = _cursor_hardware;
+
+    _cursor_hardware = renderer_set_cursor(*_cursor_bitmaps[state], cursor_hotspot(state));
+    _cursor_hardware_state = _cursor_hardware ? state : __CURSOR_COUNT;
+
+    if (_cursor_hardware)
+    {
+        renderer_move_cursor(_mouse_position);
+    }
+
+    if (_cursor_hardware != was_hardware)
+    {
+        renderer_region_dirty(cursor_dirty_bound());
+    }
+}
+
+void cursor_invalidate()
+{
+    if (_cursor_hardware)
+    {
+        cursor_update_hardware();
+    }
+    else
+    {
+        renderer_region_dirty(cursor_dirty_bound());
+    }
+}
+
+Rectangle cursor_bound_from_position(Vec2i position)
+{
+    Rectangle bound(position, Vec2i(28, 28));
 
-    return bound;
+    return bound.offset(-cursor_hotspot(cursor_get_state()));
 }
 
 Rectangle cursor_bound()
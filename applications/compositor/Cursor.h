@@ -7,8 +7,16 @@ void cursor_initialize();
 
 void cursor_handle_packet(MousePacket packet);
 
+void cursor_flush_motion();
+
 void cursor_render(Painter &painter);
 
+bool cursor_is_hardware();
+
+void cursor_update_hardware();
+
+void cursor_invalidate();
+
 Rectangle cursor_bound_from_position(Vec2i position);
 
 Rectangle cursor_dirty_bound_from_position(Vec2i position);
@@ -1,4 +1,7 @@
 #include <libgraphic/Framebuffer.h>
+#include <libsystem/Logger.h>
+#include <libsystem/thread/ThreadPool.h>
+#include <libsystem/trace/Trace.h>
 #include <libutils/Vector.h>
 
 #include "compositor/Cursor.h"
@@ -9,12 +12,90 @@
 static OwnPtr<Framebuffer> _framebuffer;
 static RefPtr<Bitmap> _wallpaper;
 
+// The wallpaper resampled to the resolution of the screen, so exposing a
+// region is a plain copy. Null if it couldn't be allocated.
+static RefPtr<Bitmap> _wallpaper_scaled;
+static OwnPtr<ThreadPool> _pool;
+
 static Vector<Rectangle> _dirty_regions;
 
-void renderer_initialize()
+// Going down, each pixel is the average of the ones it covers, otherwise
+// the wallpaper is filtered linearly.
+static Color renderer_resample_pixel(Bitmap &source, Rectangle destination, int x, int y)
+{
+    if (source.width() < destination.width() || source.height() < destination.height())
+    {
+        return source.sample(Vec2f(x / (float)destination.width(), y / (float)destination.height()));
+    }
+
+    int x0 = x * source.width() / destination.width();
+    int x1 = MAX((x + 1) * source.width() / destination.width(), x0 + 1);
+    int y0 = y * source.height() / destination.height();
+    int y1 = MAX((y + 1) * source.height() / destination.height(), y0 + 1);
+
+    uint red = 0;
+    uint green = 0;
+    uint blue = 0;
+
+    for (int yy = y0; yy < y1; yy++)
+    {
+        for (int xx = x0; xx < x1; xx++)
+        {
+            Color color = source.get_pixel_no_check(Vec2i(xx, yy));
+
+            red += color.red();
+            green += color.green();
+            blue += color.blue();
+        }
+    }
+
+    uint count = (x1 - x0) * (y1 - y0);
+
+    return Color::from_byte(red / count, green / count, blue / count);
+}
+
+static void renderer_scale_wallpaper()
+{
+    Rectangle resolution = _framebuffer->resolution();
+
+    if (_wallpaper_scaled == nullptr ||
+        _wallpaper_scaled->bound().size() != resolution.size())
+    {
+        auto scaled_or_result = Bitmap::create_shared(resolution.width(), resolution.height());
+
+        if (!scaled_or_result.success())
+        {
+            logger_warn("Failed to allocate the scaled wallpaper: %s", get_result_description(scaled_or_result.result()));
+            _wallpaper_scaled = nullptr;
+            return;
+        }
+
+        _wallpaper_scaled = scaled_or_result.take_value();
+    }
+
+    // The wallpaper is drawn opaque, whatever its alpha is.
+    for (int y = 0; y < resolution.height(); y++)
+    {
+        for (int x = 0; x < resolution.width(); x++)
+        {
+            Color color = renderer_resample_pixel(*_wallpaper, resolution, x, y);
+            _wallpaper_scaled->set_pixel_no_check(Vec2i(x, y), color.with_alpha(1));
+        }
+    }
+}
+
+void renderer_initialize(size_t workers)
 {
     _framebuffer = Framebuffer::open().take_value();
+
+    if (workers > 0)
+    {
+        _pool = own<ThreadPool>(workers);
+        _framebuffer->painter().pool(_pool.naked());
+    }
+
     _wallpaper = Bitmap::load_from_or_placeholder("/System/Wallpapers/mountains.png");
+    renderer_scale_wallpaper();
 
     renderer_region_dirty(_framebuffer->resolution());
 }
@@ -61,6 +142,14 @@ void renderer_region_dirty(Rectangle new_region)
 
 void renderer_composite_wallpaper(Rectangle region)
 {
+    if (_wallpaper_scaled != nullptr)
+    {
+        _framebuffer->painter().blit_bitmap_copy(*_wallpaper_scaled, region, region);
+        _framebuffer->mark_dirty(region);
+
+        return;
+    }
+
     double scale_x = _wallpaper->width() / (double)_framebuffer->resolution().width();
     double scale_y = _wallpaper->height() / (double)_framebuffer->resolution().height();
 
@@ -165,10 +254,14 @@ Rectangle renderer_bound()
 
 void renderer_repaint_dirty()
 {
+    TRACE_SCOPE("compose", _dirty_regions.count());
+
+    cursor_update_hardware();
+
     _dirty_regions.foreach ([](Rectangle region) {
         renderer_region(region);
 
-        if (region.colide_with(cursor_bound()))
+        if (!cursor_is_hardware() && region.colide_with(cursor_bound()))
         {
             renderer_region(cursor_bound());
 
@@ -186,6 +279,11 @@ void renderer_repaint_dirty()
 bool renderer_set_resolution(int width, int height)
 {
     auto result = _framebuffer->set_resolution(Vec2i(width, height));
+
+    // The framebuffer has a new painter.
+    _framebuffer->painter().pool(_pool.naked());
+
+    renderer_scale_wallpaper();
     renderer_region_dirty(renderer_bound());
     return result == SUCCESS;
 }
@@ -195,5 +293,17 @@ void renderer_set_wallaper(RefPtr<Bitmap> wallaper)
     _wallpaper = wallaper;
     _wallpaper->filtering(BITMAP_FILTERING_LINEAR);
 
+    renderer_scale_wallpaper();
+
     renderer_region_dirty(renderer_bound());
 }
+
+bool renderer_set_cursor(Bitmap &bitmap, Vec2i hotspot)
+{
+    return _framebuffer->set_cursor(bitmap, hotspot) == SUCCESS;
+}
+
+void renderer_move_cursor(Vec2i position)
+{
+    _framebuffer->move_cursor(position);
+}
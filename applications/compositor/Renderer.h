@@ -3,7 +3,8 @@
 #include <libgraphic/Bitmap.h>
 #include <libgraphic/Shape.h>
 
-void renderer_initialize();
+// With workers, large regions are composited by a pool of threads.
+void renderer_initialize(size_t workers);
 
 Rectangle renderer_bound();
 
@@ -14,3 +15,7 @@ void renderer_repaint_dirty();
 bool renderer_set_resolution(int width, int height);
 
 void renderer_set_wallaper(RefPtr<Bitmap> wallaper);
+
+bool renderer_set_cursor(Bitmap &bitmap, Vec2i hotspot);
+
+void renderer_move_cursor(Vec2i position);
@@ -77,7 +77,7 @@ void Window::send_event(Event event)
         },
     };
 
-    _client->send_message(message);
+    _client->queue_message(message);
 }
 
 void Window::handle_mouse_move(Vec2i old_position, Vec2i position, MouseButton buttons)
@@ -10,6 +10,8 @@
 #include <libsystem/process/Launchpad.h>
 #include <libsystem/process/Process.h>
 #include <libsystem/unicode/UTF8Decoder.h>
+#include <libsystem/utils/NumberParser.h>
+#include <libutils/ArgParse.h>
 
 #include "compositor/Client.h"
 #include "compositor/Cursor.h"
@@ -37,16 +39,24 @@ static EventType key_motion_to_event_type(KeyMotion motion)
     ASSERT_NOT_REACHED();
 }
 
+#define KEYBOARD_PACKETS_PER_READ 32
+
 void keyboard_callback(void *target, Stream *keyboard_stream, PollEvent events)
 {
     __unused(target);
     __unused(events);
 
-    KeyboardPacket packet;
-    size_t size = stream_read(keyboard_stream, &packet, sizeof(KeyboardPacket));
+    KeyboardPacket packets[KEYBOARD_PACKETS_PER_READ];
+    size_t size = stream_read(keyboard_stream, &packets, sizeof(packets));
 
-    if (size == sizeof(KeyboardPacket))
+    if (size % sizeof(KeyboardPacket) != 0)
     {
+        logger_warn("Invalid keyboard packet with size=%d !", size);
+    }
+
+    for (size_t i = 0; i < size / sizeof(KeyboardPacket); i++)
+    {
+        KeyboardPacket &packet = packets[i];
         Window *window = manager_focus_window();
 
         if (window)
@@ -65,31 +75,34 @@ void keyboard_callback(void *target, Stream *keyboard_stream, PollEvent events)
             window->send_event(event);
         }
     }
-    else
-    {
-        logger_warn("Invalid keyboard packet with size=%d !", size);
-    }
 
+    client_flush_messages();
     client_destroy_disconnected();
 }
 
+#define MOUSE_PACKETS_PER_READ 64
+
 void mouse_callback(void *target, Stream *mouse_stream, PollEvent events)
 {
     __unused(target);
     __unused(events);
 
-    MousePacket packet;
-    size_t size = stream_read(mouse_stream, &packet, sizeof(MousePacket));
+    // Drain everything that is pending, motion is coalesced by the cursor
+    // and applied once per frame.
+    MousePacket packets[MOUSE_PACKETS_PER_READ];
+    size_t size = stream_read(mouse_stream, &packets, sizeof(packets));
 
-    if (size == sizeof(MousePacket))
+    if (size % sizeof(MousePacket) != 0)
     {
-        cursor_handle_packet(packet);
+        logger_warn("Invalid mouse packet with size=%d !", size);
     }
-    else
+
+    for (size_t i = 0; i < size / sizeof(MousePacket); i++)
     {
-        logger_warn("Invalid mouse packet with size=%d !", size);
+        cursor_handle_packet(packets[i]);
     }
 
+    client_flush_messages();
     client_destroy_disconnected();
 }
 
@@ -116,8 +129,14 @@ void render_callback(void *target)
 
 int main(int argc, char const *argv[])
 {
-    __unused(argc);
-    __unused(argv);
+    ArgParse args;
+    args.should_abort_on_failure();
+
+    // Off by default, there is only one processor to run them on for now.
+    String workers = "0";
+    args.option(workers, 'w', "workers", "Composite large regions on this many threads.");
+
+    args.eval(argc, argv);
 
     eventloop_initialize();
 
@@ -139,7 +158,9 @@ int main(int argc, char const *argv[])
     notifier_create(nullptr, HANDLE(socket), POLL_ACCEPT, (NotifierCallback)accept_callback);
 
     auto repaint_timer = own<Timer>(1000 / 60, []() {
+        cursor_flush_motion();
         renderer_repaint_dirty();
+        client_flush_messages();
         client_destroy_disconnected();
     });
 
@@ -147,7 +168,7 @@ int main(int argc, char const *argv[])
 
     manager_initialize();
     cursor_initialize();
-    renderer_initialize();
+    renderer_initialize(parse_uint_inline(PARSER_DECIMAL, workers.cstring(), 0));
 
     process_run("panel", nullptr);
     process_run("terminal", nullptr);
@@ -1,4 +1,14 @@
 UTILS = \
+	__BENCHFILE \
+	__BENCHHASHMAP \
+	__BENCHMARKUP \
+	__BENCHMOUSE \
+	__BENCHPAINT \
+	__BENCHPARSE \
+	__BENCHPATH \
+	__BENCHPNG \
+	__BENCHSTRING \
+	__BENCHTERM \
 	__TESTEXEC \
 	__TESTTERM \
 	BASENAME \
@@ -23,9 +33,11 @@ UTILS = \
 	NOW \
 	OPEN \
 	PANIC \
+	PROFILE \
 	SYSFETCH \
 	TAC \
 	TOUCH \
+	TRACE \
 	UNLINK \
 	UPTIME \
 	LINK  \
@@ -36,6 +48,36 @@ UTILS = \
 	PWD	\
 	PLAY
 
+__BENCHFILE_LIBS =
+__BENCHFILE_NAME = __benchfile
+
+__BENCHHASHMAP_LIBS =
+__BENCHHASHMAP_NAME = __benchhashmap
+
+__BENCHMARKUP_LIBS = widget markup graphic
+__BENCHMARKUP_NAME = __benchmarkup
+
+__BENCHMOUSE_LIBS =
+__BENCHMOUSE_NAME = __benchmouse
+
+__BENCHPAINT_LIBS = graphic
+__BENCHPAINT_NAME = __benchpaint
+
+__BENCHPARSE_LIBS = markup
+__BENCHPARSE_NAME = __benchparse
+
+__BENCHPATH_LIBS =
+__BENCHPATH_NAME = __benchpath
+
+__BENCHPNG_LIBS = graphic
+__BENCHPNG_NAME = __benchpng
+
+__BENCHSTRING_LIBS = widget markup graphic
+__BENCHSTRING_NAME = __benchstring
+
+__BENCHTERM_LIBS = terminal
+__BENCHTERM_NAME = __benchterm
+
 __TESTEXEC_LIBS =
 __TESTEXEC_NAME = __testexec
 
@@ -111,6 +153,9 @@ OPEN_NAME = open
 PANIC_LIBS =
 PANIC_NAME = panic
 
+PROFILE_LIBS =
+PROFILE_NAME = profile
+
 RMDIR_LIBS =
 RMDIR_NAME = rmdir
 
@@ -123,6 +168,9 @@ TAC_NAME = tac
 TOUCH_LIBS =
 TOUCH_NAME = touch
 
+TRACE_LIBS =
+TRACE_NAME = trace
+
 UNLINK_LIBS =
 UNLINK_NAME = unlink
 
@@ -153,7 +201,7 @@ $(1)_OBJECT  = $$(patsubst applications/coreutils/%.cpp, $$(BUILD_DIRECTORY)/app
 TARGETS += $$($(1)_BINARY)
 OBJECTS += $$($(1)_OBJECT)
 
-$$($(1)_BINARY): $$($(1)_OBJECT) $$(patsubst %, $$(BUILD_DIRECTORY_LIBS)/lib%.a, $$($(1)_LIBS) system) $(CRTS)
+$$($(1)_BINARY): $$($(1)_OBJECT) $$(patsubst %, $$(BUILD_DIRECTORY_LIBS)/lib%.a, $$($(1)_LIBS) system) $(CRTS) $(SHARED_LIBRARIES)
 	$$(DIRECTORY_GUARD)
 	@echo [$(1)] [LD] $($(1)_NAME)
 	@$(CXX) $(LDFLAGS) -o $$@ $$($(1)_OBJECT) $$(patsubst %, -l%, $$($(1)_LIBS))
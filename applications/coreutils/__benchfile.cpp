@@ -0,0 +1,98 @@
+#include <libsystem/io/File.h>
+#include <libsystem/io/Filesystem.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+
+#define BENCH_PATH "/User/__benchfile"
+#define BENCH_SIZE (16 * 1024 * 1024)
+#define BENCH_CHUNK 4096
+
+static char chunk[BENCH_CHUNK];
+
+static void report(const char *name, uint elapsed)
+{
+    printf("%-6s %6dms", name, elapsed);
+
+    if (elapsed > 0)
+    {
+        printf(", %dMio/s", (int)((BENCH_SIZE / (1024 * 1024)) * 1000ull / elapsed));
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    __unused(argc);
+    __unused(argv);
+
+    for (size_t i = 0; i < BENCH_CHUNK; i++)
+    {
+        chunk[i] = (char)i;
+    }
+
+    uint start = system_get_ticks();
+
+    Stream *stream = stream_open(BENCH_PATH, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC);
+
+    if (handle_has_error(stream))
+    {
+        handle_printf_error(stream, "__benchfile: Failed to open " BENCH_PATH);
+        stream_close(stream);
+        return PROCESS_FAILURE;
+    }
+
+    for (size_t written = 0; written < BENCH_SIZE; written += BENCH_CHUNK)
+    {
+        stream_write(stream, chunk, BENCH_CHUNK);
+    }
+
+    stream_close(stream);
+
+    report("write", system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    stream = stream_open(BENCH_PATH, OPEN_READ);
+
+    size_t total = 0;
+    size_t read = 0;
+
+    while ((read = stream_read(stream, chunk, BENCH_CHUNK)) > 0)
+    {
+        total += read;
+    }
+
+    stream_close(stream);
+
+    report("read", system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(BENCH_PATH, &buffer, &size) != SUCCESS)
+    {
+        printf("__benchfile: Failed to map " BENCH_PATH "\n");
+        filesystem_unlink(BENCH_PATH);
+        return PROCESS_FAILURE;
+    }
+
+    uint32_t checksum = 0;
+
+    for (size_t i = 0; i < size; i += BENCH_CHUNK)
+    {
+        checksum += ((const uint8_t *)buffer)[i];
+    }
+
+    file_unmap(buffer);
+
+    report("mmap", system_get_ticks() - start);
+
+    printf("read back %d bytes, mapped %d bytes (checksum %d)\n", (int)total, (int)size, checksum);
+
+    filesystem_unlink(BENCH_PATH);
+
+    return PROCESS_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+#include <libutils/HashMap.h>
+#include <libutils/String.h>
+
+static size_t sizes[] = {100, 1000, 10000, 100000, 1000000};
+
+static uint32_t key_for(size_t index)
+{
+    // Spread the keys so consecutive indexes don't land in consecutive slots.
+    return (uint32_t)(index * 2654435761u);
+}
+
+static void report(const char *name, size_t count, uint elapsed)
+{
+    printf("%-8s %8d keys %6dms", name, (int)count, elapsed);
+
+    if (elapsed > 0)
+    {
+        printf(", %d ops/s", (int)((count * 1000ull) / elapsed));
+    }
+
+    printf("\n");
+}
+
+static void bench_integers(size_t count)
+{
+    HashMap<uint32_t, uint32_t> map;
+
+    uint start = system_get_ticks();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        map[key_for(i)] = i;
+    }
+
+    report("insert", count, system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    size_t found = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (map.has_key(key_for(i)))
+        {
+            found++;
+        }
+    }
+
+    report("lookup", count, system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        map.remove_key(key_for(i));
+    }
+
+    report("erase", count, system_get_ticks() - start);
+
+    if (found != count || map.count() != 0)
+    {
+        printf("__benchhashmap: Found %d keys out of %d!\n", (int)found, (int)count);
+    }
+}
+
+static void bench_strings(size_t count)
+{
+    HashMap<String, uint32_t> map;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char buffer[16];
+        snprintf(buffer, 16, "key-%d", (int)i);
+        map[String(buffer)] = i;
+    }
+
+    uint start = system_get_ticks();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char buffer[16];
+        snprintf(buffer, 16, "key-%d", (int)i);
+        map.has_key(buffer);
+    }
+
+    report("cstring", count, system_get_ticks() - start);
+}
+
+int main(int argc, char **argv)
+{
+    __unused(argc);
+    __unused(argv);
+
+    for (size_t i = 0; i < __array_length(sizes); i++)
+    {
+        bench_integers(sizes[i]);
+        bench_strings(sizes[i]);
+    }
+
+    return PROCESS_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+#include <libwidget/Application.h>
+#include <libwidget/Markup.h>
+
+#define BUILD_ROUNDS 16
+
+static const char *markups[] = {
+    "/Applications/about/about.markup",
+    "/Applications/calculator/calculator.markup",
+    "/Applications/media-player/main.markup",
+    "/Applications/settings/settings.markup",
+    nullptr,
+};
+
+static int benchmark(const char *path, Window *(*create)(const char *path))
+{
+    uint start = system_get_ticks();
+
+    for (size_t round = 0; round < BUILD_ROUNDS; round++)
+    {
+        Window *window = create(path);
+
+        if (!window)
+        {
+            return -1;
+        }
+
+        delete window;
+    }
+
+    return (system_get_ticks() - start) * 1000 / BUILD_ROUNDS;
+}
+
+int main(int argc, char **argv)
+{
+    if (application_initialize(argc, argv) != SUCCESS)
+    {
+        return PROCESS_FAILURE;
+    }
+
+    if (argc > 1)
+    {
+        markups[0] = argv[1];
+        markups[1] = nullptr;
+    }
+
+    printf("%-44s %12s %12s\n", "", "markup", "compiled");
+
+    for (size_t i = 0; markups[i]; i++)
+    {
+        // Icons and images are cached by the first build, keep them out of
+        // the measurements so both paths only pay for building the widgets.
+        delete window_create_from_markup_file(markups[i]);
+
+        int markup_time = benchmark(markups[i], window_create_from_markup_file);
+        int compiled_time = benchmark(markups[i], window_create_from_compiled_file);
+
+        if (compiled_time < 0)
+        {
+            printf("%-44s %9dus/w %12s\n", markups[i], markup_time, "none");
+        }
+        else
+        {
+            printf("%-44s %9dus/w %9dus/w\n", markups[i], markup_time, compiled_time);
+        }
+    }
+
+    return PROCESS_SUCCESS;
+}
@@ -0,0 +1,97 @@
+#include <abi/Mouse.h>
+#include <abi/Paths.h>
+
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/process/Statistics.h>
+#include <libsystem/system/System.h>
+
+#define PACKET_COUNT 10000
+#define PACKETS_PER_BURST 10
+
+static TaskStatistics tasks[STATISTICS_TASK_COUNT];
+
+static int compositor_cpu_time(const SystemStatistics *statistics)
+{
+    size_t count = statistics_snapshot(statistics, tasks, STATISTICS_TASK_COUNT);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(tasks[i].name, "compositor") == 0)
+        {
+            return tasks[i].cpu_time;
+        }
+    }
+
+    return -1;
+}
+
+int main(int argc, char **argv)
+{
+    __unused(argc);
+    __unused(argv);
+
+    const SystemStatistics *statistics = nullptr;
+
+    if (statistics_map(&statistics) != SUCCESS)
+    {
+        printf("__benchmouse: Failed to map the system statistics\n");
+        return PROCESS_FAILURE;
+    }
+
+    Stream *mouse_stream = stream_open(MOUSE_DEVICE_PATH, OPEN_WRITE);
+
+    if (handle_has_error(mouse_stream))
+    {
+        handle_printf_error(mouse_stream, "__benchmouse: Failed to open " MOUSE_DEVICE_PATH);
+        stream_close(mouse_stream);
+        statistics_unmap(statistics);
+        return PROCESS_FAILURE;
+    }
+
+    int cpu_before = compositor_cpu_time(statistics);
+
+    if (cpu_before < 0)
+    {
+        printf("__benchmouse: The compositor is not running\n");
+        stream_close(mouse_stream);
+        statistics_unmap(statistics);
+        return PROCESS_FAILURE;
+    }
+
+    uint start = system_get_ticks();
+
+    // Bursts of small motions every tick, zig-zagging so the cursor ends
+    // up where it started.
+    MousePacket packets[PACKETS_PER_BURST] = {};
+
+    for (size_t sent = 0; sent < PACKET_COUNT; sent += PACKETS_PER_BURST)
+    {
+        int direction = (sent / 500) % 2 ? -1 : 1;
+
+        for (size_t i = 0; i < PACKETS_PER_BURST; i++)
+        {
+            packets[i].offx = direction;
+            packets[i].offy = direction;
+        }
+
+        stream_write(mouse_stream, packets, sizeof(packets));
+        process_sleep(1);
+    }
+
+    uint injected = system_get_ticks() - start;
+
+    // Give the compositor a few frames to catch up before sampling it.
+    process_sleep(100);
+
+    int cpu_after = compositor_cpu_time(statistics);
+
+    printf("Injected %d motion packets in %dms, the compositor used %dms of cpu\n",
+           PACKET_COUNT, injected, cpu_after - cpu_before);
+
+    stream_close(mouse_stream);
+    statistics_unmap(statistics);
+
+    return PROCESS_SUCCESS;
+}
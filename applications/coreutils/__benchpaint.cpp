@@ -0,0 +1,79 @@
+#include <libgraphic/Painter.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+#include <libsystem/thread/ThreadPool.h>
+#include <libsystem/utils/NumberParser.h>
+
+#define PAINT_ROUNDS 4
+#define PAINT_WIDTH 1024
+#define PAINT_HEIGHT 768
+
+static const size_t workers[] = {1, 2, 4, 8};
+
+// What the compositor does the most: scale the wallpaper to the screen, then
+// draw and blur something on top of it.
+static void paint(Painter &painter, Bitmap &wallpaper)
+{
+    painter.blit_bitmap_no_alpha(wallpaper, wallpaper.bound(), Rectangle(PAINT_WIDTH, PAINT_HEIGHT));
+    painter.fill_rectangle(Rectangle(64, 64, 640, 480), Color::from_rgba(0.1, 0.2, 0.3, 0.5));
+    painter.blur_rectangle(Rectangle(128, 128, 512, 384), 16);
+}
+
+static uint64_t measure(RefPtr<Bitmap> target, Bitmap &wallpaper, ThreadPool *pool)
+{
+    Painter painter{target};
+    painter.pool(pool);
+
+    uint64_t start = system_get_microseconds();
+
+    for (size_t round = 0; round < PAINT_ROUNDS; round++)
+    {
+        paint(painter, wallpaper);
+    }
+
+    return (system_get_microseconds() - start) / PAINT_ROUNDS;
+}
+
+int main(int argc, char **argv)
+{
+    size_t max_workers = 4;
+
+    if (argc > 1)
+    {
+        max_workers = parse_uint_inline(PARSER_DECIMAL, argv[1], max_workers);
+    }
+
+    auto wallpaper = Bitmap::load_from_or_placeholder("/System/Wallpapers/mountains.png");
+    wallpaper->filtering(BITMAP_FILTERING_LINEAR);
+
+    auto reference = Bitmap::create_shared(PAINT_WIDTH, PAINT_HEIGHT).take_value();
+    auto target = Bitmap::create_shared(PAINT_WIDTH, PAINT_HEIGHT).take_value();
+
+    size_t size = PAINT_WIDTH * PAINT_HEIGHT * sizeof(Color);
+
+    uint64_t serial = measure(reference, *wallpaper, nullptr);
+
+    printf("serial    %8uus/frame\n", (uint)serial);
+
+    for (size_t i = 0; i < __array_length(workers) && workers[i] <= max_workers; i++)
+    {
+        ThreadPool pool{workers[i]};
+
+        uint64_t elapsed = measure(target, *wallpaper, &pool);
+
+        // Bands are drawn in any order, but should always give the same pixels.
+        bool same = memcmp(reference->pixels(), target->pixels(), size) == 0;
+
+        size_t speedup = serial * 100 / MAX(elapsed, 1);
+
+        printf("%d workers %8uus/frame  x%d.%02d%s\n",
+               (int)workers[i],
+               (uint)elapsed,
+               (int)(speedup / 100),
+               (int)(speedup % 100),
+               same ? "" : "  (differs from serial!)");
+    }
+
+    return PROCESS_SUCCESS;
+}
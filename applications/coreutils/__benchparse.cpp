@@ -0,0 +1,133 @@
+#include <libmarkup/Markup.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/json/Json.h>
+#include <libsystem/system/System.h>
+#include <libutils/StringBuilder.h>
+
+#define PARSE_ROUNDS 8
+#define DOCUMENT_ITEMS 4096
+
+static String make_json()
+{
+    StringBuilder builder{};
+
+    builder.append("{\n    \"items\": [\n");
+
+    for (size_t i = 0; i < DOCUMENT_ITEMS; i++)
+    {
+        char buffer[256];
+
+        snprintf(buffer, 256,
+                 "        {\n"
+                 "            \"id\": %d,\n"
+                 "            \"name\": \"item number %d\",\n"
+                 "            \"description\": \"A somewhat longer string, with \\\"escapes\\\" and spaces.\",\n"
+                 "            \"enabled\": %s\n"
+                 "        }%s\n",
+                 (int)i, (int)i, i % 2 ? "true" : "false", i + 1 < DOCUMENT_ITEMS ? "," : "");
+
+        builder.append(buffer);
+    }
+
+    builder.append("    ]\n}\n");
+
+    return builder.finalize();
+}
+
+static String make_markup()
+{
+    StringBuilder builder{};
+
+    builder.append("<Window title=\"Benchmark\" width=\"640\" height=\"480\">\n");
+
+    for (size_t i = 0; i < DOCUMENT_ITEMS; i++)
+    {
+        char buffer[256];
+
+        snprintf(buffer, 256,
+                 "    <Panel layout=\"hflow(4)\" padding=\"insets(4)\">\n"
+                 "        <Button text=\"Button number %d\" icon=\"duck\" filled />\n"
+                 "        <Label text=\"Label number %d\" position=\"center\" />\n"
+                 "    </Panel>\n",
+                 (int)i, (int)i);
+
+        builder.append(buffer);
+    }
+
+    builder.append("</Window>\n");
+
+    return builder.finalize();
+}
+
+static void report(const char *name, size_t size, uint elapsed)
+{
+    printf("%-24s %6dms", name, elapsed);
+
+    if (elapsed > 0)
+    {
+        printf(", %dKio/s", (int)((size * PARSE_ROUNDS / 1024) * 1000ull / elapsed));
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    __unused(argc);
+    __unused(argv);
+
+    String json_document = make_json();
+
+    uint start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        json::parse(json_document.cstring(), json_document.length());
+    }
+
+    report("json (span)", json_document.length(), system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        // The generic path, through the virtual Scanner interface.
+        StringScanner scan{json_document.cstring(), json_document.length()};
+        json::parse(scan);
+    }
+
+    report("json (scanner)", json_document.length(), system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        json::Visitor visitor{};
+        json::visit(json_document.cstring(), json_document.length(), visitor);
+    }
+
+    report("json (visit)", json_document.length(), system_get_ticks() - start);
+
+    start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        json::Document document{};
+        document.parse(json_document.cstring(), json_document.length());
+    }
+
+    report("json (document)", json_document.length(), system_get_ticks() - start);
+
+    String markup_document = make_markup();
+
+    start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        markup_node_destroy(markup_parse(markup_document.cstring(), markup_document.length()));
+    }
+
+    report("markup (span)", markup_document.length(), system_get_ticks() - start);
+
+    return PROCESS_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+
+#define LOOKUP_COUNT 100000
+
+static const char *paths[] = {
+    "/Applications/shell/shell",
+    "/Applications/terminal/terminal",
+    "/Applications/file-manager/file-manager",
+    "/System/Binaries/ls",
+    "/System/Binaries/cat",
+    "/System/Configs/theme/skift-dark.json",
+    "/System/processes",
+    "/Devices/framebuffer",
+    "/User/Documents",
+    "/Applications/does-not-exist/does-not-exist",
+    "/System/Binaries/does-not-exist",
+    nullptr,
+};
+
+int main(int argc, char **argv)
+{
+    __unused(argc);
+    __unused(argv);
+
+    size_t path_count = 0;
+
+    while (paths[path_count])
+    {
+        path_count++;
+    }
+
+    int found = 0;
+
+    uint start = system_get_ticks();
+
+    for (size_t i = 0; i < LOOKUP_COUNT; i++)
+    {
+        __cleanup(stream_cleanup) Stream *stream = stream_open(paths[i % path_count], OPEN_READ);
+
+        if (!handle_has_error(stream))
+        {
+            FileState state = {};
+            stream_stat(stream, &state);
+            found++;
+        }
+    }
+
+    uint elapsed = system_get_ticks() - start;
+
+    printf("Resolved %d paths (%d found) in %dms", LOOKUP_COUNT, found, elapsed);
+
+    if (elapsed > 0)
+    {
+        printf(", %d lookups/s", (int)((LOOKUP_COUNT * 1000ull) / elapsed));
+    }
+
+    printf("\n");
+
+    return PROCESS_SUCCESS;
+}
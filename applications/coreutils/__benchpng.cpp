@@ -0,0 +1,53 @@
+#include <libgraphic/Bitmap.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+
+#define DECODE_ROUNDS 4
+
+static const char *images[] = {
+    "/System/Cursors/default.png",
+    "/System/Cursors/busy.png",
+    "/System/Icons/window-close@18px.png",
+    "/System/Fonts/sans.png",
+    "/System/skift.png",
+    "/System/Wallpapers/mountains.png",
+    nullptr,
+};
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        images[0] = argv[1];
+        images[1] = nullptr;
+    }
+
+    for (size_t i = 0; images[i]; i++)
+    {
+        uint start = system_get_ticks();
+
+        int width = 0;
+        int height = 0;
+
+        for (size_t round = 0; round < DECODE_ROUNDS; round++)
+        {
+            auto bitmap_or_result = Bitmap::load_from(images[i]);
+
+            if (!bitmap_or_result.success())
+            {
+                printf("%s: %s\n", images[i], get_result_description(bitmap_or_result.result()));
+                break;
+            }
+
+            auto bitmap = bitmap_or_result.take_value();
+            width = bitmap->width();
+            height = bitmap->height();
+        }
+
+        uint elapsed = system_get_ticks() - start;
+
+        printf("%-40s %4dx%-4d %5dms/decode\n", images[i], width, height, elapsed / DECODE_ROUNDS);
+    }
+
+    return PROCESS_SUCCESS;
+}
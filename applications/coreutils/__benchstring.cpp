@@ -0,0 +1,131 @@
+#include <libsystem/io/Stream.h>
+#include <libsystem/json/Json.h>
+#include <libsystem/system/System.h>
+#include <libutils/StringBuilder.h>
+#include <libwidget/Application.h>
+#include <libwidget/Markup.h>
+
+#define PARSE_ROUNDS 16
+#define PARSE_OBJECTS 256
+
+static const char *markups[] = {
+    "/Applications/about/about.markup",
+    "/Applications/calculator/calculator.markup",
+    "/Applications/settings/settings.markup",
+    nullptr,
+};
+
+static size_t allocations = 0;
+
+// Everything String, StringStorage and json allocate goes through these.
+void *operator new(size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+void *operator new[](size_t size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+static void report(const char *name, size_t rounds, size_t count, uint elapsed)
+{
+    printf("%-44s %8d allocs %6dms\n", name, (int)(count / rounds), elapsed);
+}
+
+static String make_document()
+{
+    StringBuilder builder{};
+
+    builder.append("[");
+
+    for (size_t i = 0; i < PARSE_OBJECTS; i++)
+    {
+        char buffer[256];
+
+        snprintf(buffer, 256,
+                 "%s{\"id\": %d, \"name\": \"process-%d\", \"state\": \"running\", "
+                 "\"description\": \"a long enough description for the heap\", \"usage_percent_cpu\": %d}",
+                 i > 0 ? "," : "", (int)i, (int)i, (int)(i % 100));
+
+        builder.append(buffer);
+    }
+
+    builder.append("]");
+
+    return builder.finalize();
+}
+
+static void bench_json()
+{
+    String document = make_document();
+
+    size_t before = allocations;
+    uint start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        json::Value value = json::parse(document.cstring(), document.length());
+        __unused(value);
+    }
+
+    report("json::parse", PARSE_ROUNDS, allocations - before, system_get_ticks() - start);
+}
+
+static void bench_strings()
+{
+    const char *words[] = {"id", "name", "Container", "a long enough string for the heap", "text"};
+
+    size_t before = allocations;
+    uint start = system_get_ticks();
+
+    for (size_t round = 0; round < PARSE_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < 1000; i++)
+        {
+            String string = words[i % __array_length(words)];
+            String copy = string;
+            copy += string;
+        }
+    }
+
+    report("String", PARSE_ROUNDS, allocations - before, system_get_ticks() - start);
+}
+
+static void bench_markup()
+{
+    for (size_t i = 0; markups[i]; i++)
+    {
+        // Icons and images are cached by the first build.
+        delete window_create_from_markup_file(markups[i]);
+
+        size_t before = allocations;
+        uint start = system_get_ticks();
+
+        for (size_t round = 0; round < PARSE_ROUNDS; round++)
+        {
+            delete window_create_from_markup_file(markups[i]);
+        }
+
+        report(markups[i], PARSE_ROUNDS, allocations - before, system_get_ticks() - start);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bench_strings();
+    bench_json();
+
+    if (application_initialize(argc, argv) == SUCCESS)
+    {
+        bench_markup();
+    }
+    else
+    {
+        printf("__benchstring: No display, skipping the markup benchmark.\n");
+    }
+
+    return PROCESS_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <libsystem/io/Stream.h>
+#include <libsystem/system/System.h>
+#include <libterminal/Terminal.h>
+#include <libutils/StringBuilder.h>
+
+#define FLOOD_SIZE (4 * 1024 * 1024)
+#define FLOOD_CHUNK 4096
+
+static String make_yes()
+{
+    StringBuilder builder{FLOOD_CHUNK + 1};
+
+    while (builder.length() + 2 <= FLOOD_CHUNK)
+    {
+        builder.append("y\n");
+    }
+
+    return builder.finalize();
+}
+
+static String make_cat()
+{
+    StringBuilder builder{FLOOD_CHUNK + 1};
+
+    const char *lines[] = {
+        "#include <libsystem/io/Stream.h>\n",
+        "    for (size_t i = 0; i < size; i++) { total += buffer[i]; }\n",
+        "\e[1;34mdirectory\e[m  \e[32mexecutable\e[m  file.txt  notes.md\n",
+        "Unicode: \xc3\x87\xc3\xbc\xc3\xa9\xc3\xa2 \xe2\x94\x82\xe2\x94\xa4\xe2\x95\xa1 \xce\xb1\xc3\x9f\xce\x93\xcf\x80\n",
+    };
+
+    for (size_t i = 0; builder.length() + 80 <= FLOOD_CHUNK; i++)
+    {
+        builder.append(lines[i % __array_length(lines)]);
+    }
+
+    return builder.finalize();
+}
+
+static void report(const char *name, uint elapsed)
+{
+    printf("%-16s %6dms", name, elapsed);
+
+    if (elapsed > 0)
+    {
+        printf(", %dKio/s", (int)((FLOOD_SIZE / 1024) * 1000ull / elapsed));
+    }
+
+    printf("\n");
+}
+
+static void flood(const char *name, const String &chunk, bool bytewise)
+{
+    terminal::Terminal terminal{80, 24};
+
+    uint start = system_get_ticks();
+
+    for (size_t written = 0; written < FLOOD_SIZE; written += chunk.length())
+    {
+        if (bytewise)
+        {
+            // What every write went through before the printable run path.
+            for (size_t i = 0; i < chunk.length(); i++)
+            {
+                terminal.write(chunk.cstring()[i]);
+            }
+        }
+        else
+        {
+            terminal.write(chunk.cstring(), chunk.length());
+        }
+    }
+
+    report(name, system_get_ticks() - start);
+}
+
+int main(int argc, char **argv)
+{
+    __unused(argc);
+    __unused(argv);
+
+    String yes = make_yes();
+    String cat = make_cat();
+
+    flood("yes (bytewise)", yes, true);
+    flood("yes", yes, false);
+    flood("cat (bytewise)", cat, true);
+    flood("cat", cat, false);
+
+    return PROCESS_SUCCESS;
+}
@@ -0,0 +1,474 @@
+#include <abi/IOCall.h>
+
+#include <libfile/ELF32.h>
+#include <libfile/ELF64.h>
+#include <libsystem/Result.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/process/Launchpad.h>
+#include <libsystem/process/Process.h>
+#include <libutils/String.h>
+#include <libutils/Vector.h>
+
+#ifdef __x86_64__
+using ELF = ELF64;
+#else
+using ELF = ELF32;
+#endif
+
+#define PROFILE_DRAIN_INTERVAL 100
+#define PROFILE_READ_COUNT 256
+#define PROFILE_REPORT_COUNT 30
+
+struct Edge
+{
+    size_t symbol;
+    size_t count;
+};
+
+struct Symbol
+{
+    uintptr_t start;
+    uintptr_t size;
+    String name;
+
+    size_t self;
+    size_t total;
+
+    // Tells whether the symbol was already counted in the current sample,
+    // so recursion doesn't count it twice.
+    size_t last_sample;
+
+    Vector<Edge> callers;
+    Vector<Edge> callees;
+};
+
+struct Module
+{
+    uintptr_t base;
+    String path;
+
+    // Where its symbols are in the table, sorted by address.
+    size_t first;
+    size_t count;
+};
+
+static Vector<Symbol> _symbols;
+static Vector<Module> _modules;
+
+static size_t _kernel_symbol = 0;
+static size_t _unknown_symbol = 0;
+
+static size_t _samples = 0;
+
+static size_t symbol_create(uintptr_t start, uintptr_t size, String name)
+{
+    _symbols.push_back({start, size, name, 0, 0, (size_t)-1, {}, {}});
+    return _symbols.count() - 1;
+}
+
+static void module_load_symbols(Module &module, const uint8_t *elf, size_t size)
+{
+    auto header = (ELF::Header *)elf;
+
+    if (size < sizeof(ELF::Header) || !header->valid() ||
+        header->shoff + header->shnum * sizeof(ELF::Section) > size)
+    {
+        return;
+    }
+
+    auto sections = (ELF::Section *)(elf + header->shoff);
+
+    // Stripped binaries still have their dynamic symbols.
+    ELF::Section *symbols = nullptr;
+
+    for (size_t i = 0; i < header->shnum; i++)
+    {
+        if (sections[i].type == ELF_SECTION_TYPE_SYMTAB ||
+            (sections[i].type == ELF_SECTION_TYPE_DYNSYM && symbols == nullptr))
+        {
+            symbols = &sections[i];
+        }
+    }
+
+    if (symbols == nullptr ||
+        symbols->link >= header->shnum ||
+        symbols->offset + symbols->size > size)
+    {
+        return;
+    }
+
+    ELF::Section &strings = sections[symbols->link];
+
+    if (strings.offset + strings.size > size)
+    {
+        return;
+    }
+
+    auto entries = (ELF::Symbole *)(elf + symbols->offset);
+    auto names = (const char *)(elf + strings.offset);
+
+    for (size_t i = 0; i < symbols->size / sizeof(ELF::Symbole); i++)
+    {
+        auto &entry = entries[i];
+
+        if (entry.type() == ELF_SYMBOLE_TYPE_FUNCTION &&
+            entry.value != 0 &&
+            entry.name < strings.size)
+        {
+            symbol_create(module.base + entry.value, entry.size, String{names + entry.name, strnlen(names + entry.name, strings.size - entry.name)});
+        }
+    }
+}
+
+static void module_load(const ProfileModule &profile_module)
+{
+    Module module = {profile_module.base, profile_module.path, _symbols.count(), 0};
+
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(profile_module.path, &buffer, &size) == SUCCESS)
+    {
+        module_load_symbols(module, (const uint8_t *)buffer, size);
+        file_unmap(buffer);
+    }
+    else if (file_read_all(profile_module.path, (void **)&buffer, &size) == SUCCESS)
+    {
+        module_load_symbols(module, (const uint8_t *)buffer, size);
+        free((void *)buffer);
+    }
+
+    module.count = _symbols.count() - module.first;
+
+    // Sort the module's part of the table, it is appended to the end.
+    Vector<Symbol> symbols{module.count};
+
+    while (_symbols.count() > module.first)
+    {
+        symbols.push_back(_symbols.pop_back());
+    }
+
+    symbols.sort([](const Symbol &left, const Symbol &right) {
+        return left.start < right.start ? -1 : (left.start > right.start ? 1 : 0);
+    });
+
+    for (size_t i = 0; i < symbols.count(); i++)
+    {
+        // Symbols without a size, from assembly, go up to the next one.
+        if (symbols[i].size == 0 && i + 1 < symbols.count())
+        {
+            symbols[i].size = symbols[i + 1].start - symbols[i].start;
+        }
+
+        _symbols.push_back(symbols[i]);
+    }
+
+    _modules.push_back(module);
+}
+
+static size_t symbolize(uintptr_t address)
+{
+    for (size_t m = 0; m < _modules.count(); m++)
+    {
+        const Module &module = _modules[m];
+
+        size_t low = module.first;
+        size_t high = module.first + module.count;
+
+        // Last symbol starting at or before the address.
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+
+            if (_symbols[middle].start <= address)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if (low > module.first)
+        {
+            const Symbol &symbol = _symbols[low - 1];
+
+            if (address < symbol.start + symbol.size)
+            {
+                return low - 1;
+            }
+        }
+    }
+
+    return _unknown_symbol;
+}
+
+static void edge_count(Vector<Edge> &edges, size_t symbol)
+{
+    for (size_t i = 0; i < edges.count(); i++)
+    {
+        if (edges[i].symbol == symbol)
+        {
+            edges[i].count++;
+            return;
+        }
+    }
+
+    edges.push_back({symbol, 1});
+}
+
+static void sample_account(const ProfileSample &sample)
+{
+    size_t stack[PROFILE_DEPTH];
+    size_t depth = 0;
+
+    // Time in the kernel is charged to the kernel as a whole, there are no
+    // symbols for it here.
+    if (sample.kernel > 0)
+    {
+        stack[depth++] = _kernel_symbol;
+    }
+
+    for (size_t i = sample.kernel; i < sample.depth && i < PROFILE_DEPTH; i++)
+    {
+        // Return addresses are past the call, which may be the last
+        // instruction of the function.
+        stack[depth++] = symbolize(i == 0 ? sample.frames[i] : sample.frames[i] - 1);
+    }
+
+    if (depth == 0)
+    {
+        return;
+    }
+
+    _symbols[stack[0]].self++;
+
+    for (size_t i = 0; i < depth; i++)
+    {
+        Symbol &symbol = _symbols[stack[i]];
+
+        if (symbol.last_sample != _samples)
+        {
+            symbol.last_sample = _samples;
+            symbol.total++;
+        }
+
+        if (i + 1 < depth)
+        {
+            edge_count(symbol.callers, stack[i + 1]);
+            edge_count(_symbols[stack[i + 1]].callees, stack[i]);
+        }
+    }
+
+    _samples++;
+}
+
+static void print_percent(size_t count)
+{
+    size_t permille = count * 1000 / MAX(_samples, 1);
+    printf("%3d.%d%%", permille / 10, permille % 10);
+}
+
+static Vector<size_t> symbols_sorted_by(size_t Symbol::*field)
+{
+    Vector<size_t> sorted{};
+
+    for (size_t i = 0; i < _symbols.count(); i++)
+    {
+        if (_symbols[i].total > 0)
+        {
+            sorted.push_back(i);
+        }
+    }
+
+    sorted.sort([&](size_t left, size_t right) {
+        size_t left_count = _symbols[left].*field;
+        size_t right_count = _symbols[right].*field;
+
+        return left_count > right_count ? -1 : (left_count < right_count ? 1 : 0);
+    });
+
+    return sorted;
+}
+
+static void print_edges(Vector<Edge> &edges, const char *arrow)
+{
+    edges.sort([](const Edge &left, const Edge &right) {
+        return left.count > right.count ? -1 : (left.count < right.count ? 1 : 0);
+    });
+
+    for (size_t i = 0; i < edges.count(); i++)
+    {
+        printf("        %s %6d  %s\n", arrow, edges[i].count, _symbols[edges[i].symbol].name.cstring());
+    }
+}
+
+static void report()
+{
+    printf("\n%d samples, flat profile:\n\n", _samples);
+    printf("   self   total  self#  symbol\n");
+
+    auto by_self = symbols_sorted_by(&Symbol::self);
+
+    for (size_t i = 0; i < by_self.count() && i < PROFILE_REPORT_COUNT; i++)
+    {
+        Symbol &symbol = _symbols[by_self[i]];
+
+        if (symbol.self == 0)
+        {
+            break;
+        }
+
+        print_percent(symbol.self);
+        printf(" ");
+        print_percent(symbol.total);
+        printf(" %6d  %s\n", symbol.self, symbol.name.cstring());
+    }
+
+    printf("\nCall graph, by total time:\n\n");
+
+    auto by_total = symbols_sorted_by(&Symbol::total);
+
+    for (size_t i = 0; i < by_total.count() && i < PROFILE_REPORT_COUNT; i++)
+    {
+        Symbol &symbol = _symbols[by_total[i]];
+
+        print_percent(symbol.total);
+        printf(" %s\n", symbol.name.cstring());
+
+        print_edges(symbol.callers, "<-");
+        print_edges(symbol.callees, "->");
+
+        printf("\n");
+    }
+}
+
+static void modules_update(Stream *profile)
+{
+    static ProfileModule modules[PROFILE_MODULE_COUNT];
+
+    IOCallProfileModulesArgs args = {};
+    args.modules = modules;
+    args.count = PROFILE_MODULE_COUNT;
+
+    if (stream_call(profile, IOCALL_PROFILE_MODULES, &args) != SUCCESS)
+    {
+        return;
+    }
+
+    // Libraries are only ever added.
+    for (size_t i = _modules.count(); i < args.read; i++)
+    {
+        module_load(modules[i]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        stream_format(err_stream, "Usage: %s <command> [arguments...]\n", argv[0]);
+        return PROCESS_FAILURE;
+    }
+
+    char executable[PATH_LENGTH];
+
+    if (strchr(argv[1], '/'))
+    {
+        strlcpy(executable, argv[1], PATH_LENGTH);
+    }
+    else
+    {
+        snprintf(executable, PATH_LENGTH, "/System/Binaries/%s", argv[1]);
+    }
+
+    __cleanup(stream_cleanup) Stream *profile = stream_open(PROFILE_PATH, OPEN_READ);
+
+    if (handle_has_error(profile))
+    {
+        stream_format(err_stream, "%s: " PROFILE_PATH ": %s\n", argv[0], handle_error_string(profile));
+        return PROCESS_FAILURE;
+    }
+
+    _kernel_symbol = symbol_create(0, 0, "[kernel]");
+    _unknown_symbol = symbol_create(0, 0, "[unknown]");
+
+    Launchpad *launchpad = launchpad_create(argv[1], executable);
+
+    for (int i = 2; i < argc; i++)
+    {
+        launchpad_argument(launchpad, argv[i]);
+    }
+
+    int pid = -1;
+    Result result = launchpad_launch(launchpad, &pid);
+
+    if (result != SUCCESS)
+    {
+        stream_format(err_stream, "%s: Failed to start %s: %s\n", argv[0], executable, get_result_description(result));
+        return PROCESS_FAILURE;
+    }
+
+    IOCallProfileStartArgs start = {pid};
+    result = stream_call(profile, IOCALL_PROFILE_START, &start);
+
+    if (result != SUCCESS)
+    {
+        stream_format(err_stream, "%s: Failed to profile %s: %s\n", argv[0], executable, get_result_description(result));
+        process_wait(pid, nullptr);
+        return PROCESS_FAILURE;
+    }
+
+    static ProfileSample samples[PROFILE_READ_COUNT];
+    size_t lost = 0;
+
+    while (true)
+    {
+        IOCallProfileReadArgs args = {};
+        args.samples = samples;
+        args.count = PROFILE_READ_COUNT;
+
+        if (stream_call(profile, IOCALL_PROFILE_READ, &args) != SUCCESS)
+        {
+            break;
+        }
+
+        // Before going through the samples, they may come from a library
+        // that was just loaded.
+        modules_update(profile);
+
+        for (size_t i = 0; i < args.read; i++)
+        {
+            sample_account(samples[i]);
+        }
+
+        lost += args.lost;
+
+        if (args.read == PROFILE_READ_COUNT)
+        {
+            continue;
+        }
+
+        if (!args.running)
+        {
+            break;
+        }
+
+        process_sleep(PROFILE_DRAIN_INTERVAL);
+    }
+
+    int exit_value = PROCESS_SUCCESS;
+    process_wait(pid, &exit_value);
+
+    report();
+
+    if (lost > 0)
+    {
+        printf("%d samples were lost.\n", lost);
+    }
+
+    return exit_value;
+}
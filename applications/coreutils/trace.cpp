@@ -0,0 +1,217 @@
+#include <abi/IOCall.h>
+
+#include <libsystem/Result.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/json/Json.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/process/Statistics.h>
+#include <libsystem/system/System.h>
+#include <libsystem/utils/NumberParser.h>
+
+#define TRACE_DRAIN_INTERVAL 10
+#define TRACE_READ_COUNT 256
+
+// The kernel formats its trace ring when the node is read, so this is a
+// snapshot of the last few thousand lines.
+int dump(const char *name)
+{
+    __cleanup(stream_cleanup) Stream *stream = stream_open(TRACE_PATH, OPEN_READ);
+
+    if (handle_has_error(stream))
+    {
+        stream_format(err_stream, "%s: " TRACE_PATH ": %s\n", name, handle_error_string(stream));
+        return PROCESS_FAILURE;
+    }
+
+    size_t read;
+    char buffer[1024];
+
+    while ((read = stream_read(stream, &buffer, 1024)) != 0)
+    {
+        stream_write(out_stream, buffer, read);
+    }
+
+    stream_flush(out_stream);
+
+    return PROCESS_SUCCESS;
+}
+
+static const char *trace_phases[] = {"", "B", "E", "i"};
+
+static void capture_event(Stream *output, const TraceEvent &event, uint64_t start, bool first)
+{
+    String name = json::stringify(event.name);
+
+    // Chrome wants microseconds, relative to the start of the capture so they
+    // fit in a word.
+    stream_format(output,
+                  "%s\n{\"name\":%s,\"ph\":\"%s\",\"ts\":%u,\"pid\":%d,\"tid\":%d,\"args\":{\"argument\":%d}",
+                  first ? "" : ",",
+                  name.cstring(),
+                  trace_phases[event.kind % __array_length(trace_phases)],
+                  (unsigned long)(event.timestamp - start),
+                  event.task,
+                  event.task,
+                  event.argument);
+
+    if (event.kind == TRACE_INSTANT)
+    {
+        stream_format(output, ",\"s\":\"t\"");
+    }
+
+    stream_format(output, "}");
+}
+
+// Names the tracks after the processes that are still around.
+static void capture_metadata(Stream *output, bool first)
+{
+    const SystemStatistics *statistics = nullptr;
+
+    if (statistics_map(&statistics) != SUCCESS)
+    {
+        return;
+    }
+
+    static TaskStatistics tasks[STATISTICS_TASK_COUNT];
+    size_t count = statistics_snapshot(statistics, tasks, STATISTICS_TASK_COUNT);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        String name = json::stringify(tasks[i].name);
+
+        stream_format(output,
+                      "%s\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":%s}}",
+                      first ? "" : ",",
+                      tasks[i].id,
+                      name.cstring());
+
+        first = false;
+    }
+
+    statistics_unmap(statistics);
+}
+
+int capture(const char *name, uint duration, const char *path)
+{
+    __cleanup(stream_cleanup) Stream *trace = stream_open(TRACE_PATH, OPEN_READ);
+
+    if (handle_has_error(trace))
+    {
+        stream_format(err_stream, "%s: " TRACE_PATH ": %s\n", name, handle_error_string(trace));
+        return PROCESS_FAILURE;
+    }
+
+    __cleanup(stream_cleanup) Stream *output = stream_open(path, OPEN_WRITE | OPEN_CREATE | OPEN_BUFFERED);
+
+    if (handle_has_error(output))
+    {
+        stream_format(err_stream, "%s: %s: %s\n", name, path, handle_error_string(output));
+        return PROCESS_FAILURE;
+    }
+
+    Result result = stream_call(trace, IOCALL_TRACE_START, nullptr);
+
+    if (result != SUCCESS)
+    {
+        stream_format(err_stream, "%s: Failed to start the capture: %s\n", name, result_to_string(result));
+        return PROCESS_FAILURE;
+    }
+
+    stream_format(output, "{\"traceEvents\":[");
+
+    static TraceEvent events[TRACE_READ_COUNT];
+
+    uint64_t start = system_get_microseconds();
+    uint64_t end = start + (uint64_t)duration * 1000;
+
+    bool first = true;
+    size_t written = 0;
+    size_t lost = 0;
+
+    // The ring is drained as the capture goes, so it only has to hold what
+    // happens in between two reads.
+    bool capturing = true;
+
+    while (true)
+    {
+        if (capturing && system_get_microseconds() >= end)
+        {
+            stream_call(trace, IOCALL_TRACE_STOP, nullptr);
+            capturing = false;
+        }
+
+        IOCallTraceReadArgs args = {};
+        args.events = events;
+        args.count = TRACE_READ_COUNT;
+
+        if (stream_call(trace, IOCALL_TRACE_READ, &args) != SUCCESS)
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < args.read; i++)
+        {
+            capture_event(output, events[i], start, first);
+            first = false;
+        }
+
+        written += args.read;
+        lost += args.lost;
+
+        if (args.read == TRACE_READ_COUNT)
+        {
+            continue;
+        }
+
+        if (!capturing)
+        {
+            break;
+        }
+
+        process_sleep(TRACE_DRAIN_INTERVAL);
+    }
+
+    stream_call(trace, IOCALL_TRACE_STOP, nullptr);
+
+    capture_metadata(output, first);
+
+    stream_format(output, "\n]}\n");
+    stream_flush(output);
+
+    printf("%d events written to %s", written, path);
+
+    if (lost > 0)
+    {
+        printf(", %d lost", lost);
+    }
+
+    printf("\n");
+
+    return PROCESS_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 1)
+    {
+        return dump(argv[0]);
+    }
+
+    if (argc == 4 && strcmp(argv[1], "capture") == 0)
+    {
+        uint duration = parse_uint_inline(PARSER_DECIMAL, argv[2], 0);
+
+        if (duration == 0)
+        {
+            stream_format(err_stream, "%s: Invalid duration: %s\n", argv[0], argv[2]);
+            return PROCESS_FAILURE;
+        }
+
+        return capture(argv[0], duration, argv[3]);
+    }
+
+    stream_format(err_stream, "Usage: %s [capture <milliseconds> <file>]\n", argv[0]);
+
+    return PROCESS_FAILURE;
+}
@@ -29,7 +29,7 @@ $(1)_OBJECT  = $$(patsubst applications/ctlutils/%.cpp, $$(BUILD_DIRECTORY)/appl
 TARGETS += $$($(1)_BINARY)
 OBJECTS += $$($(1)_OBJECT)
 
-$$($(1)_BINARY): $$($(1)_OBJECT) $$(patsubst %, $$(BUILD_DIRECTORY_LIBS)/lib%.a, $$($(1)_LIBS) system) $(CRTS)
+$$($(1)_BINARY): $$($(1)_OBJECT) $$(patsubst %, $$(BUILD_DIRECTORY_LIBS)/lib%.a, $$($(1)_LIBS) system) $(CRTS) $(SHARED_LIBRARIES)
 	$$(DIRECTORY_GUARD)
 	@echo [$(1)] [LD] $($(1)_NAME)
 	@$(CXX) $(LDFLAGS) -o $$@ $$($(1)_OBJECT) $$(patsubst %, -l%, $$($(1)_LIBS))
@@ -7,35 +7,33 @@
 
 #include "file-manager/FileSystemModel.h"
 
-static auto get_icon_for_node(const char *current_directory, DirectoryEntry *entry)
+static auto get_icon_for_node(const char *current_directory, const char *name, FileType type)
 {
-    if (entry->stat.type == FILE_TYPE_DIRECTORY)
+    if (type == FILE_TYPE_DIRECTORY)
     {
         char manifest_path[PATH_LENGTH];
 
-        snprintf(manifest_path, PATH_LENGTH, "%s/%s/manifest.json", current_directory, entry->name);
+        snprintf(manifest_path, PATH_LENGTH, "%s/%s/manifest.json", current_directory, name);
 
-        auto root = json::parse_file(manifest_path);
+        json::Document manifest;
+        manifest.parse_file(manifest_path);
 
-        if (root.is(json::OBJECT))
-        {
-            auto icon_name = root.get("icon");
+        auto &icon_name = manifest.root().get("icon");
 
-            if (icon_name.is(json::STRING))
-            {
-                return Icon::get(icon_name.as_string());
-            }
+        if (icon_name.is(json::STRING))
+        {
+            return Icon::get(icon_name.as_string());
         }
 
         return Icon::get("folder");
     }
-    else if (entry->stat.type == FILE_TYPE_PIPE ||
-             entry->stat.type == FILE_TYPE_DEVICE ||
-             entry->stat.type == FILE_TYPE_SOCKET)
+    else if (type == FILE_TYPE_PIPE ||
+             type == FILE_TYPE_DEVICE ||
+             type == FILE_TYPE_SOCKET)
     {
         return Icon::get("pipe");
     }
-    else if (entry->stat.type == FILE_TYPE_TERMINAL)
+    else if (type == FILE_TYPE_TERMINAL)
     {
         return Icon::get("console-network");
     }
@@ -122,38 +120,88 @@ Variant FileSystemModel::data(int row, int column)
 
 void FileSystemModel::update()
 {
-    _files.clear();
-
     auto directory = directory_open(_current_path.cstring(), OPEN_READ);
 
+    // The directory is gone or can't be read, don't keep showing it.
     if (handle_has_error(directory))
     {
         directory_close(directory);
+        _files.clear();
+        did_update();
         return;
     }
 
+    Vector<FileSystemNode> files{};
+
     DirectoryEntry entry;
     while (directory_read(directory, &entry) > 0)
     {
         FileSystemNode node{
             .name = {entry.name, FILE_NAME_LENGTH},
             .type = entry.stat.type,
-            .icon = get_icon_for_node(_current_path.cstring(), &entry),
+            .icon = nullptr,
             .size = entry.stat.size,
         };
 
-        _files.push_back(node);
+        files.push_back(node);
     }
 
     directory_close(directory);
 
-    did_update();
+    // Keep the entries sorted by name so refreshes can be diffed against
+    // the previous content.
+    files.sort([](auto &left, auto &right) {
+        return strcmp(left.name.cstring(), right.name.cstring());
+    });
+
+    Vector<FileSystemNode> previous = move(_files);
+    _files = move(files);
+
+    // Looking up icons reads the manifest of every directory, reuse the
+    // ones of the entries that were already there.
+    size_t previous_index = 0;
+
+    for (size_t i = 0; i < _files.count(); i++)
+    {
+        auto &file = _files[i];
+
+        while (previous_index < previous.count() &&
+               strcmp(previous[previous_index].name.cstring(), file.name.cstring()) < 0)
+        {
+            previous_index++;
+        }
+
+        if (previous_index < previous.count() &&
+            previous[previous_index].name == file.name &&
+            previous[previous_index].type == file.type)
+        {
+            file.icon = previous[previous_index].icon;
+        }
+        else
+        {
+            file.icon = get_icon_for_node(_current_path.cstring(), file.name.cstring(), file.type);
+        }
+    }
+
+    did_update_sorted(
+        previous.count(), _files.count(),
+        [&](int old_row, int new_row) {
+            return strcmp(previous[old_row].name.cstring(), _files[new_row].name.cstring());
+        },
+        [&](int old_row, int new_row) {
+            return previous[old_row].type == _files[new_row].type &&
+                   previous[old_row].size == _files[new_row].size &&
+                   previous[old_row].icon == _files[new_row].icon;
+        });
 }
 
 void FileSystemModel::navigate(Path path)
 {
     _current_path = path.string();
     process_set_directory(_current_path.cstring());
+
+    // Another directory has nothing in common with the previous one.
+    _files.clear();
     update();
 }
 
@@ -1,6 +1,9 @@
-#include "task-manager/TaskModel.h"
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
 #include <libsystem/process/Process.h>
 
+#include "task-manager/TaskModel.h"
+
 enum Column
 {
     COLUMN_ID,
@@ -12,9 +15,22 @@ enum Column
     __COLUMN_COUNT,
 };
 
+TaskModel::TaskModel()
+{
+    if (statistics_map(&_statistics) != SUCCESS)
+    {
+        logger_error("Failed to map the system statistics!");
+    }
+}
+
+TaskModel::~TaskModel()
+{
+    statistics_unmap(_statistics);
+}
+
 int TaskModel::rows()
 {
-    return _data.length();
+    return _count;
 }
 
 int TaskModel::columns()
@@ -48,15 +64,15 @@ String TaskModel::header(int column)
 
 Variant TaskModel::data(int row, int column)
 {
-    auto &task = _data.get((size_t)row);
+    auto &task = _tasks[row];
 
     switch (column)
     {
     case COLUMN_ID:
     {
-        Variant value = task.get("id").as_integer();
+        Variant value = task.id;
 
-        if (task.get("user").is(json::TRUE))
+        if (task.user)
         {
             return value.with_icon(Icon::get("account"));
         }
@@ -67,38 +83,96 @@ Variant TaskModel::data(int row, int column)
     }
 
     case COLUMN_NAME:
-        return task.get("name").as_string();
+        return task.name;
 
     case COLUMN_STATE:
-        return task.get("state").as_string();
+        return task_state_string(task.state);
 
     case COLUMN_CPU:
-        return Variant("%2d%%", task.get("cpu").as_integer());
+        return Variant("%2d%%", task.cpu_usage);
 
     case COLUMN_RAM:
-        return Variant("%5d Kio", task.get("ram").as_integer() / 1024);
+        return Variant("%5d Kio", task.resident_memory / 1024);
 
     default:
         ASSERT_NOT_REACHED();
     }
 }
 
+// Only compare what is displayed, the raw counters change all the time.
+static bool displayed_equal(const TaskStatistics &left, const TaskStatistics &right)
+{
+    return left.id == right.id &&
+           left.state == right.state &&
+           left.cpu_usage == right.cpu_usage &&
+           left.resident_memory / 1024 == right.resident_memory / 1024 &&
+           strncmp(left.name, right.name, PROCESS_NAME_SIZE) == 0;
+}
+
 void TaskModel::update()
 {
-    _data = json::parse_file("/System/processes");
-    did_update();
+    if (!_statistics)
+    {
+        return;
+    }
+
+    size_t previous_count = _count;
+    memcpy(_previous, _tasks, sizeof(TaskStatistics) * _count);
+
+    _count = statistics_snapshot(_statistics, _tasks, STATISTICS_TASK_COUNT);
+
+    // Slots get reused, keep the rows ordered by id and hide the idle task.
+    size_t visible = 0;
+
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (_tasks[i].id == 0)
+        {
+            continue;
+        }
+
+        TaskStatistics task = _tasks[i];
+
+        size_t j = visible;
+
+        while (j > 0 && _tasks[j - 1].id > task.id)
+        {
+            _tasks[j] = _tasks[j - 1];
+            j--;
+        }
+
+        _tasks[j] = task;
+        visible++;
+    }
+
+    _count = visible;
+
+    // Tasks come and go and most refreshes only change the usage of a few
+    // of them, let the table repaint just those rows.
+    did_update_sorted(
+        previous_count, _count,
+        [&](int old_row, int new_row) {
+            return _previous[old_row].id - _tasks[new_row].id;
+        },
+        [&](int old_row, int new_row) {
+            return displayed_equal(_previous[old_row], _tasks[new_row]);
+        });
 }
 
-static String greedy(json::Value &data, const char *field)
+template <typename TField>
+static String greedy(TaskStatistics *tasks, size_t count, TField field)
 {
     size_t most_greedy_index = 0;
-    int most_greedy_value = 0;
+    size_t most_greedy_value = 0;
 
-    for (size_t i = 0; i < data.length(); i++)
+    if (count == 0)
     {
-        auto &task = data.get(i);
+        return "nil";
+    }
 
-        auto value = task.get(field).as_integer();
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t value = field(tasks[i]);
 
         if (value > most_greedy_value)
         {
@@ -107,20 +181,17 @@ static String greedy(json::Value &data, const char *field)
         }
     }
 
-    return data
-        .get(most_greedy_index)
-        .get("name")
-        .as_string();
+    return tasks[most_greedy_index].name;
 }
 
 String TaskModel::ram_greedy()
 {
-    return greedy(_data, "ram");
+    return greedy(_tasks, _count, [](auto &task) { return task.resident_memory; });
 }
 
 String TaskModel::cpu_greedy()
 {
-    return greedy(_data, "cpu");
+    return greedy(_tasks, _count, [](auto &task) { return task.cpu_usage; });
 }
 
 void TaskModel::kill_task(int row)
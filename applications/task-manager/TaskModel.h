@@ -1,14 +1,22 @@
 #pragma once
 
-#include <libsystem/json/Json.h>
+#include <libsystem/process/Statistics.h>
 #include <libwidget/model/TableModel.h>
 
 class TaskModel : public TableModel
 {
 private:
-    json::Value _data;
+    const SystemStatistics *_statistics = nullptr;
+
+    TaskStatistics _tasks[STATISTICS_TASK_COUNT];
+    TaskStatistics _previous[STATISTICS_TASK_COUNT];
+    size_t _count = 0;
 
 public:
+    TaskModel();
+
+    ~TaskModel();
+
     int rows() override;
 
     int columns() override;
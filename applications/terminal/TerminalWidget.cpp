@@ -1,6 +1,7 @@
 #include <libgraphic/Painter.h>
 #include <libsystem/Logger.h>
 #include <libsystem/process/Launchpad.h>
+#include <libutils/Vector.h>
 #include <libwidget/Event.h>
 #include <libwidget/Window.h>
 
@@ -23,7 +24,7 @@ void terminal_widget_server_callback(TerminalWidget *widget, Stream *server, Pol
     }
 
     widget->terminal()->write(buffer, size);
-    widget->should_repaint();
+    widget->repaint_dirty_rows();
 }
 
 TerminalWidget::TerminalWidget(Widget *parent) : Widget(parent)
@@ -44,7 +45,7 @@ TerminalWidget::TerminalWidget(Widget *parent) : Widget(parent)
         blink();
 
         int cx = terminal()->cursor().x;
-        int cy = terminal()->cursor().y;
+        int cy = terminal()->cursor().y + _scroll_offset;
 
         should_repaint(cell_bound(cx, cy).offset(bound().position()));
     });
@@ -78,23 +79,41 @@ void TerminalWidget::paint(Painter &painter, Rectangle rectangle)
     rectangle = rectangle.offset(-bound().position());
 
     terminal::Terminal *terminal = _terminal;
+    const terminal::Scrollback &scrollback = terminal->scrollback();
 
-    for (int y = 0; y < terminal->height(); y++)
+    Vector<terminal::Cell> history{(size_t)terminal->width()};
+
+    int first_row = MAX(0, rectangle.top() / cell_size().y());
+    int last_row = MIN(terminal->height() - 1, (rectangle.bottom() - 1) / cell_size().y());
+
+    for (int y = first_row; y <= last_row; y++)
     {
+        if (y < _scroll_offset)
+        {
+            scrollback.line(scrollback.count() - _scroll_offset + y, history.raw_storage(), terminal->width());
+
+            for (int x = 0; x < terminal->width(); x++)
+            {
+                render_cell(painter, x, y, history.raw_storage()[x]);
+            }
+
+            continue;
+        }
+
         for (int x = 0; x < terminal->width(); x++)
         {
-            terminal::Cell cell = terminal->cell_at(x, y);
+            terminal::Cell cell = terminal->cell_at(x, y - _scroll_offset);
             render_cell(painter, x, y, cell);
-            terminal->cell_undirty(x, y);
+            terminal->cell_undirty(x, y - _scroll_offset);
         }
     }
 
     int cx = terminal->cursor().x;
-    int cy = terminal->cursor().y;
+    int cy = terminal->cursor().y + _scroll_offset;
 
-    if (cell_bound(cx, cy).colide_with(rectangle))
+    if (cy < terminal->height() && cell_bound(cx, cy).colide_with(rectangle))
     {
-        terminal::Cell cell = terminal->cell_at(cx, cy);
+        terminal::Cell cell = terminal->cell_at(cx, cy - _scroll_offset);
 
         if (window()->focused())
         {
@@ -124,6 +143,45 @@ void TerminalWidget::paint(Painter &painter, Rectangle rectangle)
     painter.pop();
 }
 
+void TerminalWidget::repaint_dirty_rows()
+{
+    terminal::Terminal *terminal = _terminal;
+
+    int cursor_row = MIN(terminal->cursor().y, terminal->height() - 1);
+
+    if (_scroll_offset != 0)
+    {
+        should_repaint();
+    }
+    else
+    {
+        int first = MIN(terminal->dirty_first(), MIN(_cursor_row, cursor_row));
+        int last = MAX(terminal->dirty_last(), MAX(_cursor_row, cursor_row));
+
+        Rectangle rows = Rectangle(
+            0,
+            first * cell_size().y(),
+            bound().width(),
+            (last - first + 1) * cell_size().y());
+
+        should_repaint(rows.offset(bound().position()));
+    }
+
+    terminal->undirty();
+    _cursor_row = cursor_row;
+}
+
+void TerminalWidget::scroll(int how_many_line)
+{
+    int offset = clamp(_scroll_offset + how_many_line, 0, _terminal->scrollback().count());
+
+    if (offset != _scroll_offset)
+    {
+        _scroll_offset = offset;
+        should_repaint();
+    }
+}
+
 void TerminalWidget::event(Event *event)
 {
     auto send_sequence = [&](auto sequence) {
@@ -131,8 +189,22 @@ void TerminalWidget::event(Event *event)
         event->accepted = true;
     };
 
+    if (event->type == Event::KEYBOARD_KEY_TYPED &&
+        event->keyboard.modifiers & KEY_MODIFIER_SHIFT &&
+        (event->keyboard.key == KEYBOARD_KEY_PGUP || event->keyboard.key == KEYBOARD_KEY_PGDOWN))
+    {
+        int page = _terminal->height() / 2;
+        scroll(event->keyboard.key == KEYBOARD_KEY_PGUP ? page : -page);
+        event->accepted = true;
+
+        return;
+    }
+
     if (event->type == Event::KEYBOARD_KEY_TYPED)
     {
+        // Typing brings the screen back into view.
+        scroll(-_scroll_offset);
+
         switch (event->keyboard.key)
         {
         case KEYBOARD_KEY_DELETE:
@@ -13,6 +13,12 @@ private:
     terminal::Terminal *_terminal;
     bool _cursor_blink;
 
+    // How many lines of scrollback are shown above the screen.
+    int _scroll_offset = 0;
+
+    // Where the cursor was when the dirty rows were last repainted.
+    int _cursor_row = 0;
+
     Stream *_server_stream;
     Stream *_client_stream;
 
@@ -24,6 +30,10 @@ public:
 
     void blink() { _cursor_blink = !_cursor_blink; };
 
+    void scroll(int how_many_line);
+
+    void repaint_dirty_rows();
+
     TerminalWidget(Widget *parent);
 
     ~TerminalWidget();
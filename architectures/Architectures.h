@@ -20,6 +20,9 @@ size_t arch_debug_write(const void *buffer, size_t size);
 
 TimeStamp arch_get_time();
 
+// A free running counter, calibrated against the system tick.
+uint64_t arch_get_cycles();
+
 __no_return void arch_reboot();
 
 __no_return void arch_shutdown();
@@ -29,3 +32,7 @@ void arch_panic_dump();
 void arch_dump_stack_frame(void *stackframe);
 
 void arch_backtrace();
+
+// Walks the frame pointers of an interrupted context, innermost first, up to
+// the first frame that isn't mapped in the address space.
+size_t arch_sample_stack(void *stackframe, void *address_space, uintptr_t *frames, size_t depth);
@@ -9,6 +9,7 @@
 #include "kernel/interrupts/Dispatcher.h"
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Syscalls.h"
 
@@ -87,6 +88,7 @@ extern "C" uint32_t interrupts_handler(uintptr_t esp, InterruptStackFrame stackf
 
         if (irq == 0)
         {
+            profiler_sample(&stackframe);
             system_tick();
             esp = schedule(esp);
         }
@@ -111,6 +113,10 @@ extern "C" uint32_t interrupts_handler(uintptr_t esp, InterruptStackFrame stackf
 
         if (stackframe.eax == HJ_PROCESS_CLONE)
         {
+            // Taken before retaining interrupts, waiting on a lock in the
+            // kernel halts until the next one.
+            LockHolder holder(scheduler_running()->process->handles_lock);
+
             InterruptsRetainer retainer;
 
             auto usf = ((UserInterruptStackFrame *)&stackframe);
@@ -1,6 +1,7 @@
 #include <libsystem/Assert.h>
 #include <libsystem/core/Plugs.h>
 
+#include "architectures/VirtualMemory.h"
 #include "architectures/x86/kernel/COM.h"
 #include "architectures/x86/kernel/CPUID.h"
 #include "architectures/x86/kernel/PIC.h"
@@ -42,6 +43,8 @@ size_t arch_debug_write(const void *buffer, size_t size) { return com_write(COM1
 
 TimeStamp arch_get_time() { return rtc_now(); }
 
+uint64_t arch_get_cycles() { return rdtsc(); }
+
 extern "C" void arch_main(void *info, uint32_t magic)
 {
     __plug_init();
@@ -184,3 +187,38 @@ void arch_backtrace()
 {
     backtrace_internal(EBP());
 }
+
+size_t arch_sample_stack(void *sf, void *address_space, uintptr_t *frames, size_t depth)
+{
+    auto stackframe = reinterpret_cast<InterruptStackFrame *>(sf);
+
+    if (depth == 0)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    frames[count++] = stackframe->eip;
+
+    uintptr_t ebp = stackframe->ebp;
+
+    // The depth also bounds the walk through a chain that loops.
+    while (count < depth &&
+           ebp != 0 &&
+           ebp % sizeof(uintptr_t) == 0 &&
+           arch_virtual_present(address_space, ebp) &&
+           arch_virtual_present(address_space, ebp + sizeof(Stackframe) - 1))
+    {
+        auto frame = reinterpret_cast<Stackframe *>(ebp);
+
+        if (frame->eip == 0)
+        {
+            break;
+        }
+
+        frames[count++] = frame->eip;
+        ebp = reinterpret_cast<uintptr_t>(frame->ebp);
+    }
+
+    return count;
+}
@@ -3,6 +3,7 @@
 #include <libsystem/core/Plugs.h>
 #include <libsystem/io/Stream.h>
 
+#include "architectures/VirtualMemory.h"
 #include "architectures/x86/kernel/COM.h"
 #include "architectures/x86/kernel/CPUID.h"
 #include "architectures/x86/kernel/IOPort.h"
@@ -86,6 +87,11 @@ TimeStamp arch_get_time()
     return rtc_now();
 }
 
+uint64_t arch_get_cycles()
+{
+    return rdtsc();
+}
+
 __no_return void arch_reboot()
 {
     logger_warn("STUB %s", __func__);
@@ -180,3 +186,38 @@ void arch_backtrace()
 {
     backtrace_internal(RBP());
 }
+
+size_t arch_sample_stack(void *sf, void *address_space, uintptr_t *frames, size_t depth)
+{
+    auto stackframe = reinterpret_cast<InterruptStackFrame *>(sf);
+
+    if (depth == 0)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    frames[count++] = stackframe->rip;
+
+    uintptr_t rbp = stackframe->rbp;
+
+    // The depth also bounds the walk through a chain that loops.
+    while (count < depth &&
+           rbp != 0 &&
+           rbp % sizeof(uintptr_t) == 0 &&
+           arch_virtual_present(address_space, rbp) &&
+           arch_virtual_present(address_space, rbp + sizeof(Stackframe) - 1))
+    {
+        auto frame = reinterpret_cast<Stackframe *>(rbp);
+
+        if (frame->rip == 0)
+        {
+            break;
+        }
+
+        frames[count++] = frame->rip;
+        rbp = reinterpret_cast<uintptr_t>(frame->rbp);
+    }
+
+    return count;
+}
@@ -18,6 +18,7 @@ CONFIGS = \
 	CONFIG_MEMORY \
 	CONFIG_NAME \
 	CONFIG_OPTIMISATIONS \
+	CONFIG_SHARED_LIBRARIES \
 	CONFIG_VERSION
 
 CONFIG                ?=develop
@@ -66,6 +67,11 @@ CONFIG_NAME           ?=skift
 # The optimisation level used by the compiler.
 CONFIG_OPTIMISATIONS  ?=-O2
 
+# Link applications against shared libraries loaded by /System/Libraries/ld.so.
+# Experimental, the toolchain doesn't know about the dynamic linker yet.
+# Possible values: true/false
+CONFIG_SHARED_LIBRARIES?=false
+
 # The version number (usualy year.week).
 CONFIG_VERSION        ?=${shell date +'%y.%W'}
 
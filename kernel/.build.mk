@@ -17,7 +17,8 @@ KERNEL_LIBRARIES_SOURCES = \
 	$(wildcard libraries/libsystem/process/*.cpp) \
 	$(wildcard libraries/libsystem/utils/*.cpp) \
 	$(wildcard libraries/libsystem/core/*.cpp) \
-	$(wildcard libraries/libsystem/thread/*.cpp) \
+	$(wildcard libraries/libsystem/thread/Lock.cpp) \
+	$(wildcard libraries/libsystem/trace/*.cpp) \
 	$(wildcard libraries/libsystem/system/*.cpp) \
 	$(wildcard libraries/libsystem/cxx/new-delete.cpp)
 
@@ -37,6 +38,10 @@ KERNEL_CXXFLAGS += \
 	-D__KERNEL__ \
 	-DCONFIG_KEYBOARD_LAYOUT=\""${CONFIG_KEYBOARD_LAYOUT}"\"
 
+ifeq ($(CONFIG_SHARED_LIBRARIES), true)
+KERNEL_CXXFLAGS += -DCONFIG_SHARED_LIBRARIES
+endif
+
 OBJECTS += $(KERNEL_OBJECTS)
 
 $(BUILD_DIRECTORY)/kernel/%.o: libraries/%.cpp
@@ -24,11 +24,19 @@
 #define PCI_BAR4 0x20
 #define PCI_BAR5 0x24
 
+#define PCI_CAPABILITIES_POINTER 0x34
+
 #define PCI_INTERRUPT_LINE 0x3C
 #define PCI_INTERRUPT_PIN 0x3D
 
 #define PCI_SECONDARY_BUS 0x19
 
+#define PCI_COMMAND_IO (1 << 0)
+#define PCI_COMMAND_MEMORY (1 << 1)
+#define PCI_COMMAND_BUS_MASTER (1 << 2)
+
+#define PCI_STATUS_CAPABILITIES (1 << 4)
+
 #define PCI_HEADER_TYPE_DEVICE 0
 #define PCI_HEADER_TYPE_BRIDGE 1
 #define PCI_HEADER_TYPE_CARDBUS 2
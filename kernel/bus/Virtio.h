@@ -19,3 +19,59 @@
 #define VIRTIO_REGISTER_QUEUE_NOTIFY (0x10)
 #define VIRTIO_REGISTER_DEVICE_STATUS (0x12)
 #define VIRTIO_REGISTER_ISR_STATUS (0x13)
+
+// 4.1.4 Virtio Structure PCI Capabilities
+
+#define VIRTIO_PCI_CAPABILITY_VENDOR (0x09)
+
+#define VIRTIO_PCI_CAP_COMMON_CFG (1)
+#define VIRTIO_PCI_CAP_NOTIFY_CFG (2)
+#define VIRTIO_PCI_CAP_ISR_CFG (3)
+#define VIRTIO_PCI_CAP_DEVICE_CFG (4)
+
+#define VIRTIO_PCI_CAP_TYPE (3)
+#define VIRTIO_PCI_CAP_BAR (4)
+#define VIRTIO_PCI_CAP_OFFSET (8)
+#define VIRTIO_PCI_CAP_LENGTH (12)
+#define VIRTIO_PCI_CAP_NOTIFY_MULTIPLIER (16)
+
+// 4.1.4.3 Common configuration structure layout
+
+#define VIRTIO_COMMON_DEVICE_FEATURE_SELECT (0x00)
+#define VIRTIO_COMMON_DEVICE_FEATURE (0x04)
+#define VIRTIO_COMMON_DRIVER_FEATURE_SELECT (0x08)
+#define VIRTIO_COMMON_DRIVER_FEATURE (0x0C)
+#define VIRTIO_COMMON_NUM_QUEUES (0x12)
+#define VIRTIO_COMMON_DEVICE_STATUS (0x14)
+#define VIRTIO_COMMON_QUEUE_SELECT (0x16)
+#define VIRTIO_COMMON_QUEUE_SIZE (0x18)
+#define VIRTIO_COMMON_QUEUE_ENABLE (0x1C)
+#define VIRTIO_COMMON_QUEUE_NOTIFY_OFF (0x1E)
+#define VIRTIO_COMMON_QUEUE_DESCRIPTORS (0x20)
+#define VIRTIO_COMMON_QUEUE_AVAILABLE (0x28)
+#define VIRTIO_COMMON_QUEUE_USED (0x30)
+
+// 6 Reserved Feature Bits
+
+#define VIRTIO_F_VERSION_1 (32)
+
+// 2.6 Split Virtqueues
+
+#define VIRTQ_DESC_F_NEXT (1)
+#define VIRTQ_DESC_F_WRITE (2)
+
+#define VIRTQ_AVAIL_F_NO_INTERRUPT (1)
+
+struct __packed VirtioDescriptor
+{
+    uint64_t address;
+    uint32_t length;
+    uint16_t flags;
+    uint16_t next;
+};
+
+struct __packed VirtioUsedElement
+{
+    uint32_t id;
+    uint32_t length;
+};
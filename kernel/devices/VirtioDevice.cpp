@@ -0,0 +1,191 @@
+#include <libsystem/Logger.h>
+
+#include "kernel/devices/VirtioDevice.h"
+
+RefPtr<MMIORange> VirtioDevice::map_bar(int index)
+{
+    if (!_bars[index])
+    {
+        _bars[index] = make<MMIORange>(bar(index).range());
+    }
+
+    return _bars[index];
+}
+
+void VirtioDevice::write_status(uint8_t status)
+{
+    _common.range->write8(_common.offset + VIRTIO_COMMON_DEVICE_STATUS, status);
+}
+
+uint8_t VirtioDevice::read_status()
+{
+    return _common.range->read8(_common.offset + VIRTIO_COMMON_DEVICE_STATUS);
+}
+
+Result VirtioDevice::initialize_transport(uint64_t features)
+{
+    if (!(pci_address().read16(PCI_STATUS) & PCI_STATUS_CAPABILITIES))
+    {
+        logger_error("Virtio device has no capabilities, legacy devices are not supported");
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    uint8_t capability = pci_address().read8(PCI_CAPABILITIES_POINTER) & 0xFC;
+
+    // The list is bounded by the size of the configuration space, in case
+    // the device hands us a loop.
+    for (int i = 0; capability && i < 48; i++)
+    {
+        if (pci_address().read8(capability) == VIRTIO_PCI_CAPABILITY_VENDOR)
+        {
+            uint8_t type = pci_address().read8(capability + VIRTIO_PCI_CAP_TYPE);
+            uint8_t bar_index = pci_address().read8(capability + VIRTIO_PCI_CAP_BAR);
+            uint32_t offset = pci_address().read32(capability + VIRTIO_PCI_CAP_OFFSET);
+
+            VirtioRegion *region = nullptr;
+
+            if (type == VIRTIO_PCI_CAP_COMMON_CFG)
+            {
+                region = &_common;
+            }
+            else if (type == VIRTIO_PCI_CAP_NOTIFY_CFG)
+            {
+                region = &_notify;
+                _notify_multiplier = pci_address().read32(capability + VIRTIO_PCI_CAP_NOTIFY_MULTIPLIER);
+            }
+            else if (type == VIRTIO_PCI_CAP_ISR_CFG)
+            {
+                region = &_isr;
+            }
+            else if (type == VIRTIO_PCI_CAP_DEVICE_CFG)
+            {
+                region = &_device;
+            }
+
+            // The first capability of a given type is the preferred one.
+            if (region && !region->present() && bar_index < 6)
+            {
+                *region = {map_bar(bar_index), offset};
+            }
+        }
+
+        capability = pci_address().read8(capability + 1) & 0xFC;
+    }
+
+    if (!_common.present() || !_notify.present())
+    {
+        logger_error("Virtio device is missing its common or notify configuration");
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    pci_address().write16(PCI_COMMAND, pci_address().read16(PCI_COMMAND) | PCI_COMMAND_MEMORY | PCI_COMMAND_BUS_MASTER);
+
+    write_status(0);
+
+    while (read_status() != 0)
+    {
+        asm volatile("pause");
+    }
+
+    write_status(VIRTIO_STATUS_ACKNOWLEDGE);
+    write_status(VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+
+    auto read_features = [&](uint32_t select) {
+        _common.range->write32(_common.offset + VIRTIO_COMMON_DEVICE_FEATURE_SELECT, select);
+        return _common.range->read32(_common.offset + VIRTIO_COMMON_DEVICE_FEATURE);
+    };
+
+    auto write_features = [&](uint32_t select, uint32_t value) {
+        _common.range->write32(_common.offset + VIRTIO_COMMON_DRIVER_FEATURE_SELECT, select);
+        _common.range->write32(_common.offset + VIRTIO_COMMON_DRIVER_FEATURE, value);
+    };
+
+    uint64_t device_features = read_features(0) | ((uint64_t)read_features(1) << 32);
+
+    features |= 1ull << VIRTIO_F_VERSION_1;
+    features &= device_features;
+
+    if (!(features & (1ull << VIRTIO_F_VERSION_1)))
+    {
+        write_status(VIRTIO_STATUS_FAILED);
+        logger_error("Virtio device doesn't support VIRTIO_F_VERSION_1");
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    write_features(0, features & 0xFFFFFFFF);
+    write_features(1, features >> 32);
+
+    write_status(VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER | VIRTIO_STATUS_FEATURES_OK);
+
+    if (!(read_status() & VIRTIO_STATUS_FEATURES_OK))
+    {
+        write_status(VIRTIO_STATUS_FAILED);
+        logger_error("Virtio device refused our features");
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    return SUCCESS;
+}
+
+ResultOr<OwnPtr<VirtioQueue>> VirtioDevice::create_queue(uint16_t index)
+{
+    auto write16 = [&](size_t offset, uint16_t value) { _common.range->write16(_common.offset + offset, value); };
+    auto read16 = [&](size_t offset) { return _common.range->read16(_common.offset + offset); };
+
+    auto write64 = [&](size_t offset, uint64_t value) {
+        _common.range->write32(_common.offset + offset, value & 0xFFFFFFFF);
+        _common.range->write32(_common.offset + offset + 4, value >> 32);
+    };
+
+    if (index >= read16(VIRTIO_COMMON_NUM_QUEUES))
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    write16(VIRTIO_COMMON_QUEUE_SELECT, index);
+
+    uint16_t size = read16(VIRTIO_COMMON_QUEUE_SIZE);
+
+    if (size == 0)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    auto queue = own<VirtioQueue>(index, size);
+
+    write16(VIRTIO_COMMON_QUEUE_SIZE, queue->size());
+    write64(VIRTIO_COMMON_QUEUE_DESCRIPTORS, queue->descriptors_address());
+    write64(VIRTIO_COMMON_QUEUE_AVAILABLE, queue->available_address());
+    write64(VIRTIO_COMMON_QUEUE_USED, queue->used_address());
+
+    uint16_t notify_offset = read16(VIRTIO_COMMON_QUEUE_NOTIFY_OFF);
+    queue->notify_at(_notify.range, _notify.offset + notify_offset * _notify_multiplier);
+
+    write16(VIRTIO_COMMON_QUEUE_ENABLE, 1);
+
+    return queue;
+}
+
+void VirtioDevice::finish_initialization()
+{
+    write_status(read_status() | VIRTIO_STATUS_DRIVER_OK);
+}
+
+uint32_t VirtioDevice::read_device_config(size_t offset)
+{
+    return _device.range->read32(_device.offset + offset);
+}
+
+void VirtioDevice::write_device_config(size_t offset, uint32_t value)
+{
+    _device.range->write32(_device.offset + offset, value);
+}
+
+void VirtioDevice::acknowledge_interrupt()
+{
+    // Reading the ISR status deasserts the interrupt line.
+    if (_isr.present())
+    {
+        _isr.range->read8(_isr.offset);
+    }
+}
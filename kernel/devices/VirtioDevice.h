@@ -1,11 +1,51 @@
 #pragma once
 
+#include <libutils/OwnPtr.h>
+
 #include "kernel/bus/Virtio.h"
 #include "kernel/devices/PCIDevice.h"
+#include "kernel/devices/VirtioQueue.h"
+#include "kernel/memory/MMIO.h"
+
+struct VirtioRegion
+{
+    RefPtr<MMIORange> range;
+    size_t offset;
+
+    bool present() { return (bool)range; }
+};
 
 class VirtioDevice : public PCIDevice
 {
 private:
+    RefPtr<MMIORange> _bars[6] = {};
+
+    VirtioRegion _common = {};
+    VirtioRegion _notify = {};
+    VirtioRegion _isr = {};
+    VirtioRegion _device = {};
+
+    uint32_t _notify_multiplier = 0;
+
+    RefPtr<MMIORange> map_bar(int index);
+
+    void write_status(uint8_t status);
+
+    uint8_t read_status();
+
+protected:
+    // Locates the virtio 1.0 configuration structures, resets the device
+    // and negotiates `features`, VIRTIO_F_VERSION_1 is always requested.
+    Result initialize_transport(uint64_t features);
+
+    ResultOr<OwnPtr<VirtioQueue>> create_queue(uint16_t index);
+
+    void finish_initialization();
+
+    uint32_t read_device_config(size_t offset);
+
+    void write_device_config(size_t offset, uint32_t value);
+
 public:
     VirtioDevice(DeviceAddress address, DeviceClass klass) : PCIDevice(address, klass)
     {
@@ -14,6 +54,8 @@ public:
     ~VirtioDevice()
     {
     }
+
+    void acknowledge_interrupt() override;
 };
 
 template <typename VirtioDeviceType>
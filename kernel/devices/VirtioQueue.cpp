@@ -0,0 +1,125 @@
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+
+#include "kernel/devices/VirtioQueue.h"
+
+#define VIRTIO_QUEUE_TIMEOUT (0x1000000)
+
+VirtioQueue::VirtioQueue(uint16_t index, uint16_t size)
+    : _index(index),
+      _size(MIN(size, VIRTIO_QUEUE_MAX_SIZE))
+{
+    // Descriptors, then the available ring, then the used ring aligned on 4
+    // bytes, all of it fits in a single page for VIRTIO_QUEUE_MAX_SIZE.
+    size_t descriptors_size = sizeof(VirtioDescriptor) * _size;
+    size_t available_size = sizeof(uint16_t) * (3 + _size);
+    size_t used_offset = __align_up(descriptors_size + available_size, 4);
+    size_t used_size = sizeof(uint16_t) * 3 + sizeof(VirtioUsedElement) * _size;
+
+    _memory = make<MMIORange>(used_offset + used_size);
+    memset((void *)_memory->base(), 0, _memory->size());
+
+    _descriptors = reinterpret_cast<VirtioDescriptor *>(_memory->base());
+    _available = reinterpret_cast<volatile uint16_t *>(_memory->base() + descriptors_size);
+    _used = reinterpret_cast<volatile uint16_t *>(_memory->base() + used_offset);
+
+    for (uint16_t i = 0; i < _size; i++)
+    {
+        _descriptors[i].next = i + 1;
+    }
+
+    _free_head = 0;
+    _free_count = _size;
+
+    // Completion is polled, so we don't want the device to interrupt us.
+    _available[0] = VIRTQ_AVAIL_F_NO_INTERRUPT;
+}
+
+void VirtioQueue::notify_at(RefPtr<MMIORange> range, size_t offset)
+{
+    _notify_range = range;
+    _notify_offset = offset;
+}
+
+Result VirtioQueue::push(const VirtioBuffer *buffers, size_t count)
+{
+    if (count == 0 || count > _free_count)
+    {
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    uint16_t head = _free_head;
+    uint16_t current = head;
+
+    // The free list is linked through the same `next` field, so the chain
+    // is already in place and we only have to fill the descriptors.
+    for (size_t i = 0; i < count; i++)
+    {
+        VirtioDescriptor &descriptor = _descriptors[current];
+
+        descriptor.address = buffers[i].address;
+        descriptor.length = buffers[i].size;
+        descriptor.flags = (buffers[i].writable ? VIRTQ_DESC_F_WRITE : 0) |
+                           (i + 1 < count ? VIRTQ_DESC_F_NEXT : 0);
+
+        current = descriptor.next;
+    }
+
+    _free_head = current;
+    _free_count -= count;
+
+    _available[2 + _available_index % _size] = head;
+
+    __sync_synchronize();
+
+    _available_index++;
+    _available[1] = _available_index;
+
+    return SUCCESS;
+}
+
+void VirtioQueue::notify()
+{
+    __sync_synchronize();
+
+    _notify_range->write16(_notify_offset, _index);
+}
+
+Result VirtioQueue::wait()
+{
+    for (size_t i = 0; pending(); i++)
+    {
+        if (i >= VIRTIO_QUEUE_TIMEOUT)
+        {
+            logger_error("Virtio queue %d timed out", _index);
+            return ERR_NO_SUCH_DEVICE;
+        }
+
+        if (_used[1] == _used_index)
+        {
+            asm volatile("pause");
+            continue;
+        }
+
+        __sync_synchronize();
+
+        uint16_t head = used_element(_used_index % _size)->id;
+        uint16_t tail = head;
+        uint16_t count = 1;
+
+        while (_descriptors[tail].flags & VIRTQ_DESC_F_NEXT)
+        {
+            tail = _descriptors[tail].next;
+            count++;
+        }
+
+        _descriptors[tail].next = _free_head;
+        _free_head = head;
+        _free_count += count;
+
+        _used_index++;
+    }
+
+    return SUCCESS;
+}
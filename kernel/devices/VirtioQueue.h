@@ -0,0 +1,66 @@
+#pragma once
+
+#include <libsystem/Result.h>
+#include <libutils/RefPtr.h>
+
+#include "kernel/bus/Virtio.h"
+#include "kernel/memory/MMIO.h"
+
+#define VIRTIO_QUEUE_MAX_SIZE (64)
+
+struct VirtioBuffer
+{
+    uintptr_t address;
+    size_t size;
+    bool writable;
+};
+
+// Split virtqueue living in a single physically contiguous range, buffers
+// are physical addresses and completion is polled from the used ring.
+class VirtioQueue
+{
+private:
+    uint16_t _index;
+    uint16_t _size;
+
+    RefPtr<MMIORange> _memory;
+    VirtioDescriptor *_descriptors;
+    volatile uint16_t *_available;
+    volatile uint16_t *_used;
+
+    uint16_t _free_head = 0;
+    uint16_t _free_count = 0;
+    uint16_t _available_index = 0;
+    uint16_t _used_index = 0;
+
+    RefPtr<MMIORange> _notify_range;
+    size_t _notify_offset = 0;
+
+    VirtioUsedElement *used_element(uint16_t index)
+    {
+        return reinterpret_cast<VirtioUsedElement *>((uintptr_t)_used + 4) + index;
+    }
+
+public:
+    uint16_t index() { return _index; }
+
+    uint16_t size() { return _size; }
+
+    uintptr_t descriptors_address() { return _memory->physical_base(); }
+
+    uintptr_t available_address() { return _memory->physical_base() + ((uintptr_t)_available - _memory->base()); }
+
+    uintptr_t used_address() { return _memory->physical_base() + ((uintptr_t)_used - _memory->base()); }
+
+    bool pending() { return _used_index != _available_index; }
+
+    VirtioQueue(uint16_t index, uint16_t size);
+
+    void notify_at(RefPtr<MMIORange> range, size_t offset);
+
+    Result push(const VirtioBuffer *buffers, size_t count);
+
+    void notify();
+
+    Result wait();
+};
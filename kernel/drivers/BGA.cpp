@@ -1,9 +1,14 @@
+#include <libsystem/Assert.h>
 #include <libsystem/math/MinMax.h>
 
 #include "kernel/drivers/BGA.h"
 #include "kernel/graphics/Graphics.h"
+#include "kernel/graphics/PixelFormat.h"
 #include "kernel/handover/Handover.h"
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/System.h"
+#include "kernel/tasking/Task-Memory.h"
 
 void BGA::write_register(uint16_t address, uint16_t data)
 {
@@ -27,24 +32,56 @@ Result BGA::set_resolution(int width, int height)
     }
     else
     {
+        int buffers = MIN(BGA_MAX_BUFFERS, _framebuffer->size() / (width * height * sizeof(uint32_t)));
+
         write_register(BGA_REG_ENABLE, BGA_DISABLED);
         write_register(BGA_REG_XRES, width);
         write_register(BGA_REG_YRES, height);
+        write_register(BGA_REG_VIRT_WIDTH, width);
+        write_register(BGA_REG_VIRT_HEIGHT, height * buffers);
         write_register(BGA_REG_BPP, 32);
         write_register(BGA_REG_ENABLE, BGA_ENABLED | BGA_LINEAR_FRAMEBUFFER);
 
+        // The virtual height is clamped by the device when VRAM is short.
+        _buffers = MAX(1, read_register(BGA_REG_VIRT_HEIGHT) / height);
+        _front_buffer = 0;
+
+        write_register(BGA_REG_X_OFFSET, 0);
+        write_register(BGA_REG_Y_OFFSET, 0);
+
         _width = width;
         _height = height;
 
-        logger_info("Resolution set to %dx%d.", width, height);
+        logger_info("Resolution set to %dx%d with %d buffers.", width, height, _buffers);
 
         return SUCCESS;
     }
 }
 
+void BGA::wait_for_vertical_retrace()
+{
+    // Interrupts are on in iocalls, the ticks keep going and other tasks are
+    // still scheduled while this polls.
+    assert(!interrupts_retained());
+
+    // Wait for the end of the current retrace, then for the start of the next
+    // one. The whole wait is bounded in case the device doesn't emulate the
+    // bit, a late flip only tears.
+    uint32_t deadline = system_get_tick() + VGA_RETRACE_TIMEOUT;
+
+    while ((in8(VGA_INPUT_STATUS) & VGA_VERTICAL_RETRACE) && system_get_tick() < deadline)
+    {
+    }
+
+    while (!(in8(VGA_INPUT_STATUS) & VGA_VERTICAL_RETRACE) && system_get_tick() < deadline)
+    {
+    }
+}
+
 BGA::BGA(DeviceAddress address) : PCIDevice(address, DeviceClass::FRAMEBUFFER)
 {
     _framebuffer = make<MMIORange>(bar(0).range());
+    _memory_object = memory_object_create_device(bar(0).range());
     set_resolution(handover()->framebuffer_width, handover()->framebuffer_height);
     graphic_did_find_framebuffer(_framebuffer->base(), handover()->framebuffer_width, handover()->framebuffer_height);
 }
@@ -96,20 +133,53 @@ Result BGA::call(FsHandle &handle, IOCall request, void *args)
     {
         IOCallDisplayBlitArgs *blit = (IOCallDisplayBlitArgs *)args;
 
-        for (int y = MAX(0, blit->blit_y); y < MIN(_height, blit->blit_y + blit->blit_height); y++)
+        int from_x = MAX(0, blit->blit_x);
+        int to_x = MIN(MIN(_width, blit->buffer_width), blit->blit_x + blit->blit_width);
+
+        if (from_x >= to_x)
+        {
+            return SUCCESS;
+        }
+
+        for (int y = MAX(0, blit->blit_y); y < MIN(MIN(_height, blit->buffer_height), blit->blit_y + blit->blit_height); y++)
         {
-            for (int x = MAX(0, blit->blit_x); x < MIN(_width, blit->blit_x + blit->blit_width); x++)
-            {
-                uint32_t pixel = blit->buffer[y * blit->buffer_width + x];
+            pixel_convert_row_rgba_to_bgrx(
+                blit->buffer + y * blit->buffer_width + from_x,
+                (uint32_t *)(_framebuffer->base() + (_front_buffer * _height + y) * _width * sizeof(uint32_t)) + from_x,
+                to_x - from_x);
+        }
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_DISPLAY_MAP)
+    {
+        IOCallDisplayMapArgs *map = (IOCallDisplayMapArgs *)args;
+
+        auto memory_mapping = task_memory_mapping_create(scheduler_running(), _memory_object, MEMORY_NONE);
 
-                uint32_t converted_pixel = ((pixel >> 16) & 0x000000ff) |
-                                           ((pixel)&0xff00ff00) |
-                                           ((pixel << 16) & 0x00ff0000);
+        map->address = memory_mapping->address;
+        map->size = memory_mapping->size;
+        map->width = _width;
+        map->height = _height;
+        map->pitch = _width * sizeof(uint32_t);
+        map->buffers = _buffers;
 
-                _framebuffer->write32((y * _width + x) * sizeof(uint32_t), converted_pixel);
-            }
+        return SUCCESS;
+    }
+    else if (request == IOCALL_DISPLAY_FLIP)
+    {
+        IOCallDisplayFlipArgs *flip = (IOCallDisplayFlipArgs *)args;
+
+        if (flip->buffer < 0 || flip->buffer >= _buffers)
+        {
+            return ERR_INVALID_ARGUMENT;
         }
 
+        wait_for_vertical_retrace();
+
+        write_register(BGA_REG_Y_OFFSET, flip->buffer * _height);
+        _front_buffer = flip->buffer;
+
         return SUCCESS;
     }
     else
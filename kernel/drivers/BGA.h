@@ -2,6 +2,7 @@
 
 #include "kernel/devices/PCIDevice.h"
 #include "kernel/memory/MMIO.h"
+#include "kernel/memory/MemoryObject.h"
 
 #define BGA_ADDRESS 0x01CE
 #define BGA_DATA 0x01CF
@@ -10,24 +11,43 @@
 #define BGA_REG_YRES 0x2
 #define BGA_REG_BPP 0x3
 #define BGA_REG_ENABLE 0x4
+#define BGA_REG_VIRT_WIDTH 0x6
+#define BGA_REG_VIRT_HEIGHT 0x7
+#define BGA_REG_X_OFFSET 0x8
+#define BGA_REG_Y_OFFSET 0x9
 
 #define BGA_DISABLED 0x00
 #define BGA_ENABLED 0x01
 #define BGA_LINEAR_FRAMEBUFFER 0x40
 
+#define BGA_MAX_BUFFERS 2
+
+#define VGA_INPUT_STATUS 0x3DA
+#define VGA_VERTICAL_RETRACE 0x08
+
+// In ticks, a frame and a bit at 60Hz.
+#define VGA_RETRACE_TIMEOUT 20
+
 class BGA : public PCIDevice
 {
 private:
     int _width;
     int _height;
 
+    // Screens stacked in VRAM and the one currently scanned out.
+    int _buffers = 1;
+    int _front_buffer = 0;
+
     RefPtr<MMIORange> _framebuffer;
+    MemoryObject *_memory_object;
 
     void write_register(uint16_t address, uint16_t data);
     uint16_t read_register(uint16_t address);
 
     Result set_resolution(int width, int height);
 
+    void wait_for_vertical_retrace();
+
 public:
     BGA(DeviceAddress address);
 
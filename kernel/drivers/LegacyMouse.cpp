@@ -1,4 +1,5 @@
 #include "kernel/drivers/LegacyMouse.h"
+#include "kernel/interrupts/Interupts.h"
 
 void LegacyMouse::wait(int type)
 {
@@ -70,10 +71,50 @@ void LegacyMouse::handle_finished_packet(uint8_t packet0, uint8_t packet1, uint8
     event.right = (MouseButtonState)((packet0 >> 1) & 1);
     event.left = (MouseButtonState)((packet0)&1);
 
-    if (_events.write((const char *)&event, sizeof(MousePacket)) != sizeof(MousePacket))
+    enqueue(event);
+}
+
+static bool same_buttons(const MousePacket &a, const MousePacket &b)
+{
+    return a.left == b.left && a.right == b.right && a.middle == b.middle;
+}
+
+void LegacyMouse::flush_pending()
+{
+    if (!_has_pending)
+    {
+        return;
+    }
+
+    if (_events.write((const char *)&_pending, sizeof(MousePacket)) != sizeof(MousePacket))
     {
         logger_warn("Mouse buffer overflow!");
     }
+
+    _has_pending = false;
+}
+
+void LegacyMouse::enqueue(MousePacket packet)
+{
+    // Only packets that don't change the buttons are merged, so button
+    // transitions still happen at the exact position they were reported.
+    bool is_motion = packet.scroll == 0 && same_buttons(packet, _previous);
+
+    if (_has_pending && _pending_is_motion && is_motion)
+    {
+        _pending.offx += packet.offx;
+        _pending.offy += packet.offy;
+    }
+    else
+    {
+        flush_pending();
+
+        _pending = packet;
+        _has_pending = true;
+        _pending_is_motion = is_motion;
+    }
+
+    _previous = packet;
 }
 
 void LegacyMouse::handle_packet(uint8_t packet)
@@ -144,12 +185,35 @@ bool LegacyMouse::can_read(FsHandle &handle)
 {
     __unused(handle);
 
-    return !_events.empty();
+    return !_events.empty() || _has_pending;
 }
 
 ResultOr<size_t> LegacyMouse::read(FsHandle &handle, void *buffer, size_t size)
 {
     __unused(handle);
 
+    InterruptsRetainer retainer;
+
+    flush_pending();
+
     return _events.read((char *)buffer, (size / sizeof(MousePacket)) * sizeof(MousePacket));
 }
+
+// Synthetic packets go through the same path as the hardware ones, this is
+// used to replay or stress test input.
+ResultOr<size_t> LegacyMouse::write(FsHandle &handle, const void *buffer, size_t size)
+{
+    __unused(handle);
+
+    InterruptsRetainer retainer;
+
+    auto packets = reinterpret_cast<const MousePacket *>(buffer);
+    size_t count = size / sizeof(MousePacket);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        enqueue(packets[i]);
+    }
+
+    return count * sizeof(MousePacket);
+}
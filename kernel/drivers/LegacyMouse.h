@@ -14,6 +14,17 @@ private:
     int _cycle = 0;
     uint8_t _packet[4];
 
+    // Motion is accumulated here while nobody reads, so a busy reader gets
+    // one packet per button state instead of one per PS/2 packet.
+    MousePacket _pending = {};
+    bool _has_pending = false;
+    bool _pending_is_motion = false;
+    MousePacket _previous = {};
+
+    void flush_pending();
+
+    void enqueue(MousePacket packet);
+
     void wait(int type);
 
     void write_register(uint8_t a_write);
@@ -32,4 +43,6 @@ public:
     bool can_read(FsHandle &handle) override;
 
     ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size);
+
+    ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
 };
@@ -1 +1,522 @@
+#include <libsystem/Logger.h>
+#include <libsystem/math/MinMax.h>
+
 #include "kernel/drivers/VirtioGraphic.h"
+#include "kernel/graphics/PixelFormat.h"
+#include "kernel/handover/Handover.h"
+
+VirtioGraphic::VirtioGraphic(DeviceAddress address) : VirtioDevice(address, DeviceClass::FRAMEBUFFER)
+{
+    if (initialize_transport(0) != SUCCESS)
+    {
+        return;
+    }
+
+    auto control_queue_or_result = create_queue(0);
+    auto cursor_queue_or_result = create_queue(1);
+
+    if (!control_queue_or_result.success() || !cursor_queue_or_result.success())
+    {
+        logger_error("Failed to create the virtio-gpu queues");
+        return;
+    }
+
+    _control_queue = control_queue_or_result.take_value();
+    _cursor_queue = cursor_queue_or_result.take_value();
+
+    _requests = make<MMIORange>(ARCH_PAGE_SIZE);
+    _responses = make<MMIORange>(ARCH_PAGE_SIZE);
+    _cursor_request = make<MMIORange>(sizeof(VirtioGraphicUpdateCursor));
+
+    finish_initialization();
+
+    if (query_display_info() != SUCCESS)
+    {
+        _width = handover()->framebuffer_width;
+        _height = handover()->framebuffer_height;
+    }
+
+    _ready = true;
+
+    logger_info("virtio-gpu ready with a %dx%d display", _width, _height);
+}
+
+VirtioGraphic::~VirtioGraphic()
+{
+    if (_ready)
+    {
+        release_scanout();
+    }
+}
+
+template <typename T>
+T &VirtioGraphic::begin_command(uint32_t type)
+{
+    T &command = request<T>(_pending_slots);
+
+    memset(&command, 0, sizeof(T));
+    command.header.type = type;
+
+    return command;
+}
+
+Result VirtioGraphic::push_command(size_t request_size, size_t response_size, uint32_t expected_response)
+{
+    if (_pending_slots >= VIRTIO_GPU_SLOT_COUNT)
+    {
+        if (_push_result == SUCCESS)
+        {
+            _push_result = ERR_OUT_OF_MEMORY;
+        }
+
+        return ERR_OUT_OF_MEMORY;
+    }
+
+    size_t offset = _pending_slots * VIRTIO_GPU_SLOT_SIZE;
+
+    response<VirtioGraphicHeader>(_pending_slots).type = 0;
+    _expected_responses[_pending_slots] = expected_response;
+
+    VirtioBuffer buffers[] = {
+        {_requests->physical_base() + offset, request_size, false},
+        {_responses->physical_base() + offset, response_size, true},
+    };
+
+    Result result = _control_queue->push(buffers, 2);
+
+    if (result == SUCCESS)
+    {
+        _pending_slots++;
+    }
+    else if (_push_result == SUCCESS)
+    {
+        _push_result = result;
+    }
+
+    return result;
+}
+
+// What was queued still runs when a later command couldn't be, the batch
+// fails as a whole.
+Result VirtioGraphic::run_commands()
+{
+    Result result = SUCCESS;
+
+    if (_pending_slots > 0)
+    {
+        _control_queue->notify();
+        result = _control_queue->wait();
+    }
+
+    for (size_t i = 0; i < _pending_slots && result == SUCCESS; i++)
+    {
+        uint32_t type = response<VirtioGraphicHeader>(i).type;
+
+        if (type != _expected_responses[i])
+        {
+            logger_error("virtio-gpu command %04x failed with %04x", request<VirtioGraphicHeader>(i).type, type);
+            result = ERR_INVALID_ARGUMENT;
+        }
+    }
+
+    if (result == SUCCESS && _push_result != SUCCESS)
+    {
+        logger_error("Failed to queue a virtio-gpu command: %s", result_to_string(_push_result));
+        result = _push_result;
+    }
+
+    _pending_slots = 0;
+    _push_result = SUCCESS;
+
+    return result;
+}
+
+Result VirtioGraphic::query_display_info()
+{
+    begin_command<VirtioGraphicDisplayInfo>(VIRTIO_GPU_CMD_GET_DISPLAY_INFO);
+    push_command(sizeof(VirtioGraphicHeader), sizeof(VirtioGraphicDisplayInfo), VIRTIO_GPU_RESP_OK_DISPLAY_INFO);
+
+    Result result = run_commands();
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    auto &info = response<VirtioGraphicDisplayInfo>(0);
+
+    if (!info.modes[0].enabled)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    _width = info.modes[0].rectangle.width;
+    _height = info.modes[0].rectangle.height;
+
+    return SUCCESS;
+}
+
+ResultOr<uint32_t> VirtioGraphic::create_resource(uint32_t format, int width, int height, uintptr_t address, size_t size)
+{
+    uint32_t resource = _next_resource++;
+
+    auto &create = begin_command<VirtioGraphicResourceCreate2D>(VIRTIO_GPU_CMD_RESOURCE_CREATE_2D);
+    create.resource_id = resource;
+    create.format = format;
+    create.width = width;
+    create.height = height;
+
+    Result result = push_command(sizeof(VirtioGraphicResourceCreate2D));
+
+    if (result == SUCCESS)
+    {
+        auto &attach = begin_command<VirtioGraphicAttachBacking>(VIRTIO_GPU_CMD_RESOURCE_ATTACH_BACKING);
+        attach.resource_id = resource;
+        attach.entries_count = 1;
+        attach.entry = {address, (uint32_t)size, 0};
+        result = push_command(sizeof(VirtioGraphicAttachBacking));
+    }
+
+    Result run_result = run_commands();
+
+    if (result == SUCCESS)
+    {
+        result = run_result;
+    }
+
+    if (result != SUCCESS)
+    {
+        destroy_resource(resource);
+        return result;
+    }
+
+    return resource;
+}
+
+void VirtioGraphic::destroy_resource(uint32_t resource)
+{
+    auto &detach = begin_command<VirtioGraphicDetachBacking>(VIRTIO_GPU_CMD_RESOURCE_DETACH_BACKING);
+    detach.resource_id = resource;
+    push_command(sizeof(VirtioGraphicDetachBacking));
+
+    auto &unref = begin_command<VirtioGraphicResourceUnref>(VIRTIO_GPU_CMD_RESOURCE_UNREF);
+    unref.resource_id = resource;
+    push_command(sizeof(VirtioGraphicResourceUnref));
+
+    Result result = run_commands();
+
+    if (result != SUCCESS)
+    {
+        logger_warn("Failed to destroy virtio-gpu resource %d: %s", resource, result_to_string(result));
+    }
+}
+
+Result VirtioGraphic::push_transfer_and_flush(uint32_t resource, int stride, VirtioGraphicRectangle rectangle, bool flush)
+{
+    auto &transfer = begin_command<VirtioGraphicTransferToHost2D>(VIRTIO_GPU_CMD_TRANSFER_TO_HOST_2D);
+    transfer.rectangle = rectangle;
+    transfer.offset = ((uint64_t)rectangle.y * stride + rectangle.x) * sizeof(uint32_t);
+    transfer.resource_id = resource;
+
+    Result result = push_command(sizeof(VirtioGraphicTransferToHost2D));
+
+    if (result != SUCCESS || !flush)
+    {
+        return result;
+    }
+
+    auto &resource_flush = begin_command<VirtioGraphicResourceFlush>(VIRTIO_GPU_CMD_RESOURCE_FLUSH);
+    resource_flush.rectangle = rectangle;
+    resource_flush.resource_id = resource;
+
+    return push_command(sizeof(VirtioGraphicResourceFlush));
+}
+
+void VirtioGraphic::release_scanout()
+{
+    if (!_scanout_resource)
+    {
+        return;
+    }
+
+    // A null resource disables the scanout before its backing goes away.
+    begin_command<VirtioGraphicSetScanout>(VIRTIO_GPU_CMD_SET_SCANOUT);
+    push_command(sizeof(VirtioGraphicSetScanout));
+
+    Result result = run_commands();
+
+    if (result != SUCCESS)
+    {
+        logger_warn("Failed to disable the virtio-gpu scanout: %s", result_to_string(result));
+    }
+
+    destroy_resource(_scanout_resource);
+    memory_object_deref(_scanout_object);
+
+    _scanout_resource = 0;
+    _scanout_object = nullptr;
+}
+
+Result VirtioGraphic::attach_scanout(int memory_object, int width, int height)
+{
+    if (width != _width || height != _height)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    MemoryObject *object = memory_object_by_id(memory_object);
+
+    if (!object)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    size_t size = (size_t)width * height * sizeof(uint32_t);
+
+    if (object->device || object->range().size() < size)
+    {
+        memory_object_deref(object);
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    release_scanout();
+
+    auto resource_or_result = create_resource(VIRTIO_GPU_FORMAT_R8G8B8X8_UNORM, width, height, object->range().base(), size);
+
+    if (!resource_or_result.success())
+    {
+        memory_object_deref(object);
+        return resource_or_result.result();
+    }
+
+    uint32_t resource = resource_or_result.value();
+
+    VirtioGraphicRectangle screen = {0, 0, (uint32_t)width, (uint32_t)height};
+
+    auto &scanout = begin_command<VirtioGraphicSetScanout>(VIRTIO_GPU_CMD_SET_SCANOUT);
+    scanout.rectangle = screen;
+    scanout.scanout_id = 0;
+    scanout.resource_id = resource;
+
+    Result result = push_command(sizeof(VirtioGraphicSetScanout));
+
+    if (result == SUCCESS)
+    {
+        result = push_transfer_and_flush(resource, width, screen, true);
+    }
+
+    Result run_result = run_commands();
+
+    if (result == SUCCESS)
+    {
+        result = run_result;
+    }
+
+    if (result != SUCCESS)
+    {
+        destroy_resource(resource);
+        memory_object_deref(object);
+        return result;
+    }
+
+    _scanout_resource = resource;
+    _scanout_object = object;
+
+    return SUCCESS;
+}
+
+Result VirtioGraphic::flush_scanout(int x, int y, int width, int height)
+{
+    if (!_scanout_resource)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    int from_x = MAX(0, x);
+    int from_y = MAX(0, y);
+    int to_x = MIN(_width, x + width);
+    int to_y = MIN(_height, y + height);
+
+    if (from_x >= to_x || from_y >= to_y)
+    {
+        return SUCCESS;
+    }
+
+    VirtioGraphicRectangle rectangle = {
+        (uint32_t)from_x,
+        (uint32_t)from_y,
+        (uint32_t)(to_x - from_x),
+        (uint32_t)(to_y - from_y),
+    };
+
+    Result result = push_transfer_and_flush(_scanout_resource, _width, rectangle, true);
+
+    if (result != SUCCESS)
+    {
+        run_commands();
+        return result;
+    }
+
+    return run_commands();
+}
+
+Result VirtioGraphic::set_cursor(const uint32_t *buffer, int width, int height, int hotspot_x, int hotspot_y)
+{
+    if (!_cursor_resource)
+    {
+        size_t size = VIRTIO_GPU_CURSOR_SIZE * VIRTIO_GPU_CURSOR_SIZE * sizeof(uint32_t);
+
+        _cursor_backing = make<MMIORange>(size);
+
+        auto resource_or_result = create_resource(
+            VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM,
+            VIRTIO_GPU_CURSOR_SIZE, VIRTIO_GPU_CURSOR_SIZE,
+            _cursor_backing->physical_base(), size);
+
+        if (!resource_or_result.success())
+        {
+            return resource_or_result.result();
+        }
+
+        _cursor_resource = resource_or_result.value();
+    }
+
+    uint32_t *pixels = reinterpret_cast<uint32_t *>(_cursor_backing->base());
+
+    memset(pixels, 0, _cursor_backing->size());
+
+    for (int y = 0; y < MIN(height, VIRTIO_GPU_CURSOR_SIZE); y++)
+    {
+        pixel_convert_row_rgba_to_bgrx(
+            buffer + y * width,
+            pixels + y * VIRTIO_GPU_CURSOR_SIZE,
+            MIN(width, VIRTIO_GPU_CURSOR_SIZE));
+    }
+
+    VirtioGraphicRectangle cursor = {0, 0, VIRTIO_GPU_CURSOR_SIZE, VIRTIO_GPU_CURSOR_SIZE};
+    Result result = push_transfer_and_flush(_cursor_resource, VIRTIO_GPU_CURSOR_SIZE, cursor, false);
+
+    if (result != SUCCESS)
+    {
+        run_commands();
+        return result;
+    }
+
+    result = run_commands();
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    return submit_cursor(VIRTIO_GPU_CMD_UPDATE_CURSOR, hotspot_x, hotspot_y);
+}
+
+Result VirtioGraphic::submit_cursor(uint32_t type, uint32_t hotspot_x, uint32_t hotspot_y)
+{
+    auto *command = reinterpret_cast<VirtioGraphicUpdateCursor *>(_cursor_request->base());
+
+    memset(command, 0, sizeof(VirtioGraphicUpdateCursor));
+
+    command->header.type = type;
+    command->scanout_id = 0;
+    command->x = _cursor_x;
+    command->y = _cursor_y;
+    command->resource_id = _cursor_resource;
+    command->hotspot_x = hotspot_x;
+    command->hotspot_y = hotspot_y;
+
+    // The cursor queue has no responses, commands are fire and forget.
+    VirtioBuffer buffer = {_cursor_request->physical_base(), sizeof(VirtioGraphicUpdateCursor), false};
+
+    Result result = _cursor_queue->push(&buffer, 1);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    _cursor_queue->notify();
+
+    return _cursor_queue->wait();
+}
+
+Result VirtioGraphic::call(FsHandle &handle, IOCall request, void *args)
+{
+    __unused(handle);
+
+    if (!_ready)
+    {
+        return ERR_NO_SUCH_DEVICE;
+    }
+
+    if (request == IOCALL_DISPLAY_GET_MODE)
+    {
+        IOCallDisplayModeArgs *mode = (IOCallDisplayModeArgs *)args;
+
+        mode->width = _width;
+        mode->height = _height;
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_DISPLAY_SET_MODE)
+    {
+        IOCallDisplayModeArgs *mode = (IOCallDisplayModeArgs *)args;
+
+        if (mode->width <= 0 || mode->height <= 0 ||
+            mode->width > 8192 || mode->height > 8192)
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        // Resources have a fixed size, the caller attaches a bitmap of the
+        // new size before anything shows up again.
+        release_scanout();
+
+        _width = mode->width;
+        _height = mode->height;
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_DISPLAY_ATTACH)
+    {
+        IOCallDisplayAttachArgs *attach = (IOCallDisplayAttachArgs *)args;
+
+        return attach_scanout(attach->memory_object, attach->width, attach->height);
+    }
+    else if (request == IOCALL_DISPLAY_FLUSH)
+    {
+        IOCallDisplayFlushArgs *flush = (IOCallDisplayFlushArgs *)args;
+
+        return flush_scanout(flush->x, flush->y, flush->width, flush->height);
+    }
+    else if (request == IOCALL_DISPLAY_SET_CURSOR)
+    {
+        IOCallDisplayCursorArgs *cursor = (IOCallDisplayCursorArgs *)args;
+
+        if (!cursor->buffer || cursor->width <= 0 || cursor->height <= 0)
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        return set_cursor(cursor->buffer, cursor->width, cursor->height, cursor->hotspot_x, cursor->hotspot_y);
+    }
+    else if (request == IOCALL_DISPLAY_MOVE_CURSOR)
+    {
+        IOCallDisplayCursorPositionArgs *position = (IOCallDisplayCursorPositionArgs *)args;
+
+        _cursor_x = MAX(0, position->x);
+        _cursor_y = MAX(0, position->y);
+
+        if (!_cursor_resource)
+        {
+            return SUCCESS;
+        }
+
+        return submit_cursor(VIRTIO_GPU_CMD_MOVE_CURSOR, 0, 0);
+    }
+    else
+    {
+        return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+    }
+}
@@ -1,16 +1,226 @@
 #pragma once
 
+#include "architectures/Memory.h"
+
 #include "kernel/devices/VirtioDevice.h"
+#include "kernel/memory/MemoryObject.h"
+
+// 5.7 GPU Device
+
+#define VIRTIO_GPU_CMD_GET_DISPLAY_INFO (0x0100)
+#define VIRTIO_GPU_CMD_RESOURCE_CREATE_2D (0x0101)
+#define VIRTIO_GPU_CMD_RESOURCE_UNREF (0x0102)
+#define VIRTIO_GPU_CMD_SET_SCANOUT (0x0103)
+#define VIRTIO_GPU_CMD_RESOURCE_FLUSH (0x0104)
+#define VIRTIO_GPU_CMD_TRANSFER_TO_HOST_2D (0x0105)
+#define VIRTIO_GPU_CMD_RESOURCE_ATTACH_BACKING (0x0106)
+#define VIRTIO_GPU_CMD_RESOURCE_DETACH_BACKING (0x0107)
+
+#define VIRTIO_GPU_CMD_UPDATE_CURSOR (0x0300)
+#define VIRTIO_GPU_CMD_MOVE_CURSOR (0x0301)
+
+#define VIRTIO_GPU_RESP_OK_NODATA (0x1100)
+#define VIRTIO_GPU_RESP_OK_DISPLAY_INFO (0x1101)
+#define VIRTIO_GPU_RESP_ERR_UNSPEC (0x1200)
+
+// Formats are named after their byte order in memory, R8G8B8X8 matches the
+// layout of Color so the device can scan out our bitmaps as they are.
+#define VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM (1)
+#define VIRTIO_GPU_FORMAT_R8G8B8X8_UNORM (134)
+
+#define VIRTIO_GPU_MAX_SCANOUTS (16)
+
+#define VIRTIO_GPU_CURSOR_SIZE (64)
+
+// Requests and responses are carved out of a page in fixed size slots, so
+// a transfer and its flush can be submitted together.
+#define VIRTIO_GPU_SLOT_SIZE (512)
+#define VIRTIO_GPU_SLOT_COUNT (ARCH_PAGE_SIZE / VIRTIO_GPU_SLOT_SIZE)
+
+struct __packed VirtioGraphicHeader
+{
+    uint32_t type;
+    uint32_t flags;
+    uint64_t fence_id;
+    uint32_t context_id;
+    uint32_t padding;
+};
+
+struct __packed VirtioGraphicRectangle
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct __packed VirtioGraphicDisplayInfo
+{
+    VirtioGraphicHeader header;
+
+    struct __packed
+    {
+        VirtioGraphicRectangle rectangle;
+        uint32_t enabled;
+        uint32_t flags;
+    } modes[VIRTIO_GPU_MAX_SCANOUTS];
+};
+
+struct __packed VirtioGraphicResourceCreate2D
+{
+    VirtioGraphicHeader header;
+    uint32_t resource_id;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct __packed VirtioGraphicResourceUnref
+{
+    VirtioGraphicHeader header;
+    uint32_t resource_id;
+    uint32_t padding;
+};
+
+struct __packed VirtioGraphicSetScanout
+{
+    VirtioGraphicHeader header;
+    VirtioGraphicRectangle rectangle;
+    uint32_t scanout_id;
+    uint32_t resource_id;
+};
+
+struct __packed VirtioGraphicResourceFlush
+{
+    VirtioGraphicHeader header;
+    VirtioGraphicRectangle rectangle;
+    uint32_t resource_id;
+    uint32_t padding;
+};
+
+struct __packed VirtioGraphicTransferToHost2D
+{
+    VirtioGraphicHeader header;
+    VirtioGraphicRectangle rectangle;
+    uint64_t offset;
+    uint32_t resource_id;
+    uint32_t padding;
+};
+
+struct __packed VirtioGraphicMemoryEntry
+{
+    uint64_t address;
+    uint32_t length;
+    uint32_t padding;
+};
+
+struct __packed VirtioGraphicAttachBacking
+{
+    VirtioGraphicHeader header;
+    uint32_t resource_id;
+    uint32_t entries_count;
+
+    // Memory objects are physically contiguous, so one entry is enough.
+    VirtioGraphicMemoryEntry entry;
+};
+
+struct __packed VirtioGraphicDetachBacking
+{
+    VirtioGraphicHeader header;
+    uint32_t resource_id;
+    uint32_t padding;
+};
+
+struct __packed VirtioGraphicUpdateCursor
+{
+    VirtioGraphicHeader header;
+
+    uint32_t scanout_id;
+    uint32_t x;
+    uint32_t y;
+    uint32_t padding0;
+
+    uint32_t resource_id;
+    uint32_t hotspot_x;
+    uint32_t hotspot_y;
+    uint32_t padding1;
+};
 
 class VirtioGraphic : public VirtioDevice
 {
 private:
-public:
-    VirtioGraphic(DeviceAddress address) : VirtioDevice(address, DeviceClass::FRAMEBUFFER)
+    bool _ready = false;
+
+    OwnPtr<VirtioQueue> _control_queue;
+    OwnPtr<VirtioQueue> _cursor_queue;
+
+    RefPtr<MMIORange> _requests;
+    RefPtr<MMIORange> _responses;
+    size_t _pending_slots = 0;
+
+    // What each pending command should be answered with, and the first
+    // command that couldn't be queued, it is reported by run_commands().
+    uint32_t _expected_responses[VIRTIO_GPU_SLOT_COUNT] = {};
+    Result _push_result = SUCCESS;
+
+    RefPtr<MMIORange> _cursor_request;
+    RefPtr<MMIORange> _cursor_backing;
+
+    int _width = 0;
+    int _height = 0;
+
+    uint32_t _next_resource = 1;
+
+    // The memory object of the bitmap currently scanned out, the device
+    // reads from it directly on every transfer.
+    MemoryObject *_scanout_object = nullptr;
+    uint32_t _scanout_resource = 0;
+
+    uint32_t _cursor_resource = 0;
+    int _cursor_x = 0;
+    int _cursor_y = 0;
+
+    template <typename T>
+    T &request(size_t slot)
     {
+        return *reinterpret_cast<T *>(_requests->base() + slot * VIRTIO_GPU_SLOT_SIZE);
     }
 
-    ~VirtioGraphic()
+    template <typename T>
+    T &response(size_t slot)
     {
+        return *reinterpret_cast<T *>(_responses->base() + slot * VIRTIO_GPU_SLOT_SIZE);
     }
+
+    template <typename T>
+    T &begin_command(uint32_t type);
+
+    Result push_command(size_t request_size, size_t response_size = sizeof(VirtioGraphicHeader), uint32_t expected_response = VIRTIO_GPU_RESP_OK_NODATA);
+
+    Result run_commands();
+
+    Result query_display_info();
+
+    ResultOr<uint32_t> create_resource(uint32_t format, int width, int height, uintptr_t address, size_t size);
+
+    void destroy_resource(uint32_t resource);
+
+    Result push_transfer_and_flush(uint32_t resource, int stride, VirtioGraphicRectangle rectangle, bool flush);
+
+    void release_scanout();
+
+    Result attach_scanout(int memory_object, int width, int height);
+
+    Result flush_scanout(int x, int y, int width, int height);
+
+    Result set_cursor(const uint32_t *buffer, int width, int height, int hotspot_x, int hotspot_y);
+
+    Result submit_cursor(uint32_t type, uint32_t hotspot_x, uint32_t hotspot_y);
+
+public:
+    VirtioGraphic(DeviceAddress address);
+
+    ~VirtioGraphic();
+
+    Result call(FsHandle &handle, IOCall request, void *args) override;
 };
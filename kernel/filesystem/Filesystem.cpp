@@ -7,8 +7,22 @@
 #include "kernel/node/Socket.h"
 #include "kernel/scheduling/Scheduler.h"
 
+#define FILESYSTEM_CACHE_SIZE 256
+
+struct FilesystemCacheEntry
+{
+    bool used;
+    uint32_t hash;
+    Vector<String> elements;
+    RefPtr<FsNode> node;
+};
+
 static FsNode *_filesystem_root = nullptr;
 
+static Lock _cache_lock;
+static uint32_t _cache_generation = 0;
+static FilesystemCacheEntry *_cache = nullptr;
+
 static RefPtr<FsNode> filesystem_root()
 {
     assert(_filesystem_root);
@@ -22,14 +36,102 @@ void filesystem_initialize()
     _filesystem_root = new FsDirectory();
     _filesystem_root->ref();
 
+    lock_init(_cache_lock);
+    _cache = new FilesystemCacheEntry[FILESYSTEM_CACHE_SIZE];
+
     logger_info("File system root at 0x%x", _filesystem_root);
 }
 
-RefPtr<FsNode> filesystem_find(Path path)
+/* --- Path lookup cache ---------------------------------------------------- */
+
+static uint32_t cache_hash(Path &path, size_t length)
+{
+    uint32_t result = 5381;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        result = (result * 33) ^ hash<String>(path[i]);
+    }
+
+    return result;
+}
+
+static bool cache_entry_match(FilesystemCacheEntry &entry, uint32_t hash, Path &path, size_t length)
+{
+    if (!entry.used || entry.hash != hash || entry.elements.count() != length)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (!(entry.elements[i] == path[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool cache_lookup(Path &path, size_t length, uint32_t hash, RefPtr<FsNode> &node)
+{
+    LockHolder holder(_cache_lock);
+
+    auto &entry = _cache[hash % FILESYSTEM_CACHE_SIZE];
+
+    if (cache_entry_match(entry, hash, path, length))
+    {
+        node = entry.node;
+        return true;
+    }
+
+    return false;
+}
+
+static void cache_insert(Path &path, size_t length, uint32_t hash, RefPtr<FsNode> node, uint32_t generation)
+{
+    LockHolder holder(_cache_lock);
+
+    // The tree changed while we were walking it, what we found might be stale.
+    if (generation != _cache_generation)
+    {
+        return;
+    }
+
+    auto &entry = _cache[hash % FILESYSTEM_CACHE_SIZE];
+
+    entry.used = true;
+    entry.hash = hash;
+    entry.elements.clear();
+
+    for (size_t i = 0; i < length; i++)
+    {
+        entry.elements.push_back(path[i]);
+    }
+
+    entry.node = node;
+}
+
+// Lookups are cached by full path, including the misses, so any change to
+// the tree drops the whole cache instead of tracking which entries depend
+// on the changed directory.
+static void cache_invalidate()
 {
-    auto current = filesystem_root();
+    LockHolder holder(_cache_lock);
 
-    for (size_t i = 0; i < path.length(); i++)
+    _cache_generation++;
+
+    for (size_t i = 0; i < FILESYSTEM_CACHE_SIZE; i++)
+    {
+        _cache[i].used = false;
+        _cache[i].node = nullptr;
+    }
+}
+
+static RefPtr<FsNode> filesystem_walk(RefPtr<FsNode> current, Path &path, size_t from, size_t to)
+{
+    for (size_t i = from; i < to; i++)
     {
         if (current && current->type() == FILE_TYPE_DIRECTORY)
         {
@@ -50,6 +152,43 @@ RefPtr<FsNode> filesystem_find(Path path)
     return current;
 }
 
+RefPtr<FsNode> filesystem_find(Path path)
+{
+    if (path.length() == 0)
+    {
+        return filesystem_root();
+    }
+
+    RefPtr<FsNode> node;
+
+    uint32_t hash = cache_hash(path, path.length());
+
+    if (cache_lookup(path, path.length(), hash, node))
+    {
+        return node;
+    }
+
+    uint32_t generation = __atomic_load_n(&_cache_generation, __ATOMIC_SEQ_CST);
+
+    // Siblings are often looked up one after the other, so try to start
+    // the walk from the parent directory.
+    size_t parent_length = path.length() - 1;
+    uint32_t parent_hash = cache_hash(path, parent_length);
+
+    RefPtr<FsNode> parent;
+
+    if (!cache_lookup(path, parent_length, parent_hash, parent))
+    {
+        parent = filesystem_walk(filesystem_root(), path, 0, parent_length);
+        cache_insert(path, parent_length, parent_hash, parent, generation);
+    }
+
+    node = filesystem_walk(parent, path, parent_length, path.length());
+    cache_insert(path, path.length(), hash, node, generation);
+
+    return node;
+}
+
 ResultOr<FsHandle *> filesystem_open(Path path, OpenFlag flags)
 {
     bool should_create_if_not_present = (flags & OPEN_CREATE) == OPEN_CREATE;
@@ -74,6 +213,8 @@ ResultOr<FsHandle *> filesystem_open(Path path, OpenFlag flags)
             parent->acquire(scheduler_running_id());
             parent->link(path.basename(), node);
             parent->release(scheduler_running_id());
+
+            cache_invalidate();
         }
     }
 
@@ -187,6 +328,8 @@ Result filesystem_link(Path path, RefPtr<FsNode> node)
     auto result = parent->link(path.basename(), node);
     parent->release(scheduler_running_id());
 
+    cache_invalidate();
+
     return result;
 }
 
@@ -208,6 +351,8 @@ Result filesystem_unlink(Path path)
     auto result = parent->unlink(path.basename());
     parent->release(scheduler_running_id());
 
+    cache_invalidate();
+
     return result;
 }
 
@@ -260,5 +405,7 @@ Result filesystem_rename(Path old_path, Path new_path)
 
     new_parent->release(scheduler_running_id());
 
+    cache_invalidate();
+
     return result;
 }
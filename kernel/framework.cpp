@@ -57,6 +57,19 @@ void __plug_lock_assert_failed(Lock *lock, const char *file, const char *functio
     ASSERT_NOT_REACHED();
 }
 
+void __plug_lock_wait(Lock *lock)
+{
+    __unused(lock);
+
+    asm("hlt"); // Don't burn the CPU ;)
+}
+
+void __plug_lock_wake(Lock *lock)
+{
+    // Waiting tasks try again on the next interrupt.
+    __unused(lock);
+}
+
 /* --- Systeme API ---------------------------------------------------------- */
 
 TimeStamp __plug_system_get_time()
@@ -66,7 +79,12 @@ TimeStamp __plug_system_get_time()
 
 uint __plug_system_get_ticks()
 {
-    return system_get_ticks();
+    return system_get_tick();
+}
+
+uint64_t __plug_system_get_microseconds()
+{
+    return system_clock_microseconds();
 }
 
 /* --- Memory allocator plugs ----------------------------------------------- */
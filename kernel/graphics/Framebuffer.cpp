@@ -7,13 +7,18 @@
 
 #include "kernel/filesystem/Filesystem.h"
 #include "kernel/graphics/Graphics.h"
+#include "kernel/graphics/PixelFormat.h"
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/memory/MemoryObject.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/tasking/Task-Memory.h"
 
 static uintptr_t _framebuffer_physical = 0;
 static uintptr_t _framebuffer_virtual = 0;
 static int _framebuffer_width = 0;
 static int _framebuffer_height = 0;
 static int _framebuffer_pitch = 0;
+static MemoryObject *_framebuffer_memory_object = nullptr;
 
 class Framebuffer : public FsNode
 {
@@ -45,24 +50,39 @@ public:
         {
             IOCallDisplayBlitArgs *blit = (IOCallDisplayBlitArgs *)args;
 
-            InterruptsRetainer retainer;
+            int from_x = MAX(0, blit->blit_x);
+            int to_x = MIN(MIN(_framebuffer_width, blit->buffer_width), blit->blit_x + blit->blit_width);
 
-            for (int y = MAX(0, blit->blit_y); y < MIN(_framebuffer_height, blit->blit_y + blit->blit_height); y++)
+            if (from_x >= to_x)
             {
-                for (int x = MAX(0, blit->blit_x); x < MIN(_framebuffer_width, blit->blit_x + blit->blit_width); x++)
-                {
-                    uint32_t pixel = blit->buffer[y * blit->buffer_width + x];
-
-                    uint32_t converted_pixel = ((pixel >> 16) & 0x000000ff) |
-                                               ((pixel)&0xff00ff00) |
-                                               ((pixel << 16) & 0x00ff0000);
+                return SUCCESS;
+            }
 
-                    ((uint32_t *)_framebuffer_virtual)[y * (_framebuffer_pitch / 4) + x] = converted_pixel;
-                }
+            for (int y = MAX(0, blit->blit_y); y < MIN(MIN(_framebuffer_height, blit->buffer_height), blit->blit_y + blit->blit_height); y++)
+            {
+                pixel_convert_row_rgba_to_bgrx(
+                    blit->buffer + y * blit->buffer_width + from_x,
+                    (uint32_t *)(_framebuffer_virtual + y * _framebuffer_pitch) + from_x,
+                    to_x - from_x);
             }
 
             return SUCCESS;
         }
+        else if (iocall == IOCALL_DISPLAY_MAP)
+        {
+            IOCallDisplayMapArgs *map = (IOCallDisplayMapArgs *)args;
+
+            auto memory_mapping = task_memory_mapping_create(scheduler_running(), _framebuffer_memory_object, MEMORY_NONE);
+
+            map->address = memory_mapping->address;
+            map->size = memory_mapping->size;
+            map->width = _framebuffer_width;
+            map->height = _framebuffer_height;
+            map->pitch = _framebuffer_pitch;
+            map->buffers = 1;
+
+            return SUCCESS;
+        }
         else
         {
             return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
@@ -79,14 +99,13 @@ void framebuffer_initialize(Handover *handover)
     _framebuffer_pitch = handover->framebuffer_pitch;
 
     _framebuffer_physical = handover->framebuffer_addr;
-    _framebuffer_virtual = arch_virtual_alloc(
-                               arch_kernel_address_space(),
-                               (MemoryRange){
-                                   _framebuffer_physical,
-                                   PAGE_ALIGN_UP(_framebuffer_width * _framebuffer_height * sizeof(uint32_t)),
-                               },
-                               MEMORY_NONE)
-                               .base();
+
+    MemoryRange framebuffer_range = {
+        _framebuffer_physical,
+        PAGE_ALIGN_UP((size_t)_framebuffer_pitch * _framebuffer_height),
+    };
+
+    _framebuffer_virtual = arch_virtual_alloc(arch_kernel_address_space(), framebuffer_range, MEMORY_NONE).base();
 
     if (_framebuffer_virtual == 0)
     {
@@ -94,6 +113,8 @@ void framebuffer_initialize(Handover *handover)
         return;
     }
 
+    _framebuffer_memory_object = memory_object_create_device(framebuffer_range);
+
     graphic_did_find_framebuffer(_framebuffer_virtual, _framebuffer_width, _framebuffer_height);
 
     filesystem_link(Path::parse(FRAMEBUFFER_DEVICE_PATH), make<Framebuffer>());
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <libsystem/Common.h>
+
 enum PixelFormat
 {
     PIXELFORMAT_NONE,
@@ -7,3 +9,16 @@ enum PixelFormat
     PIXELFORMAT_CGA,
     PIXELFORMAT_RGB,
 };
+
+// Convert a row of RGBA pixels to the BGRX layout of linear framebuffers.
+static inline void pixel_convert_row_rgba_to_bgrx(const uint32_t *source, uint32_t *destination, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t pixel = source[i];
+
+        destination[i] = ((pixel >> 16) & 0x000000ff) |
+                         ((pixel)&0xff00ff00) |
+                         ((pixel << 16) & 0x00ff0000);
+    }
+}
@@ -1,5 +1,6 @@
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
+#include <libsystem/trace/Trace.h>
 #include <libutils/RingBuffer.h>
 
 #include "kernel/devices/Devices.h"
@@ -75,6 +76,7 @@ void dispatcher_service()
             {
                 if (snapshot[i])
                 {
+                    TRACE_SCOPE("interrupt", i);
                     devices_handle_interrupt(i);
                 }
             }
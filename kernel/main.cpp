@@ -17,7 +17,10 @@
 #include "kernel/modules/Modules.h"
 #include "kernel/node/DevicesInfo.h"
 #include "kernel/node/ProcessInfo.h"
+#include "kernel/node/ProfileInfo.h"
+#include "kernel/node/TraceInfo.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Statistics.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Tasking.h"
 #include "kernel/tasking/Userspace.h"
@@ -42,6 +45,7 @@ void system_main(Handover *handover)
 
     system_initialize();
     memory_initialize(handover);
+    statistics_initialize();
     scheduler_initialize();
     tasking_initialize();
     interrupts_initialize();
@@ -51,6 +55,8 @@ void system_main(Handover *handover)
     device_initialize();
     process_info_initialize();
     device_info_initialize();
+    trace_info_initialize();
+    profile_info_initialize();
     devices_filesystem_initialize();
     graphic_initialize(handover);
     userspace_initialize();
@@ -2,6 +2,8 @@
 
 #include <libsystem/Common.h>
 
+#include "kernel/memory/MemoryRange.h"
+
 struct MemoryObject
 {
     int id;
@@ -9,6 +11,12 @@ struct MemoryObject
 
     int refcount;
 
+    // Every userspace mapping of the object is read-only.
+    bool readonly;
+
+    // The physical memory belongs to a device and is not released with the object.
+    bool device;
+
     auto range() { return _range; }
 };
 
@@ -16,6 +24,8 @@ void memory_object_initialize();
 
 MemoryObject *memory_object_create(size_t size);
 
+MemoryObject *memory_object_create_device(MemoryRange physical_range);
+
 void memory_object_destroy(MemoryObject *memory_object);
 
 MemoryObject *memory_object_ref(MemoryObject *memory_object);
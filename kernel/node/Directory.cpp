@@ -8,6 +8,63 @@
 
 FsDirectory::FsDirectory() : FsNode(FILE_TYPE_DIRECTORY)
 {
+    index_rebuild(16);
+}
+
+FsDirectory::~FsDirectory()
+{
+    delete[] _index;
+}
+
+size_t FsDirectory::index_lookup(const String &name, uint32_t hash)
+{
+    size_t mask = _index_capacity - 1;
+
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        size_t entry = _index[slot];
+
+        if (entry == INDEX_EMPTY)
+        {
+            return INDEX_EMPTY;
+        }
+
+        if (_childs[entry].hash == hash && _childs[entry].name == name)
+        {
+            return entry;
+        }
+    }
+}
+
+void FsDirectory::index_insert(size_t entry)
+{
+    size_t mask = _index_capacity - 1;
+    size_t slot = _childs[entry].hash & mask;
+
+    while (_index[slot] != INDEX_EMPTY)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    _index[slot] = entry;
+}
+
+void FsDirectory::index_rebuild(size_t capacity)
+{
+    delete[] _index;
+
+    _index = new size_t[capacity];
+    _index_capacity = capacity;
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        _index[i] = INDEX_EMPTY;
+    }
+
+    for (size_t i = 0; i < _childs.count(); i++)
+    {
+        index_insert(i);
+    }
 }
 
 Result FsDirectory::open(FsHandle *handle)
@@ -69,48 +126,51 @@ ResultOr<size_t> FsDirectory::read(FsHandle &handle, void *buffer, size_t size)
 
 RefPtr<FsNode> FsDirectory::find(String name)
 {
-    RefPtr<FsNode> result;
-
-    _childs.foreach ([&](auto &entry) {
-        if (entry.name == name)
-        {
-            result = entry.node;
+    size_t entry = index_lookup(name, hash<String>(name));
 
-            return Iteration::STOP;
-        }
-
-        return Iteration::CONTINUE;
-    });
+    if (entry == INDEX_EMPTY)
+    {
+        return nullptr;
+    }
 
-    return result;
+    return _childs[entry].node;
 }
 
 Result FsDirectory::link(String name, RefPtr<FsNode> child)
 {
-    if (find(name))
+    uint32_t name_hash = hash<String>(name);
+
+    if (index_lookup(name, name_hash) != INDEX_EMPTY)
     {
         return ERR_FILE_EXISTS;
     }
 
-    _childs.push_back({name, child});
+    _childs.push_back({name_hash, name, child});
+
+    if (_childs.count() * 2 > _index_capacity)
+    {
+        index_rebuild(_index_capacity * 2);
+    }
+    else
+    {
+        index_insert(_childs.count() - 1);
+    }
 
     return SUCCESS;
 }
 
 Result FsDirectory::unlink(String name)
 {
+    size_t entry = index_lookup(name, hash<String>(name));
 
-    bool has_removed_an_entry = _childs.remove_all_match(
-        [&](auto &e) {
-            return e.name == name;
-        });
-
-    if (has_removed_an_entry)
-    {
-        return SUCCESS;
-    }
-    else
+    if (entry == INDEX_EMPTY)
     {
         return ERR_NO_SUCH_FILE_OR_DIRECTORY;
     }
+
+    // Removing shifts the following entries, so the index is rebuilt.
+    _childs.remove_index(entry);
+    index_rebuild(_index_capacity);
+
+    return SUCCESS;
 }
@@ -12,6 +12,7 @@ struct DirectoryListing
 
 struct FsDirectoryEntry
 {
+    uint32_t hash;
     String name;
     RefPtr<FsNode> node;
 };
@@ -19,11 +20,26 @@ struct FsDirectoryEntry
 class FsDirectory : public FsNode
 {
 private:
+    static constexpr size_t INDEX_EMPTY = (size_t)-1;
+
     Vector<FsDirectoryEntry> _childs{};
 
+    // Open addressing table of indexes into _childs, keyed by the hash of
+    // the entry name and kept at most half full.
+    size_t *_index = nullptr;
+    size_t _index_capacity = 0;
+
+    size_t index_lookup(const String &name, uint32_t hash);
+
+    void index_insert(size_t entry);
+
+    void index_rebuild(size_t capacity);
+
 public:
     FsDirectory();
 
+    ~FsDirectory();
+
     Result open(FsHandle *handle) override;
 
     void close(FsHandle *handle) override;
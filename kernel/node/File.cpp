@@ -1,32 +1,121 @@
-
 #include <libsystem/Logger.h>
 #include <libsystem/Result.h>
 #include <libsystem/core/CString.h>
 #include <libsystem/math/MinMax.h>
 
+#include "architectures/VirtualMemory.h"
+
+#include "kernel/interrupts/Interupts.h"
 #include "kernel/node/File.h"
 #include "kernel/node/Handle.h"
 
 FsFile::FsFile() : FsNode(FILE_TYPE_REGULAR)
 {
-    _buffer = (char *)malloc(512);
-    _buffer_allocated = 512;
-    _buffer_size = 0;
 }
 
 FsFile::~FsFile()
 {
-    free(_buffer);
+    truncate();
+}
+
+static FsFileExtent extent_create(size_t offset, size_t size)
+{
+    InterruptsRetainer retainer;
+
+    auto object = memory_object_create(size);
+
+    auto data = reinterpret_cast<char *>(
+        arch_virtual_alloc(arch_kernel_address_space(), object->range(), MEMORY_NONE).base());
+
+    memset(data, 0, object->range().size());
+
+    return {object, data, offset, object->range().size()};
+}
+
+static void extent_destroy(FsFileExtent &extent)
+{
+    InterruptsRetainer retainer;
+
+    arch_virtual_free(arch_kernel_address_space(), (MemoryRange){(uintptr_t)extent.data, extent.object->range().size()});
+    memory_object_deref(extent.object);
+}
+
+// Each new extent is at least as big as everything allocated before it, so
+// a file written in small chunks only needs a logarithmic number of them
+// and the existing content is never copied.
+void FsFile::grow(size_t capacity)
+{
+    if (capacity <= _allocated)
+    {
+        return;
+    }
+
+    size_t extent_size = PAGE_ALIGN_UP(MAX(capacity - _allocated, _allocated));
+
+    _extents.push_back(extent_create(_allocated, extent_size));
+    _allocated += _extents.peek_back().size;
+}
+
+// Mappings need the whole file in a single memory object.
+void FsFile::compact()
+{
+    if (_extents.count() <= 1)
+    {
+        return;
+    }
+
+    auto extent = extent_create(0, PAGE_ALIGN_UP(_size));
+
+    foreach_extent(0, _size, [&](char *data, size_t offset, size_t size) {
+        memcpy(extent.data + offset, data, size);
+    });
+
+    truncate();
+
+    _extents.push_back(extent);
+    _allocated = extent.size;
+}
+
+void FsFile::truncate()
+{
+    for (size_t i = 0; i < _extents.count(); i++)
+    {
+        extent_destroy(_extents[i]);
+    }
+
+    _extents.clear();
+    _allocated = 0;
+}
+
+template <typename TCallback>
+void FsFile::foreach_extent(size_t offset, size_t size, TCallback callback)
+{
+    size_t end = offset + size;
+
+    for (size_t i = 0; i < _extents.count() && offset < end; i++)
+    {
+        auto &extent = _extents[i];
+
+        if (offset >= extent.offset + extent.size)
+        {
+            continue;
+        }
+
+        size_t in_extent = offset - extent.offset;
+        size_t chunk = MIN(extent.size - in_extent, end - offset);
+
+        callback(extent.data + in_extent, offset, chunk);
+
+        offset += chunk;
+    }
 }
 
 Result FsFile::open(FsHandle *handle)
 {
     if (handle->has_flag(OPEN_TRUNC))
     {
-        free(_buffer);
-        _buffer = (char *)malloc(512);
-        _buffer_allocated = 512;
-        _buffer_size = 0;
+        truncate();
+        _size = 0;
     }
 
     return SUCCESS;
@@ -34,17 +123,20 @@ Result FsFile::open(FsHandle *handle)
 
 size_t FsFile::size()
 {
-    return _buffer_size;
+    return _size;
 }
 
 ResultOr<size_t> FsFile::read(FsHandle &handle, void *buffer, size_t size)
 {
     size_t read = 0;
 
-    if (handle.offset() <= _buffer_size)
+    if (handle.offset() <= _size)
     {
-        read = MIN(_buffer_size - handle.offset(), size);
-        memcpy(buffer, (char *)_buffer + handle.offset(), read);
+        read = MIN(_size - handle.offset(), size);
+
+        foreach_extent(handle.offset(), read, [&](char *data, size_t offset, size_t size) {
+            memcpy((char *)buffer + (offset - handle.offset()), data, size);
+        });
     }
 
     return read;
@@ -52,14 +144,32 @@ ResultOr<size_t> FsFile::read(FsHandle &handle, void *buffer, size_t size)
 
 ResultOr<size_t> FsFile::write(FsHandle &handle, const void *buffer, size_t size)
 {
-    if ((handle.offset() + size) > _buffer_allocated)
+    grow(handle.offset() + size);
+
+    foreach_extent(handle.offset(), size, [&](char *data, size_t offset, size_t size) {
+        memcpy(data, (const char *)buffer + (offset - handle.offset()), size);
+    });
+
+    _size = MAX(handle.offset() + size, _size);
+
+    return size;
+}
+
+ResultOr<MemoryObject *> FsFile::mmap(FsHandle &handle)
+{
+    __unused(handle);
+
+    // There is nothing to map, but an empty file is still a file.
+    if (_size == 0)
     {
-        _buffer = (char *)realloc(_buffer, handle.offset() + size);
-        _buffer_allocated = handle.offset() + size;
+        return nullptr;
     }
 
-    _buffer_size = MAX(handle.offset() + size, _buffer_size);
-    memcpy((char *)(_buffer) + handle.offset(), buffer, size);
+    compact();
 
-    return size;
+    // The object is handed out to other processes through its handle,
+    // they should not be able to write to the file behind our back.
+    _extents[0].object->readonly = true;
+
+    return memory_object_ref(_extents[0].object);
 }
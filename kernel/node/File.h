@@ -1,13 +1,33 @@
 #pragma once
 
+#include <libutils/Vector.h>
+
+#include "kernel/memory/MemoryObject.h"
 #include "kernel/node/Node.h"
 
+struct FsFileExtent
+{
+    MemoryObject *object;
+    char *data;
+    size_t offset;
+    size_t size;
+};
+
 class FsFile : public FsNode
 {
 private:
-    char *_buffer;
-    size_t _buffer_allocated;
-    size_t _buffer_size;
+    Vector<FsFileExtent> _extents{};
+    size_t _allocated = 0;
+    size_t _size = 0;
+
+    void grow(size_t capacity);
+
+    void compact();
+
+    void truncate();
+
+    template <typename TCallback>
+    void foreach_extent(size_t offset, size_t size, TCallback callback);
 
 public:
     FsFile();
@@ -21,4 +41,6 @@ public:
     ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
 
     ResultOr<size_t> write(FsHandle &handle, const void *buffer, size_t size) override;
+
+    ResultOr<MemoryObject *> mmap(FsHandle &handle) override;
 };
@@ -4,6 +4,7 @@
 #include <libsystem/Result.h>
 #include <libsystem/core/CString.h>
 #include <libsystem/math/MinMax.h>
+#include <libsystem/trace/Trace.h>
 
 #include "kernel/node/Connection.h"
 #include "kernel/node/Handle.h"
@@ -100,6 +101,8 @@ ResultOr<size_t> FsHandle::read(void *buffer, size_t size)
         return ERR_WRITE_ONLY_STREAM;
     }
 
+    TRACE_SCOPE("read", size);
+
     task_block(scheduler_running(), new BlockerRead(this), -1);
 
     auto result_or_read = _node->read(*this, buffer, size);
@@ -123,6 +126,8 @@ ResultOr<size_t> FsHandle::write(const void *buffer, size_t size)
         return ERR_READ_ONLY_STREAM;
     }
 
+    TRACE_SCOPE("write", size);
+
     auto attemp_a_write = [&](const void *buffer, size_t size) {
         task_block(scheduler_running(), new BlockerWrite(this), -1);
 
@@ -247,6 +252,20 @@ Result FsHandle::stat(FileState *stat)
     return SUCCESS;
 }
 
+ResultOr<MemoryObject *> FsHandle::mmap()
+{
+    if (!has_flag(OPEN_READ))
+    {
+        return ERR_WRITE_ONLY_STREAM;
+    }
+
+    _node->acquire(scheduler_running_id());
+    auto result_or_memory_object = _node->mmap(*this);
+    _node->release(scheduler_running_id());
+
+    return result_or_memory_object;
+}
+
 ResultOr<FsHandle *> FsHandle::accept()
 {
     task_block(scheduler_running(), new BlockerAccept(_node), -1);
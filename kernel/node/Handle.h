@@ -48,5 +48,7 @@ public:
 
     Result stat(FileState *stat);
 
+    ResultOr<MemoryObject *> mmap();
+
     ResultOr<FsHandle *> accept();
 };
@@ -9,6 +9,7 @@
 
 struct FsNode;
 struct FsHandle;
+struct MemoryObject;
 
 struct FsNode : public RefCounted<FsNode>
 {
@@ -99,6 +100,14 @@ public:
         return ERR_NOT_WRITABLE;
     }
 
+    // Return a referenced memory object holding the content of the node.
+    virtual ResultOr<MemoryObject *> mmap(FsHandle &handle)
+    {
+        __unused(handle);
+
+        return ERR_OPERATION_NOT_SUPPORTED;
+    }
+
     virtual RefPtr<FsNode> find(String name)
     {
         __unused(name);
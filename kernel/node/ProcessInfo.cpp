@@ -10,37 +10,51 @@
 #include "kernel/node/Handle.h"
 #include "kernel/node/ProcessInfo.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Statistics.h"
 #include "kernel/tasking/Task-Memory.h"
 
 FsProcessInfo::FsProcessInfo() : FsNode(FILE_TYPE_DEVICE)
 {
 }
 
-static Iteration serialize_task(json::Array *list, Task *task)
+static void serialize_task(json::Array &list, const TaskStatistics &task)
 {
-    if (task->id == 0)
-        return Iteration::CONTINUE;
-
     json::Object task_object{};
 
-    task_object["id"] = task->id;
-    task_object["name"] = task->name;
-    task_object["state"] = task_state_string(task->state());
+    task_object["id"] = task.id;
+    task_object["name"] = task.name;
+    task_object["state"] = task_state_string(task.state);
     task_object["directory"] = "";
-    task_object["cpu"] = scheduler_get_usage(task->id);
-    task_object["ram"] = (int)task_memory_usage(task);
-    task_object["user"] = task->user;
-
-    list->push_back(move(task_object));
-
-    return Iteration::CONTINUE;
+    task_object["cpu"] = (int)task.cpu_usage;
+    task_object["ram"] = (int)task.resident_memory;
+    task_object["user"] = task.user;
+    task_object["cpu_time"] = (int)task.cpu_time;
+    task_object["wait_time"] = (int)task.wait_time;
+    task_object["switches"] = (int)task.context_switches;
+    task_object["handles"] = task.handles;
+
+    list.push_back(move(task_object));
 }
 
 Result FsProcessInfo::open(FsHandle *handle)
 {
     json::Array list{};
 
-    task_iterate(&list, (TaskIterateCallback)serialize_task);
+    {
+        InterruptsRetainer retainer;
+
+        auto *stats = statistics();
+
+        for (size_t i = 0; i < STATISTICS_TASK_COUNT; i++)
+        {
+            auto &task = stats->tasks[i];
+
+            if (task.used && task.id != 0)
+            {
+                serialize_task(list, task);
+            }
+        }
+    }
 
     handle->attached = json::stringify(move(list)).underlying_storage().give_ref();
     handle->attached_size = reinterpret_cast<StringStorage *>(handle->attached)->length();
@@ -66,6 +80,25 @@ ResultOr<size_t> FsProcessInfo::read(FsHandle &handle, void *buffer, size_t size
     return read;
 }
 
+Result FsProcessInfo::call(FsHandle &handle, IOCall request, void *args)
+{
+    __unused(handle);
+
+    if (request == IOCALL_STATISTICS_MAP)
+    {
+        auto map = (IOCallStatisticsMapArgs *)args;
+
+        auto mapping = task_memory_mapping_create(scheduler_running(), statistics_memory_object(), MEMORY_READONLY);
+
+        map->address = mapping->address;
+        map->size = sizeof(SystemStatistics);
+
+        return SUCCESS;
+    }
+
+    return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+}
+
 void process_info_initialize()
 {
     filesystem_link(Path::parse("/System/processes"), make<FsProcessInfo>());
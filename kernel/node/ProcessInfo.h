@@ -13,6 +13,8 @@ public:
     void close(FsHandle *handle) override;
 
     ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
+
+    Result call(FsHandle &handle, IOCall request, void *args) override;
 };
 
 void process_info_initialize();
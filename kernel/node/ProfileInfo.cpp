@@ -0,0 +1,110 @@
+#include <libsystem/Result.h>
+#include <libsystem/math/MinMax.h>
+
+#include "kernel/filesystem/Filesystem.h"
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/node/Handle.h"
+#include "kernel/node/ProfileInfo.h"
+#include "kernel/system/Profiler.h"
+#include "kernel/tasking/Syscalls.h"
+
+FsProfileInfo::FsProfileInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+// The buffer of the task being profiled belongs to the handle that started
+// it, so samples can still be read once the task is gone.
+void FsProfileInfo::close(FsHandle *handle)
+{
+    auto buffer = reinterpret_cast<ProfileBuffer *>(handle->attached);
+
+    if (buffer)
+    {
+        profiler_stop(buffer);
+        free(buffer);
+    }
+}
+
+Result FsProfileInfo::call(FsHandle &handle, IOCall request, void *args)
+{
+    auto buffer = reinterpret_cast<ProfileBuffer *>(handle.attached);
+
+    if (request == IOCALL_PROFILE_START)
+    {
+        auto start = (IOCallProfileStartArgs *)args;
+
+        if (buffer)
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        buffer = profiler_start(start->pid);
+
+        if (!buffer)
+        {
+            return ERR_NO_SUCH_TASK;
+        }
+
+        handle.attached = buffer;
+
+        return SUCCESS;
+    }
+
+    if (!buffer)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (request == IOCALL_PROFILE_STOP)
+    {
+        profiler_stop(buffer);
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_PROFILE_READ)
+    {
+        auto read = (IOCallProfileReadArgs *)args;
+
+        if (!syscall_validate_ptr((uintptr_t)read->samples, read->count * sizeof(ProfileSample)))
+        {
+            return ERR_BAD_ADDRESS;
+        }
+
+        // Checked first, so nothing sampled before the task exited is missed.
+        read->running = profiler_running(buffer);
+        read->read = profiler_read(buffer, read->samples, read->count);
+
+        InterruptsRetainer retainer;
+        read->lost = buffer->lost;
+        buffer->lost = 0;
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_PROFILE_MODULES)
+    {
+        auto modules = (IOCallProfileModulesArgs *)args;
+
+        if (!syscall_validate_ptr((uintptr_t)modules->modules, modules->count * sizeof(ProfileModule)))
+        {
+            return ERR_BAD_ADDRESS;
+        }
+
+        InterruptsRetainer retainer;
+
+        modules->read = MIN(modules->count, buffer->module_count);
+
+        for (size_t i = 0; i < modules->read; i++)
+        {
+            modules->modules[i] = buffer->modules[i];
+        }
+
+        return SUCCESS;
+    }
+
+    return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+}
+
+void profile_info_initialize()
+{
+    filesystem_link(Path::parse(PROFILE_PATH), make<FsProfileInfo>());
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "kernel/node/Node.h"
+
+class FsProfileInfo : public FsNode
+{
+private:
+public:
+    FsProfileInfo();
+
+    void close(FsHandle *handle) override;
+
+    Result call(FsHandle &handle, IOCall request, void *args) override;
+};
+
+void profile_info_initialize();
@@ -0,0 +1,143 @@
+#include <libsystem/Result.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/StringBuilder.h>
+
+#include "kernel/filesystem/Filesystem.h"
+#include "kernel/node/Handle.h"
+#include "kernel/node/TraceInfo.h"
+#include "kernel/system/Statistics.h"
+#include "kernel/tasking/Syscalls.h"
+
+FsTraceInfo::FsTraceInfo() : FsNode(FILE_TYPE_DEVICE)
+{
+}
+
+StringStorage *FsTraceInfo::format_log()
+{
+    StringBuilder builder{TRACE_RING_SIZE * 128};
+
+    TraceCursor cursor = {};
+    TraceRecord record;
+    char line[512];
+
+    while (trace_log_ring().next(cursor, record))
+    {
+        size_t length = trace_format(record, line, 512);
+        builder.append(line, length);
+    }
+
+    if (cursor.lost > 0)
+    {
+        snprintf(line, 512, "(%d older records were overwritten)\n", (int)cursor.lost);
+        builder.append(line);
+    }
+
+    return builder.finalize().underlying_storage().give_ref();
+}
+
+Result FsTraceInfo::open(FsHandle *handle)
+{
+    // Records are only formatted when someone reads them, processes open
+    // this node to record events too.
+    handle->attached = nullptr;
+    handle->attached_size = 0;
+
+    return SUCCESS;
+}
+
+void FsTraceInfo::close(FsHandle *handle)
+{
+    deref_if_not_null(reinterpret_cast<StringStorage *>(handle->attached));
+}
+
+ResultOr<size_t> FsTraceInfo::read(FsHandle &handle, void *buffer, size_t size)
+{
+    if (handle.attached == nullptr)
+    {
+        handle.attached = format_log();
+        handle.attached_size = reinterpret_cast<StringStorage *>(handle.attached)->length();
+    }
+
+    size_t read = 0;
+
+    if (handle.offset() <= handle.attached_size)
+    {
+        read = MIN(handle.attached_size - handle.offset(), size);
+        memcpy(buffer, reinterpret_cast<StringStorage *>(handle.attached)->cstring() + handle.offset(), read);
+    }
+
+    return read;
+}
+
+Result FsTraceInfo::call(FsHandle &handle, IOCall request, void *args)
+{
+    __unused(handle);
+
+    if (request == IOCALL_TRACE_START)
+    {
+        _capture = {trace_ring().head(), 0};
+
+        trace_enable(true);
+        statistics_did_change_tracing(true);
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_TRACE_STOP)
+    {
+        trace_enable(false);
+        statistics_did_change_tracing(false);
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_TRACE_RECORD)
+    {
+        auto record = (IOCallTraceRecordArgs *)args;
+
+        if (record->kind != TRACE_BEGIN &&
+            record->kind != TRACE_END &&
+            record->kind != TRACE_INSTANT)
+        {
+            return ERR_INVALID_ARGUMENT;
+        }
+
+        if (trace_enabled())
+        {
+            record->name[TRACE_NAME_SIZE - 1] = '\0';
+            trace_event(record->kind, record->name, record->argument);
+        }
+
+        return SUCCESS;
+    }
+    else if (request == IOCALL_TRACE_READ)
+    {
+        auto read = (IOCallTraceReadArgs *)args;
+
+        if (!syscall_validate_ptr((uintptr_t)read->events, read->count * sizeof(TraceEvent)))
+        {
+            return ERR_BAD_ADDRESS;
+        }
+
+        read->read = 0;
+
+        TraceRecord record;
+        size_t lost = _capture.lost;
+
+        while (read->read < read->count && trace_ring().next(_capture, record))
+        {
+            trace_unpack(record, read->events[read->read]);
+            read->read++;
+        }
+
+        read->lost = _capture.lost - lost;
+
+        return SUCCESS;
+    }
+
+    return ERR_INAPPROPRIATE_CALL_FOR_DEVICE;
+}
+
+void trace_info_initialize()
+{
+    filesystem_link(Path::parse("/System/trace"), make<FsTraceInfo>());
+}
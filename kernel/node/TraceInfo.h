@@ -0,0 +1,27 @@
+#pragma once
+
+#include <libsystem/trace/Trace.h>
+
+#include "kernel/node/Node.h"
+
+class FsTraceInfo : public FsNode
+{
+private:
+    // There is a single capture going at once, events go to whoever reads.
+    TraceCursor _capture = {};
+
+    StringStorage *format_log();
+
+public:
+    FsTraceInfo();
+
+    Result open(FsHandle *handle) override;
+
+    void close(FsHandle *handle) override;
+
+    ResultOr<size_t> read(FsHandle &handle, void *buffer, size_t size) override;
+
+    Result call(FsHandle &handle, IOCall request, void *args) override;
+};
+
+void trace_info_initialize();
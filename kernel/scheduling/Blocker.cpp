@@ -1,3 +1,4 @@
+#include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/tasking/Task.h"
 
@@ -23,6 +24,85 @@ bool BlockerConnect::can_unblock(struct Task *task)
     return _connection->is_accepted();
 }
 
+/* --- BlockerFutex --------------------------------------------------------- */
+
+// Blockers get deleted by the task they block once it is unblocked, or by
+// task_destroy() if it got canceled, so they are only looked up from here
+// while they are waiting.
+static List *_futex_blockers = nullptr;
+
+BlockerFutex::BlockerFutex(void *address_space, uintptr_t address)
+    : _address_space(address_space), _address(address)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    if (_futex_blockers == nullptr)
+    {
+        _futex_blockers = list_create();
+    }
+
+    list_pushback(_futex_blockers, this);
+}
+
+size_t BlockerFutex::wake(void *address_space, uintptr_t address, size_t count)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    if (_futex_blockers == nullptr)
+    {
+        return 0;
+    }
+
+    size_t woken = 0;
+
+    list_foreach(BlockerFutex, blocker, _futex_blockers)
+    {
+        if (woken == count)
+        {
+            break;
+        }
+
+        if (!blocker->_woken &&
+            blocker->_address_space == address_space &&
+            blocker->_address == address)
+        {
+            blocker->_woken = true;
+            woken++;
+        }
+    }
+
+    return woken;
+}
+
+bool BlockerFutex::can_unblock(Task *task)
+{
+    __unused(task);
+
+    return _woken;
+}
+
+void BlockerFutex::on_unblock(Task *task)
+{
+    __unused(task);
+
+    list_remove(_futex_blockers, this);
+}
+
+void BlockerFutex::on_timeout(Task *task)
+{
+    __unused(task);
+
+    list_remove(_futex_blockers, this);
+}
+
+void BlockerFutex::on_cancel(Task *task)
+{
+    __unused(task);
+
+    // Might already be gone if the task was woken up before being canceled.
+    list_remove(_futex_blockers, this);
+}
+
 /* --- BlockerRead ---------------------------------------------------------- */
 
 bool BlockerRead::can_unblock(Task *task)
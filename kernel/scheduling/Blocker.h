@@ -35,6 +35,13 @@ struct Blocker
     {
         __unused(task);
     }
+
+    // The task got canceled while blocked, it will never come back to
+    // task_block(), so the blocker is deleted by task_destroy().
+    virtual void on_cancel(struct Task *task)
+    {
+        __unused(task);
+    }
 };
 
 class BlockerAccept : public Blocker
@@ -66,6 +73,29 @@ public:
     bool can_unblock(struct Task *task);
 };
 
+class BlockerFutex : public Blocker
+{
+private:
+    void *_address_space;
+    uintptr_t _address;
+    bool _woken = false;
+
+public:
+    BlockerFutex(void *address_space, uintptr_t address);
+
+    // Returns how many tasks were woken up, the ones waiting the longest
+    // go first.
+    static size_t wake(void *address_space, uintptr_t address, size_t count);
+
+    bool can_unblock(Task *task);
+
+    void on_unblock(Task *task);
+
+    void on_timeout(Task *task);
+
+    void on_cancel(Task *task);
+};
+
 class BlockerRead : public Blocker
 {
 private:
@@ -1,13 +1,15 @@
 
+#include <libsystem/trace/Trace.h>
+
 #include "architectures/Architectures.h"
 #include "architectures/VirtualMemory.h"
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Statistics.h"
 #include "kernel/system/System.h"
 
 static bool scheduler_context_switch = false;
-static int scheduler_record[SCHEDULER_RECORD_COUNT] = {};
 
 static Task *running = nullptr;
 static Task *idle = nullptr;
@@ -88,17 +90,14 @@ int scheduler_get_usage(int task_id)
 {
     InterruptsRetainer retainer;
 
-    int count = 0;
+    Task *task = task_by_id(task_id);
 
-    for (int i = 0; i < SCHEDULER_RECORD_COUNT; i++)
+    if (task == nullptr || task->statistics == nullptr)
     {
-        if (scheduler_record[i] == task_id)
-        {
-            count++;
-        }
+        return 0;
     }
 
-    return (count * 100) / SCHEDULER_RECORD_COUNT;
+    return task->statistics->cpu_usage;
 }
 
 static Iteration wakeup_task_if_unblocked(void *target, Task *task)
@@ -131,7 +130,7 @@ uintptr_t schedule(uintptr_t current_stack_pointer)
     running->kernel_stack_pointer = current_stack_pointer;
     arch_save_context(running);
 
-    scheduler_record[system_get_tick() % SCHEDULER_RECORD_COUNT] = running->id;
+    Task *previous = running;
 
     list_iterate(blocked_tasks, nullptr, (ListIterationCallback)wakeup_task_if_unblocked);
 
@@ -142,6 +141,13 @@ uintptr_t schedule(uintptr_t current_stack_pointer)
         running = idle;
     }
 
+    statistics_did_schedule(previous, running);
+
+    if (previous != running)
+    {
+        trace_instant("switch", previous->id);
+    }
+
     arch_address_space_switch(running->address_space);
     arch_load_context(running);
 
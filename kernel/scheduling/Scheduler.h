@@ -2,8 +2,6 @@
 
 #include "kernel/tasking/Task.h"
 
-#define SCHEDULER_RECORD_COUNT 1000
-
 void scheduler_initialize();
 
 void scheduler_did_create_idle_task(Task *task);
@@ -1,3 +1,5 @@
+#include <libsystem/Logger.h>
+
 #include "architectures/Architectures.h"
 
 #include "kernel/graphics/EarlyConsole.h"
@@ -70,6 +72,9 @@ void system_panic_internal(
 
     if (!has_panic)
     {
+        // Whatever the logger has not written out yet is what led here.
+        logger_flush();
+
         has_panic = true;
         printf("\n\e[0;33m--- \e[0;31m!!!\e[0;33m ------------------------------------------------------------------------\e[0m\n");
         printf("\n\tKERNEL");
@@ -0,0 +1,135 @@
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+
+#include "architectures/Architectures.h"
+#include "architectures/VirtualMemory.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
+
+static void profiler_push_module(ProfileBuffer *buffer, const ProfileModule &module)
+{
+    if (buffer->module_count < PROFILE_MODULE_COUNT)
+    {
+        buffer->modules[buffer->module_count] = module;
+        buffer->module_count++;
+    }
+}
+
+ProfileBuffer *profiler_start(int pid)
+{
+    InterruptsRetainer retainer;
+
+    Task *task = task_by_id(pid);
+
+    // Threads are profiled through their process.
+    if (task == nullptr || !task->user || task->process != task || task->profile != nullptr)
+    {
+        return nullptr;
+    }
+
+    auto buffer = __create(ProfileBuffer);
+    buffer->pid = pid;
+
+    // The program and its libraries are usually loaded by now.
+    list_foreach(ProfileModule, module, task->modules)
+    {
+        profiler_push_module(buffer, *module);
+    }
+
+    task->profile = buffer;
+
+    return buffer;
+}
+
+void profiler_stop(ProfileBuffer *buffer)
+{
+    InterruptsRetainer retainer;
+
+    Task *task = task_by_id(buffer->pid);
+
+    if (task != nullptr && task->profile == buffer)
+    {
+        task->profile = nullptr;
+    }
+}
+
+bool profiler_running(ProfileBuffer *buffer)
+{
+    InterruptsRetainer retainer;
+
+    Task *task = task_by_id(buffer->pid);
+
+    return task != nullptr &&
+           task->profile == buffer &&
+           task->state() != TASK_STATE_CANCELED;
+}
+
+size_t profiler_read(ProfileBuffer *buffer, ProfileSample *samples, size_t count)
+{
+    InterruptsRetainer retainer;
+
+    size_t read = 0;
+
+    while (read < count && buffer->tail != buffer->head)
+    {
+        samples[read] = buffer->samples[buffer->tail % PROFILE_BUFFER_SIZE];
+        buffer->tail++;
+        read++;
+    }
+
+    return read;
+}
+
+void profiler_sample(void *stackframe)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    Task *task = scheduler_running();
+
+    // The threads of a process are profiled along with it.
+    if (task == nullptr || task->process->profile == nullptr)
+    {
+        return;
+    }
+
+    ProfileBuffer *buffer = task->process->profile;
+
+    if (buffer->head - buffer->tail == PROFILE_BUFFER_SIZE)
+    {
+        buffer->lost++;
+        return;
+    }
+
+    ProfileSample &sample = buffer->samples[buffer->head % PROFILE_BUFFER_SIZE];
+
+    sample.task = task->id;
+    sample.depth = arch_sample_stack(stackframe, task->address_space, sample.frames, PROFILE_DEPTH);
+    sample.kernel = 0;
+
+    // Only the kernel is mapped in the kernel address space.
+    while (sample.kernel < sample.depth &&
+           arch_virtual_present(arch_kernel_address_space(), sample.frames[sample.kernel]))
+    {
+        sample.kernel++;
+    }
+
+    buffer->head++;
+}
+
+void profiler_did_load_module(Task *task, const char *path, uintptr_t base)
+{
+    InterruptsRetainer retainer;
+
+    ProfileModule module = {};
+    module.base = base;
+    strlcpy(module.path, path, PATH_LENGTH);
+
+    list_pushback_copy(task->modules, &module, sizeof(ProfileModule));
+
+    if (task->process->profile)
+    {
+        profiler_push_module(task->process->profile, module);
+    }
+}
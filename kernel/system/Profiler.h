@@ -0,0 +1,35 @@
+#pragma once
+
+#include <abi/Profile.h>
+
+#include "kernel/tasking/Task.h"
+
+// Samples taken between two reads, a second's worth at the timer frequency.
+#define PROFILE_BUFFER_SIZE 1024
+
+// Filled by the timer interrupt while the task it belongs to is running,
+// and drained by whoever started the profile.
+struct ProfileBuffer
+{
+    int pid;
+
+    size_t head;
+    size_t tail;
+    size_t lost;
+    ProfileSample samples[PROFILE_BUFFER_SIZE];
+
+    size_t module_count;
+    ProfileModule modules[PROFILE_MODULE_COUNT];
+};
+
+ProfileBuffer *profiler_start(int pid);
+
+void profiler_stop(ProfileBuffer *buffer);
+
+bool profiler_running(ProfileBuffer *buffer);
+
+size_t profiler_read(ProfileBuffer *buffer, ProfileSample *samples, size_t count);
+
+void profiler_sample(void *stackframe);
+
+void profiler_did_load_module(Task *task, const char *path, uintptr_t base);
@@ -0,0 +1,229 @@
+#include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+
+#include "architectures/VirtualMemory.h"
+
+#include "kernel/interrupts/Interupts.h"
+#include "kernel/system/Statistics.h"
+#include "kernel/system/System.h"
+
+static MemoryObject *_statistics_memory_object = nullptr;
+static SystemStatistics *_statistics = nullptr;
+
+static uint32_t _last_accounted_tick = 0;
+
+// Every write to the page is wrapped between two increments of the
+// sequence number, readers retry when it changed under their feet.
+static void begin_update()
+{
+    __atomic_add_fetch(&_statistics->sequence, 1, __ATOMIC_RELEASE);
+}
+
+static void end_update()
+{
+    __atomic_add_fetch(&_statistics->sequence, 1, __ATOMIC_RELEASE);
+}
+
+void statistics_initialize()
+{
+    InterruptsRetainer retainer;
+
+    _statistics_memory_object = memory_object_create(sizeof(SystemStatistics));
+
+    _statistics = reinterpret_cast<SystemStatistics *>(
+        arch_virtual_alloc(
+            arch_kernel_address_space(),
+            _statistics_memory_object->range(),
+            MEMORY_NONE)
+            .base());
+
+    memset(_statistics, 0, _statistics_memory_object->range().size());
+
+    _statistics->magic = STATISTICS_MAGIC;
+    _statistics->version = STATISTICS_VERSION;
+
+    logger_info("Statistics page is %uKio", _statistics_memory_object->range().size() / 1024);
+}
+
+SystemStatistics *statistics()
+{
+    return _statistics;
+}
+
+MemoryObject *statistics_memory_object()
+{
+    return _statistics_memory_object;
+}
+
+void statistics_did_create_task(Task *task)
+{
+    InterruptsRetainer retainer;
+
+    for (size_t i = 0; i < STATISTICS_TASK_COUNT; i++)
+    {
+        auto &entry = _statistics->tasks[i];
+
+        if (!entry.used)
+        {
+            begin_update();
+
+            memset(&entry, 0, sizeof(TaskStatistics));
+            entry.used = true;
+            entry.user = task->user;
+            entry.id = task->id;
+            entry.state = task->_state;
+            strlcpy(entry.name, task->name, PROCESS_NAME_SIZE);
+
+            _statistics->task_count++;
+
+            end_update();
+
+            task->statistics = &entry;
+            return;
+        }
+    }
+
+    logger_warn("No statistics slot left for task %d", task->id);
+}
+
+void statistics_did_destroy_task(Task *task)
+{
+    InterruptsRetainer retainer;
+
+    if (!task->statistics)
+    {
+        return;
+    }
+
+    begin_update();
+
+    task->statistics->used = false;
+    _statistics->task_count--;
+
+    end_update();
+
+    task->statistics = nullptr;
+}
+
+void statistics_did_change_task_state(Task *task, TaskState oldstate, TaskState newstate)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    if (!task->statistics)
+    {
+        return;
+    }
+
+    begin_update();
+
+    if (oldstate == TASK_STATE_BLOCKED)
+    {
+        task->statistics->wait_time += system_get_tick() - task->blocked_since;
+    }
+
+    if (newstate == TASK_STATE_BLOCKED)
+    {
+        task->blocked_since = system_get_tick();
+    }
+
+    task->statistics->state = newstate;
+
+    end_update();
+}
+
+static Iteration publish_task_usage(void *target, Task *task)
+{
+    __unused(target);
+
+    if (task->statistics)
+    {
+        task->statistics->cpu_usage = (task->usage_ticks * 100) / STATISTICS_USAGE_WINDOW;
+    }
+
+    task->usage_ticks = 0;
+
+    return Iteration::CONTINUE;
+}
+
+void statistics_did_schedule(Task *previous, Task *next)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    uint32_t tick = system_get_tick();
+
+    begin_update();
+
+    // The ticks elapsed since the last schedule are charged to the task
+    // that was running, yields in the middle of a tick are free.
+    if (tick != _last_accounted_tick)
+    {
+        uint32_t elapsed = tick - _last_accounted_tick;
+
+        if (previous->statistics)
+        {
+            previous->statistics->cpu_time += elapsed;
+        }
+
+        previous->usage_ticks += elapsed;
+
+        if (tick / STATISTICS_USAGE_WINDOW != _last_accounted_tick / STATISTICS_USAGE_WINDOW)
+        {
+            task_iterate(nullptr, publish_task_usage);
+        }
+
+        _last_accounted_tick = tick;
+        _statistics->tick = tick;
+    }
+
+    if (previous != next && next->statistics)
+    {
+        next->statistics->context_switches++;
+    }
+
+    end_update();
+}
+
+void statistics_did_map_memory(Task *task, size_t size)
+{
+    InterruptsRetainer retainer;
+
+    if (task->statistics)
+    {
+        begin_update();
+        task->statistics->resident_memory += size;
+        end_update();
+    }
+}
+
+void statistics_did_unmap_memory(Task *task, size_t size)
+{
+    InterruptsRetainer retainer;
+
+    if (task->statistics)
+    {
+        begin_update();
+        task->statistics->resident_memory -= size;
+        end_update();
+    }
+}
+
+void statistics_did_change_handles(Task *task, int delta)
+{
+    InterruptsRetainer retainer;
+
+    if (task->statistics)
+    {
+        begin_update();
+        task->statistics->handles += delta;
+        end_update();
+    }
+}
+
+void statistics_did_change_tracing(bool tracing)
+{
+    InterruptsRetainer retainer;
+
+    begin_update();
+    _statistics->tracing = tracing;
+    end_update();
+}
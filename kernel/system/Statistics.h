@@ -0,0 +1,28 @@
+#pragma once
+
+#include <abi/Statistics.h>
+
+#include "kernel/memory/MemoryObject.h"
+#include "kernel/tasking/Task.h"
+
+void statistics_initialize();
+
+SystemStatistics *statistics();
+
+MemoryObject *statistics_memory_object();
+
+void statistics_did_create_task(Task *task);
+
+void statistics_did_destroy_task(Task *task);
+
+void statistics_did_change_task_state(Task *task, TaskState oldstate, TaskState newstate);
+
+void statistics_did_schedule(Task *previous, Task *next);
+
+void statistics_did_map_memory(Task *task, size_t size);
+
+void statistics_did_unmap_memory(Task *task, size_t size);
+
+void statistics_did_change_handles(Task *task, int delta);
+
+void statistics_did_change_tracing(bool tracing);
@@ -27,6 +27,31 @@ void system_stop()
 
 static uint32_t _system_tick;
 
+// The cycle counter is measured against the timer once it has settled, to
+// give timestamps finer than a tick.
+#define CLOCK_CALIBRATION_START 100
+#define CLOCK_CALIBRATION_LENGTH 100
+
+static uint64_t _clock_start_cycles = 0;
+static uint64_t _clock_cycles_per_microsecond = 0;
+
+static void system_calibrate_clock()
+{
+    if (_system_tick == CLOCK_CALIBRATION_START)
+    {
+        _clock_start_cycles = arch_get_cycles();
+    }
+    else if (_system_tick == CLOCK_CALIBRATION_START + CLOCK_CALIBRATION_LENGTH)
+    {
+        uint64_t elapsed = arch_get_cycles() - _clock_start_cycles;
+        uint64_t cycles_per_microsecond = elapsed / (CLOCK_CALIBRATION_LENGTH * 1000);
+
+        __atomic_store_n(&_clock_cycles_per_microsecond, cycles_per_microsecond, __ATOMIC_RELEASE);
+
+        logger_info("Cycle counter runs at %uMHz", (uint32_t)cycles_per_microsecond);
+    }
+}
+
 void system_tick()
 {
     if (_system_tick + 1 < _system_tick)
@@ -35,6 +60,11 @@ void system_tick()
     }
 
     _system_tick++;
+
+    if (_system_tick <= CLOCK_CALIBRATION_START + CLOCK_CALIBRATION_LENGTH)
+    {
+        system_calibrate_clock();
+    }
 }
 
 uint32_t system_get_tick()
@@ -42,6 +72,21 @@ uint32_t system_get_tick()
     return _system_tick;
 }
 
+uint64_t system_clock_microseconds()
+{
+    uint64_t cycles_per_microsecond = __atomic_load_n(&_clock_cycles_per_microsecond, __ATOMIC_ACQUIRE);
+
+    if (cycles_per_microsecond == 0)
+    {
+        // Not calibrated yet, or the counter is too slow to be of any help.
+        return (uint64_t)_system_tick * 1000;
+    }
+
+    uint64_t elapsed = arch_get_cycles() - _clock_start_cycles;
+
+    return CLOCK_CALIBRATION_START * 1000 + elapsed / cycles_per_microsecond;
+}
+
 static TimeStamp _system_boot_timestamp = 0;
 
 ElapsedTime system_get_uptime()
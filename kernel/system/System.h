@@ -17,6 +17,9 @@ void system_tick();
 
 uint32_t system_get_tick();
 
+// Microseconds since boot, as precise as the cycle counter allows.
+uint64_t system_clock_microseconds();
+
 ElapsedTime system_get_uptime();
 
 #define system_panic(__args...) \
@@ -3,6 +3,7 @@
 #include <libsystem/Logger.h>
 #include <libsystem/Result.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/trace/Trace.h>
 
 #include "architectures/Architectures.h"
 
@@ -107,7 +108,8 @@ Result hj_process_clone(int *pid)
 
 Result hj_process_exit(int exit_code)
 {
-    scheduler_running()->cancel(exit_code);
+    // From any of its threads, the whole process exits.
+    scheduler_running()->process->cancel(exit_code);
     ASSERT_NOT_REACHED();
 }
 
@@ -151,6 +153,78 @@ Result hj_process_wait(int tid, int *user_exit_value)
     return result;
 }
 
+Result hj_process_load_library(const char *raw_path, size_t size, uintptr_t *out_base)
+{
+    if (!syscall_validate_ptr((uintptr_t)raw_path, size) ||
+        !syscall_validate_ptr((uintptr_t)out_base, sizeof(uintptr_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    auto path = Path::parse(raw_path, size).normalized();
+
+    return task_load_library(scheduler_running(), path.string().cstring(), out_base);
+}
+
+/* --- Threads -------------------------------------------------------------- */
+
+Result hj_thread_create(uintptr_t entry, uintptr_t stack, void *argument, int *tid)
+{
+    if (!syscall_validate_ptr(entry, 1) ||
+        !syscall_validate_ptr(stack - 32, 32) ||
+        !syscall_validate_ptr((uintptr_t)tid, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    InterruptsRetainer retainer;
+
+    Task *thread = task_create_thread(scheduler_running(), stack, entry, (uintptr_t)argument);
+
+    *tid = thread->id;
+
+    return SUCCESS;
+}
+
+Result hj_thread_exit(int exit_value)
+{
+    // The first thread is the process, it takes the others with it.
+    scheduler_running()->cancel(exit_value);
+    ASSERT_NOT_REACHED();
+}
+
+Result hj_futex_wait(int *address, int expected, Timeout timeout)
+{
+    if (!syscall_validate_ptr((uintptr_t)address, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    if ((uintptr_t)address % sizeof(int) != 0)
+    {
+        return ERR_MEMORY_NOT_ALIGNED;
+    }
+
+    return task_futex_wait(scheduler_running(), address, expected, timeout);
+}
+
+Result hj_futex_wake(int *address, size_t count, size_t *woken)
+{
+    if (!syscall_validate_ptr((uintptr_t)address, sizeof(int)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    size_t result = task_futex_wake(scheduler_running(), address, count);
+
+    if (syscall_validate_ptr((uintptr_t)woken, sizeof(size_t)))
+    {
+        *woken = result;
+    }
+
+    return SUCCESS;
+}
+
 /* --- Shared memory -------------------------------------------------------- */
 
 Result hj_memory_alloc(size_t size, uintptr_t *out_address)
@@ -515,6 +589,17 @@ Result hj_handle_stat(int handle, FileState *state)
     return task_fshandle_stat(scheduler_running(), handle, state);
 }
 
+Result hj_handle_mmap(int handle, uintptr_t *out_address, size_t *out_size)
+{
+    if (!syscall_validate_ptr((uintptr_t)out_address, sizeof(uintptr_t)) ||
+        !syscall_validate_ptr((uintptr_t)out_size, sizeof(size_t)))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    return task_fshandle_mmap(scheduler_running(), handle, out_address, out_size);
+}
+
 Result hj_handle_connect(int *handle, const char *raw_path, size_t size)
 {
     if (!syscall_validate_ptr((uintptr_t)handle, sizeof(int)) &&
@@ -567,6 +652,11 @@ static SyscallHandler syscalls[__SYSCALL_COUNT] = {
     [HJ_PROCESS_CANCEL] = reinterpret_cast<SyscallHandler>(hj_process_cancel),
     [HJ_PROCESS_SLEEP] = reinterpret_cast<SyscallHandler>(hj_process_sleep),
     [HJ_PROCESS_WAIT] = reinterpret_cast<SyscallHandler>(hj_process_wait),
+    [HJ_PROCESS_LOAD_LIBRARY] = reinterpret_cast<SyscallHandler>(hj_process_load_library),
+    [HJ_THREAD_CREATE] = reinterpret_cast<SyscallHandler>(hj_thread_create),
+    [HJ_THREAD_EXIT] = reinterpret_cast<SyscallHandler>(hj_thread_exit),
+    [HJ_FUTEX_WAIT] = reinterpret_cast<SyscallHandler>(hj_futex_wait),
+    [HJ_FUTEX_WAKE] = reinterpret_cast<SyscallHandler>(hj_futex_wake),
     [HJ_MEMORY_ALLOC] = reinterpret_cast<SyscallHandler>(hj_memory_alloc),
     [HJ_MEMORY_FREE] = reinterpret_cast<SyscallHandler>(hj_memory_free),
     [HJ_MEMORY_INCLUDE] = reinterpret_cast<SyscallHandler>(hj_memory_include),
@@ -591,6 +681,7 @@ static SyscallHandler syscalls[__SYSCALL_COUNT] = {
     [HJ_HANDLE_SEEK] = reinterpret_cast<SyscallHandler>(hj_handle_seek),
     [HJ_HANDLE_TELL] = reinterpret_cast<SyscallHandler>(hj_handle_tell),
     [HJ_HANDLE_STAT] = reinterpret_cast<SyscallHandler>(hj_handle_stat),
+    [HJ_HANDLE_MMAP] = reinterpret_cast<SyscallHandler>(hj_handle_mmap),
     [HJ_HANDLE_CONNECT] = reinterpret_cast<SyscallHandler>(hj_handle_connect),
     [HJ_HANDLE_ACCEPT] = reinterpret_cast<SyscallHandler>(hj_handle_accept),
     [HJ_CREATE_PIPE] = reinterpret_cast<SyscallHandler>(hj_create_pipe),
@@ -632,6 +723,8 @@ int task_do_syscall(Syscall syscall, int arg0, int arg1, int arg2, int arg3, int
         return ERR_FUNCTION_NOT_IMPLEMENTED;
     }
 
+    TRACE_SCOPE(syscall_names[syscall]);
+
     result = handler(arg0, arg1, arg2, arg3, arg4);
 
     if (result != SUCCESS && result != TIMEOUT && result != ERR_STREAM_CLOSED)
@@ -6,17 +6,24 @@
 #include "kernel/node/Terminal.h"
 #include "kernel/scheduling/Blocker.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Statistics.h"
 #include "kernel/tasking/Task-Handles.h"
+#include "kernel/tasking/Task-Memory.h"
 
+// Threads use the handles of their process, only the process is looked at
+// below this point.
 ResultOr<int> task_fshandle_add(Task *task, FsHandle *handle)
 {
-    LockHolder holder(task->handles_lock);
+    Task *process = task->process;
+
+    LockHolder holder(process->handles_lock);
 
     for (int i = 0; i < PROCESS_HANDLE_COUNT; i++)
     {
-        if (task->handles[i] == nullptr)
+        if (process->handles[i] == nullptr)
         {
-            task->handles[i] = handle;
+            process->handles[i] = handle;
+            statistics_did_change_handles(process, 1);
 
             return i;
         }
@@ -25,53 +32,62 @@ ResultOr<int> task_fshandle_add(Task *task, FsHandle *handle)
     return ERR_TOO_MANY_OPEN_FILES;
 }
 
-static bool is_valid_handle(Task *task, int handle)
+static bool is_valid_handle(Task *process, int handle)
 {
     return handle >= 0 && handle < PROCESS_HANDLE_COUNT &&
-           task->handles[handle] != nullptr;
+           process->handles[handle] != nullptr;
 }
 
 Result task_fshandle_remove(Task *task, int handle_index)
 {
-    LockHolder holder(task->handles_lock);
+    Task *process = task->process;
+
+    LockHolder holder(process->handles_lock);
 
-    if (!is_valid_handle(task, handle_index))
+    if (!is_valid_handle(process, handle_index))
     {
         logger_warn("Got a bad handle %d from task %d", handle_index, task->id);
         return ERR_BAD_FILE_DESCRIPTOR;
     }
 
-    delete task->handles[handle_index];
-    task->handles[handle_index] = nullptr;
+    delete process->handles[handle_index];
+    process->handles[handle_index] = nullptr;
+    statistics_did_change_handles(process, -1);
 
     return SUCCESS;
 }
 
+// Handles are held by the thread using them, so the other threads of the
+// process wait for it.
 FsHandle *task_fshandle_acquire(Task *task, int handle_index)
 {
-    LockHolder holder(task->handles_lock);
+    Task *process = task->process;
+
+    LockHolder holder(process->handles_lock);
 
-    if (!is_valid_handle(task, handle_index))
+    if (!is_valid_handle(process, handle_index))
     {
         logger_warn("Got a bad handle %d from task %d", handle_index, task->id);
         return nullptr;
     }
 
-    task->handles[handle_index]->acquire(task->id);
-    return task->handles[handle_index];
+    process->handles[handle_index]->acquire(task->id);
+    return process->handles[handle_index];
 }
 
 Result task_fshandle_release(Task *task, int handle_index)
 {
-    LockHolder holder(task->handles_lock);
+    Task *process = task->process;
 
-    if (!is_valid_handle(task, handle_index))
+    LockHolder holder(process->handles_lock);
+
+    if (!is_valid_handle(process, handle_index))
     {
         logger_warn("Got a bad handle %d from task %d", handle_index, task->id);
         return ERR_BAD_FILE_DESCRIPTOR;
     }
 
-    task->handles[handle_index]->release(task->id);
+    process->handles[handle_index]->release(task->id);
     return SUCCESS;
 }
 
@@ -106,6 +122,7 @@ void task_fshandle_close_all(Task *task)
         {
             delete task->handles[i];
             task->handles[i] = nullptr;
+            statistics_did_change_handles(task, -1);
         }
     }
 }
@@ -284,6 +301,69 @@ Result task_fshandle_stat(Task *task, int handle_index, FileState *stat)
     return result;
 }
 
+Result task_fshandle_mmap(Task *task, int handle_index, uintptr_t *out_address, size_t *out_size)
+{
+    auto handle = task_fshandle_acquire(task, handle_index);
+
+    if (handle == nullptr)
+    {
+        return ERR_BAD_FILE_DESCRIPTOR;
+    }
+
+    FileState state = {};
+    handle->stat(&state);
+
+    auto result_or_memory_object = handle->mmap();
+
+    task_fshandle_release(task, handle_index);
+
+    if (!result_or_memory_object.success())
+    {
+        return result_or_memory_object.result();
+    }
+
+    auto memory_object = result_or_memory_object.take_value();
+
+    if (memory_object == nullptr)
+    {
+        *out_address = 0;
+        *out_size = 0;
+
+        return SUCCESS;
+    }
+
+    auto memory_mapping = task_memory_mapping_create(task, memory_object, MEMORY_READONLY);
+
+    memory_object_deref(memory_object);
+
+    *out_address = memory_mapping->address;
+    *out_size = state.size;
+
+    return SUCCESS;
+}
+
+ResultOr<MemoryObject *> task_fshandle_memory_object(Task *task, int handle_index)
+{
+    auto handle = task_fshandle_acquire(task, handle_index);
+
+    if (handle == nullptr)
+    {
+        return ERR_BAD_FILE_DESCRIPTOR;
+    }
+
+    auto result_or_memory_object = handle->mmap();
+
+    task_fshandle_release(task, handle_index);
+
+    // Empty files have nothing to share.
+    if (result_or_memory_object.success() && result_or_memory_object.value() == nullptr)
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    return result_or_memory_object;
+}
+
 ResultOr<int> task_fshandle_connect(Task *task, Path &path)
 {
     auto result_or_connection_handle = filesystem_connect(path);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "kernel/memory/MemoryObject.h"
 #include "kernel/tasking/Task.h"
 
 ResultOr<int> task_fshandle_open(Task *task, Path &path, OpenFlag flags);
@@ -22,6 +23,10 @@ Result task_fshandle_call(Task *task, int handle_index, IOCall request, void *ar
 
 Result task_fshandle_stat(Task *task, int handle_index, FileState *stat);
 
+Result task_fshandle_mmap(Task *task, int handle_index, uintptr_t *out_address, size_t *out_size);
+
+ResultOr<MemoryObject *> task_fshandle_memory_object(Task *task, int handle_index);
+
 ResultOr<int> task_fshandle_connect(Task *task, Path &socket_path);
 
 ResultOr<int> task_fshandle_accept(Task *task, int socket_handle_index);
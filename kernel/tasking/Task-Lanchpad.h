@@ -5,3 +5,5 @@
 #include "kernel/tasking/Task.h"
 
 Result task_launch(Task *parent_task, Launchpad *launchpad, int *pid);
+
+Result task_load_library(Task *task, const char *path, uintptr_t *out_base);
@@ -3,9 +3,15 @@
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+
+#include "architectures/Memory.h"
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
+#include "kernel/system/Statistics.h"
+#include "kernel/tasking/Task-Handles.h"
 #include "kernel/tasking/Task-Lanchpad.h"
 #include "kernel/tasking/Task-Memory.h"
 #include "kernel/tasking/Task.h"
@@ -18,22 +24,89 @@ struct ELFLoader
     using Program = TELFFormat::Program;
     using Symbole = TELFFormat::Symbole;
 
-    static Result load_program(Task *task, Stream *elf_file, Program *program_header)
+    static Result read_program_header(Stream *elf_file, Header &elf_header, int index, Program *program_header)
+    {
+        stream_seek(elf_file, elf_header.phoff + elf_header.phentsize * index, WHENCE_START);
+
+        if (stream_read(elf_file, program_header, sizeof(Program)) != sizeof(Program))
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+        return SUCCESS;
+    }
+
+    // Shared objects are linked at zero, they are moved to the first hole
+    // of the address space large enough for all their segments.
+    static ResultOr<uintptr_t> find_base(Task *task, Stream *elf_file, Header &elf_header)
+    {
+        uintptr_t lowest = UINTPTR_MAX;
+        uintptr_t highest = 0;
+
+        for (int i = 0; i < elf_header.phnum; i++)
+        {
+            Program program_header;
+
+            if (read_program_header(elf_file, elf_header, i, &program_header) != SUCCESS)
+            {
+                return ERR_EXEC_FORMAT_ERROR;
+            }
+
+            if (program_header.type == ELF_PROGRAM_TYPE_LOAD)
+            {
+                lowest = MIN(lowest, PAGE_ALIGN_DOWN(program_header.vaddr));
+                highest = MAX(highest, PAGE_ALIGN_UP(program_header.vaddr + program_header.memsz));
+            }
+        }
+
+        if (lowest >= highest)
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+        auto result_or_address = task_memory_find_free(task, highest - lowest);
+
+        if (!result_or_address.success())
+        {
+            return result_or_address.result();
+        }
+
+        return result_or_address.take_value() - lowest;
+    }
+
+    static Result load_program(Task *task, Stream *elf_file, MemoryObject *elf_object, Program *program_header, uintptr_t base)
     {
-        if (program_header->vaddr <= 0x100000)
+        uintptr_t address = base + program_header->vaddr;
+
+        if (address <= 0x100000)
         {
-            logger_error("ELF program no in user memory (0x%08x)!", program_header->vaddr);
+            logger_error("ELF program no in user memory (0x%08x)!", address);
             return ERR_EXEC_FORMAT_ERROR;
         }
 
+        // Read-only segments are mapped straight from the pages of the file,
+        // every task running the same program or library shares them.
+        if (elf_object != nullptr &&
+            !(program_header->flags & ELF_PROGRAM_W) &&
+            program_header->filesz == program_header->memsz &&
+            program_header->offset % ARCH_PAGE_SIZE == address % ARCH_PAGE_SIZE)
+        {
+            MemoryRange range = MemoryRange::around_non_aligned_address(address, program_header->filesz);
+
+            if (task_memory_map_shared(task, elf_object, PAGE_ALIGN_DOWN(program_header->offset), range.base(), range.size()) == SUCCESS)
+            {
+                return SUCCESS;
+            }
+        }
+
         void *parent_address_space = task_switch_address_space(scheduler_running(), task->address_space);
 
-        MemoryRange range = MemoryRange::around_non_aligned_address(program_header->vaddr, program_header->memsz);
+        MemoryRange range = MemoryRange::around_non_aligned_address(address, program_header->memsz);
 
         task_memory_map(task, range.base(), range.size(), MEMORY_CLEAR);
 
         stream_seek(elf_file, program_header->offset, WHENCE_START);
-        size_t read = stream_read(elf_file, (void *)program_header->vaddr, program_header->filesz);
+        size_t read = stream_read(elf_file, (void *)address, program_header->filesz);
 
         if (read != program_header->filesz)
         {
@@ -51,7 +124,26 @@ struct ELFLoader
         }
     }
 
-    static Result load(Task *task, Stream *elf_file)
+    static Result read_interpreter(Stream *elf_file, Program *program_header, char *interpreter)
+    {
+        if (program_header->filesz == 0 || program_header->filesz >= PATH_LENGTH)
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+        stream_seek(elf_file, program_header->offset, WHENCE_START);
+
+        if (stream_read(elf_file, interpreter, program_header->filesz) != program_header->filesz)
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+        interpreter[program_header->filesz] = '\0';
+
+        return SUCCESS;
+    }
+
+    static Result load(Task *task, Stream *elf_file, LaunchpadImage *image, uintptr_t *out_base, char *interpreter)
     {
         Header elf_header;
         size_t elf_header_size = stream_read(elf_file, &elf_header, sizeof(Header));
@@ -61,34 +153,117 @@ struct ELFLoader
             return ERR_EXEC_FORMAT_ERROR;
         }
 
-        task_set_entry(task, reinterpret_cast<TaskEntryPoint>(elf_header.entry), true);
+        uintptr_t base = 0;
 
-        for (int i = 0; i < elf_header.phnum; i++)
+        if (elf_header.type == ELF_ETYPE_DYN)
         {
-            Program elf_program_header;
-            stream_seek(elf_file, elf_header.phoff + elf_header.phentsize * i, WHENCE_START);
+            auto result_or_base = find_base(task, elf_file, elf_header);
 
-            if (stream_read(elf_file, &elf_program_header, sizeof(Program)) != sizeof(Program))
+            if (!result_or_base.success())
             {
-                return ERR_EXEC_FORMAT_ERROR;
+                return result_or_base.result();
             }
 
-            Result result = load_program(task, elf_file, &elf_program_header);
+            base = result_or_base.take_value();
+        }
+        else if (elf_header.type != ELF_ETYPE_EXEC)
+        {
+            return ERR_EXEC_FORMAT_ERROR;
+        }
+
+#ifdef CONFIG_SHARED_LIBRARIES
+        // Files which can't be mapped (ie. not on a ramdisk) are copied.
+        auto result_or_elf_object = task_fshandle_memory_object(scheduler_running(), HANDLE(elf_file)->id);
+        MemoryObject *elf_object = result_or_elf_object.success() ? result_or_elf_object.take_value() : nullptr;
+#else
+        // Mapping the file makes it read-only for good, without shared
+        // libraries there is little text to share so every segment is copied.
+        MemoryObject *elf_object = nullptr;
+#endif
+
+        Result result = SUCCESS;
+
+        for (int i = 0; i < elf_header.phnum && result == SUCCESS; i++)
+        {
+            Program elf_program_header;
+            result = read_program_header(elf_file, elf_header, i, &elf_program_header);
 
             if (result != SUCCESS)
             {
-                return result;
+                break;
+            }
+
+            if (elf_program_header.type == ELF_PROGRAM_TYPE_LOAD)
+            {
+                result = load_program(task, elf_file, elf_object, &elf_program_header, base);
+            }
+            else if (elf_program_header.type == ELF_PROGRAM_TYPE_PHDR)
+            {
+                image->program_headers = base + elf_program_header.vaddr;
+            }
+            else if (elf_program_header.type == ELF_PROGRAM_TYPE_INTERP && interpreter != nullptr)
+            {
+                result = read_interpreter(elf_file, &elf_program_header, interpreter);
             }
         }
 
-        return SUCCESS;
+        if (elf_object != nullptr)
+        {
+            memory_object_deref(elf_object);
+        }
+
+        image->program_header_count = elf_header.phnum;
+        image->program_header_size = elf_header.phentsize;
+        image->entry = base + elf_header.entry;
+
+        *out_base = base;
+
+        return result;
     }
 };
 
-void task_pass_argc_argv_env(Task *task, Launchpad *launchpad)
+static Result task_load_elf(Task *task, const char *path, LaunchpadImage *image, uintptr_t *out_base, char *interpreter)
+{
+    __cleanup(stream_cleanup) Stream *elf_file = stream_open(path, OPEN_READ);
+
+    if (handle_has_error(elf_file))
+    {
+        logger_error("Failed to open ELF file %s: %s!", path, handle_error_string(elf_file));
+        return handle_get_error(elf_file);
+    }
+
+#ifdef __x86_64__
+    Result result = ELFLoader<ELF64>::load(task, elf_file, image, out_base, interpreter);
+#else
+    Result result = ELFLoader<ELF32>::load(task, elf_file, image, out_base, interpreter);
+#endif
+
+    if (result == SUCCESS)
+    {
+        profiler_did_load_module(task, path, *out_base);
+    }
+
+    return result;
+}
+
+Result task_load_library(Task *task, const char *path, uintptr_t *out_base)
+{
+    LaunchpadImage image = {};
+
+    return task_load_elf(task, path, &image, out_base, nullptr);
+}
+
+void task_pass_argc_argv_env(Task *task, Launchpad *launchpad, LaunchpadImage *image)
 {
     void *parent_address_space = task_switch_address_space(scheduler_running(), task->address_space);
 
+    uintptr_t image_ref = 0;
+
+    if (image != nullptr)
+    {
+        image_ref = task_user_stack_push(task, image, sizeof(LaunchpadImage));
+    }
+
     uintptr_t argv_list[PROCESS_ARG_COUNT] = {};
 
     for (int i = 0; i < launchpad->argc; i++)
@@ -102,6 +277,7 @@ void task_pass_argc_argv_env(Task *task, Launchpad *launchpad)
     task_user_stack_push(task, "\0", 1); // null terminate the env string
     uintptr_t env_ref = task_user_stack_push(task, launchpad->env, launchpad->env_size);
 
+    task_user_stack_push(task, &image_ref, sizeof(image_ref));
     task_user_stack_push(task, &env_ref, sizeof(env_ref));
     task_user_stack_push(task, &argv_list_ref, sizeof(argv_list_ref));
     task_user_stack_push(task, &launchpad->argc, sizeof(int));
@@ -124,6 +300,7 @@ void task_pass_handles(Task *parent_task, Task *child_task, Launchpad *launchpad
         {
             parent_task->handles[parent_handle_id]->acquire(scheduler_running_id());
             child_task->handles[child_handle_id] = new FsHandle(*parent_task->handles[parent_handle_id]);
+            statistics_did_change_handles(child_task, 1);
             parent_task->handles[parent_handle_id]->release(scheduler_running_id());
         }
     }
@@ -135,23 +312,29 @@ Result task_launch(Task *parent_task, Launchpad *launchpad, int *pid)
 
     *pid = -1;
 
-    __cleanup(stream_cleanup) Stream *elf_file = stream_open(launchpad->executable, OPEN_READ);
-
-    if (handle_has_error(elf_file))
-    {
-        logger_error("Failed to open ELF file %s: %s!", launchpad->executable, handle_error_string(elf_file));
-        return handle_get_error(elf_file);
-    }
-
     interrupts_retain();
     Task *task = task_create(parent_task, launchpad->name, true);
     interrupts_release();
 
-#ifdef __x86_64__
-    Result result = ELFLoader<ELF64>::load(task, elf_file);
-#else
-    Result result = ELFLoader<ELF32>::load(task, elf_file);
-#endif
+    LaunchpadImage image = {};
+    uintptr_t base = 0;
+    char interpreter[PATH_LENGTH] = {};
+
+    Result result = task_load_elf(task, launchpad->executable, &image, &base, interpreter);
+
+    uintptr_t entry = image.entry;
+    bool dynamic = interpreter[0] != '\0';
+
+    // Dynamically linked programs start in their loader, which maps their
+    // libraries, links everything and then jumps to image.entry.
+    if (result == SUCCESS && dynamic)
+    {
+        LaunchpadImage loader_image = {};
+        uintptr_t loader_base = 0;
+
+        result = task_load_elf(task, interpreter, &loader_image, &loader_base, nullptr);
+        entry = loader_image.entry;
+    }
 
     if (result != SUCCESS)
     {
@@ -159,9 +342,12 @@ Result task_launch(Task *parent_task, Launchpad *launchpad, int *pid)
         return result;
     }
 
-    task_pass_argc_argv_env(task, launchpad);
+    task_set_entry(task, reinterpret_cast<TaskEntryPoint>(entry), true);
+
+    task_pass_argc_argv_env(task, launchpad, dynamic ? &image : nullptr);
 
-    task_pass_handles(parent_task, task, launchpad);
+    // Handles belong to the process, not to the thread launching.
+    task_pass_handles(parent_task->process, task, launchpad);
 
     *pid = task->id;
 
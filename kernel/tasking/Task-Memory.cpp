@@ -1,8 +1,10 @@
 #include <libsystem/core/CString.h>
 
+#include "architectures/Memory.h"
 #include "architectures/VirtualMemory.h"
 
 #include "kernel/interrupts/Interupts.h"
+#include "kernel/system/Statistics.h"
 #include "kernel/tasking/Task-Handles.h"
 #include "kernel/tasking/Task-Memory.h"
 
@@ -25,21 +27,27 @@ static void task_kill_me_if_too_greedy(Task *task, size_t size)
     if (will_i_be_kill_if_i_allocate_that(task, size))
     {
         task_fshandle_write(task, 2, "(ulimit reached)\n", 17);
-        task->cancel(PROCESS_FAILURE);
+        task->process->cancel(PROCESS_FAILURE);
     }
 }
 
-MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object)
+MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object, MemoryFlags flags)
 {
     InterruptsRetainer retainer;
 
     auto memory_mapping = __create(MemoryMapping);
 
+    if (memory_object->readonly)
+    {
+        flags |= MEMORY_READONLY;
+    }
+
     memory_mapping->object = memory_object_ref(memory_object);
-    memory_mapping->address = arch_virtual_alloc(task->address_space, memory_object->range(), MEMORY_USER).base();
+    memory_mapping->address = arch_virtual_alloc(task->address_space, memory_object->range(), MEMORY_USER | flags).base();
     memory_mapping->size = memory_object->range().size();
 
     list_pushback(task->memory_mapping, memory_mapping);
+    statistics_did_map_memory(task->process, memory_mapping->size);
 
     return memory_mapping;
 }
@@ -54,9 +62,10 @@ MemoryMapping *task_memory_mapping_create_at(Task *task, MemoryObject *memory_ob
     memory_mapping->address = address;
     memory_mapping->size = memory_object->range().size();
 
-    arch_virtual_map(task->address_space, memory_object->range(), address, MEMORY_USER);
+    arch_virtual_map(task->address_space, memory_object->range(), address, MEMORY_USER | (memory_object->readonly ? MEMORY_READONLY : 0));
 
     list_pushback(task->memory_mapping, memory_mapping);
+    statistics_did_map_memory(task->process, memory_mapping->size);
 
     return memory_mapping;
 }
@@ -69,6 +78,7 @@ void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping)
     memory_object_deref(memory_mapping->object);
 
     list_remove(task->memory_mapping, memory_mapping);
+    statistics_did_unmap_memory(task->process, memory_mapping->size);
     free(memory_mapping);
 }
 
@@ -107,7 +117,7 @@ Result task_memory_alloc(Task *task, size_t size, uintptr_t *out_address)
 
     auto memory_object = memory_object_create(size);
 
-    auto memory_mapping = task_memory_mapping_create(task, memory_object);
+    auto memory_mapping = task_memory_mapping_create(task, memory_object, MEMORY_NONE);
 
     memory_object_deref(memory_object);
 
@@ -139,6 +149,73 @@ Result task_memory_map(Task *task, uintptr_t address, size_t size, MemoryFlags f
     return SUCCESS;
 }
 
+// Maps `size` bytes of the object starting at `offset` without copying
+// them, every task mapping the same object shares the physical pages.
+Result task_memory_map_shared(Task *task, MemoryObject *memory_object, size_t offset, uintptr_t address, size_t size)
+{
+    if (offset + size > memory_object->range().size())
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    if (task_memory_mapping_colides(task, address, size))
+    {
+        return ERR_BAD_ADDRESS;
+    }
+
+    InterruptsRetainer retainer;
+
+    auto memory_mapping = __create(MemoryMapping);
+
+    memory_mapping->object = memory_object_ref(memory_object);
+    memory_mapping->offset = offset;
+    memory_mapping->address = address;
+    memory_mapping->size = size;
+
+    MemoryRange physical_range{memory_object->range().base() + offset, size};
+    arch_virtual_map(task->address_space, physical_range, address, MEMORY_USER | MEMORY_READONLY);
+
+    list_pushback(task->memory_mapping, memory_mapping);
+    statistics_did_map_memory(task->process, memory_mapping->size);
+
+    return SUCCESS;
+}
+
+ResultOr<uintptr_t> task_memory_find_free(Task *task, size_t size)
+{
+    InterruptsRetainer retainer;
+
+    uintptr_t address = 0;
+    size_t current_size = 0;
+
+    // Same search as arch_virtual_alloc(), the caller maps the range right
+    // after so nothing else can take it.
+    for (size_t page = 256 * 1024; page < 1024 * 1024; page++)
+    {
+        uintptr_t current = page * ARCH_PAGE_SIZE;
+
+        if (arch_virtual_present(task->address_space, current))
+        {
+            current_size = 0;
+            continue;
+        }
+
+        if (current_size == 0)
+        {
+            address = current;
+        }
+
+        current_size += ARCH_PAGE_SIZE;
+
+        if (current_size >= size)
+        {
+            return address;
+        }
+    }
+
+    return ERR_OUT_OF_MEMORY;
+}
+
 Result task_memory_free(Task *task, uintptr_t address)
 {
     auto memory_mapping = task_memory_mapping_by_address(task, address);
@@ -168,7 +245,7 @@ Result task_memory_include(Task *task, int handle, uintptr_t *out_address, size_
         return ERR_BAD_ADDRESS;
     }
 
-    auto memory_mapping = task_memory_mapping_create(task, memory_object);
+    auto memory_mapping = task_memory_mapping_create(task, memory_object, MEMORY_NONE);
 
     memory_object_deref(memory_object);
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <libutils/ResultOr.h>
+
 #include "kernel/memory/MemoryObject.h"
 #include "kernel/tasking/Task.h"
 
@@ -7,6 +9,10 @@ struct MemoryMapping
 {
     MemoryObject *object;
 
+    // Where the mapping starts in the object, not zero for shared
+    // mappings of a part of a file.
+    size_t offset;
+
     uintptr_t address;
     size_t size;
 
@@ -16,7 +22,7 @@ struct MemoryMapping
     }
 };
 
-MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object);
+MemoryMapping *task_memory_mapping_create(Task *task, MemoryObject *memory_object, MemoryFlags flags);
 
 void task_memory_mapping_destroy(Task *task, MemoryMapping *memory_mapping);
 
@@ -26,6 +32,10 @@ Result task_memory_alloc(Task *task, size_t size, uintptr_t *out_address);
 
 Result task_memory_map(Task *task, uintptr_t address, size_t size, MemoryFlags flags);
 
+Result task_memory_map_shared(Task *task, MemoryObject *memory_object, size_t offset, uintptr_t address, size_t size);
+
+ResultOr<uintptr_t> task_memory_find_free(Task *task, size_t size);
+
 Result task_memory_free(Task *task, uintptr_t address);
 
 Result task_memory_include(Task *task, int handle, uintptr_t *out_address, size_t *out_size);
@@ -8,6 +8,8 @@
 
 #include "kernel/interrupts/Interupts.h"
 #include "kernel/scheduling/Scheduler.h"
+#include "kernel/system/Profiler.h"
+#include "kernel/system/Statistics.h"
 #include "kernel/system/System.h"
 #include "kernel/tasking/Task-Handles.h"
 #include "kernel/tasking/Task-Memory.h"
@@ -24,6 +26,7 @@ TaskState Task::state()
 void Task::state(TaskState state)
 {
     scheduler_did_change_task_state(this, _state, state);
+    statistics_did_change_task_state(this, _state, state);
     _state = state;
 }
 
@@ -31,10 +34,25 @@ void Task::cancel(int exit_value)
 {
     InterruptsRetainer retainer;
 
+    // Threads don't outlive their process, they use its address space.
+    if (process == this)
+    {
+        list_foreach(Task, thread, _tasks)
+        {
+            if (thread->process == this &&
+                thread != this &&
+                thread->state() != TASK_STATE_CANCELED)
+            {
+                thread->exit_value = exit_value;
+                thread->state(TASK_STATE_CANCELED);
+            }
+        }
+    }
+
     this->exit_value = exit_value;
     state(TASK_STATE_CANCELED);
 
-    if (this == scheduler_running())
+    if (this == scheduler_running() || scheduler_running()->process == this)
     {
         scheduler_yield();
         ASSERT_NOT_REACHED();
@@ -55,8 +73,12 @@ Task *task_create(Task *parent, const char *name, bool user)
     Task *task = __create(Task);
 
     task->id = _task_ids++;
+    task->user = user;
     strlcpy(task->name, name, PROCESS_NAME_SIZE);
     task->_state = TASK_STATE_NONE;
+    task->process = task;
+
+    statistics_did_create_task(task);
 
     if (user)
     {
@@ -69,6 +91,7 @@ Task *task_create(Task *parent, const char *name, bool user)
 
     // Setup shms
     task->memory_mapping = list_create();
+    task->modules = list_create();
 
     // Setup fildes
     lock_init(task->handles_lock);
@@ -96,10 +119,15 @@ Task *task_create(Task *parent, const char *name, bool user)
     return task;
 }
 
+// The parent might be any thread, what gets cloned is its process, whose
+// handles_lock the caller holds.
 Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip)
 {
     ASSERT_INTERRUPTS_RETAINED();
 
+    Task *process = parent->process;
+    lock_assert(process->handles_lock);
+
     if (_tasks == nullptr)
     {
         _tasks = list_create();
@@ -108,31 +136,54 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip)
     Task *task = __create(Task);
 
     task->id = _task_ids++;
-    strlcpy(task->name, parent->name, PROCESS_NAME_SIZE);
+    task->user = true;
+    strlcpy(task->name, process->name, PROCESS_NAME_SIZE);
     task->_state = TASK_STATE_NONE;
+    task->process = task;
+
+    statistics_did_create_task(task);
 
     task->address_space = arch_address_space_create();
 
     // Setup shms
     task->memory_mapping = list_create();
 
+    // Same address space layout, so the same modules.
+    task->modules = list_create();
+
+    list_foreach(ProfileModule, module, process->modules)
+    {
+        list_pushback_copy(task->modules, module, sizeof(ProfileModule));
+    }
+
     // Setup fildes
     lock_init(task->handles_lock);
     for (int i = 0; i < PROCESS_HANDLE_COUNT; i++)
     {
-        if (parent->handles[i])
+        if (process->handles[i])
         {
-            task->handles[i] = new FsHandle(*parent->handles[i]);
+            task->handles[i] = new FsHandle(*process->handles[i]);
+            statistics_did_change_handles(task, 1);
         }
     }
 
     memory_alloc(task->address_space, PROCESS_STACK_SIZE, MEMORY_CLEAR, (uintptr_t *)&task->kernel_stack);
     task->kernel_stack_pointer = ((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
 
-    list_foreach(MemoryMapping, mapping, parent->memory_mapping)
+    list_foreach(MemoryMapping, mapping, process->memory_mapping)
     {
         auto virtual_range = mapping->range();
 
+#ifdef CONFIG_SHARED_LIBRARIES
+        // Read-only mappings (program text, mapped files) can't diverge, the
+        // clone keeps using the same pages.
+        if (mapping->object->readonly)
+        {
+            task_memory_map_shared(task, mapping->object, mapping->offset, virtual_range.base(), virtual_range.size());
+            continue;
+        }
+#endif
+
         auto physical_range = mapping->object->range();
 
         void *buffer = malloc(physical_range.size());
@@ -152,7 +203,53 @@ Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip)
 
     task->user_stack_pointer = sp;
     task->entry_point = (TaskEntryPoint)ip;
+
+    task_go(task);
+
+    return task;
+}
+
+Task *task_create_thread(Task *parent, uintptr_t sp, uintptr_t ip, uintptr_t argument)
+{
+    ASSERT_INTERRUPTS_RETAINED();
+
+    Task *process = parent->process;
+    Task *task = __create(Task);
+
+    task->id = _task_ids++;
     task->user = true;
+    strlcpy(task->name, process->name, PROCESS_NAME_SIZE);
+    task->_state = TASK_STATE_NONE;
+    task->process = process;
+
+    statistics_did_create_task(task);
+
+    // Everything but the stacks is shared with the process, handles are
+    // looked up through it.
+    task->address_space = process->address_space;
+    task->memory_mapping = process->memory_mapping;
+    task->modules = process->modules;
+
+    // The kernel stack is taken from the kernel address space, the process
+    // may already be gone when the thread gets destroyed.
+    memory_alloc(arch_kernel_address_space(), PROCESS_STACK_SIZE, MEMORY_CLEAR, (uintptr_t *)&task->kernel_stack);
+    task->kernel_stack_pointer = ((uintptr_t)task->kernel_stack + PROCESS_STACK_SIZE);
+
+    arch_save_context(task);
+
+    list_pushback(_tasks, task);
+
+    // The stack was allocated by the parent, in the same address space, so
+    // it can be written to from here. The entry point is called with the
+    // argument, on a 16 bytes boundary like any call, and a null return
+    // address.
+    uintptr_t return_address = 0;
+
+    task->user_stack_pointer = __align_down(sp, 16) - 16 + sizeof(argument);
+    task_user_stack_push(task, &argument, sizeof(argument));
+    task_user_stack_push(task, &return_address, sizeof(return_address));
+
+    task->entry_point = (TaskEntryPoint)ip;
 
     task_go(task);
 
@@ -166,8 +263,27 @@ void task_destroy(Task *task)
 
     list_remove(_tasks, task);
 
+    if (task->blocker)
+    {
+        task->blocker->on_cancel(task);
+        delete task->blocker;
+        task->blocker = nullptr;
+    }
+
     interrupts_release();
 
+    // Only the kernel stack is the thread's own.
+    if (task->process != task)
+    {
+        memory_free(arch_kernel_address_space(), MemoryRange{(uintptr_t)task->kernel_stack, PROCESS_STACK_SIZE});
+
+        statistics_did_destroy_task(task);
+
+        free(task);
+
+        return;
+    }
+
     MemoryMapping *mapping = nullptr;
 
     while ((mapping = (MemoryMapping *)list_peek(task->memory_mapping)))
@@ -176,6 +292,7 @@ void task_destroy(Task *task)
     }
 
     list_destroy(task->memory_mapping);
+    list_destroy_with_callback(task->modules, free);
 
     task_fshandle_close_all(task);
 
@@ -186,6 +303,8 @@ void task_destroy(Task *task)
         arch_address_space_destroy(task->address_space);
     }
 
+    statistics_did_destroy_task(task);
+
     free(task);
 }
 
@@ -323,6 +442,38 @@ Result task_wait(int task_id, int *exit_value)
     return SUCCESS;
 }
 
+// The value is checked with interrupts retained, nobody can change it and
+// wake the task up before it is waiting.
+Result task_futex_wait(Task *task, int *address, int expected, Timeout timeout)
+{
+    Blocker *blocker = nullptr;
+
+    {
+        InterruptsRetainer retainer;
+
+        if (__atomic_load_n(address, __ATOMIC_SEQ_CST) != expected)
+        {
+            return SUCCESS;
+        }
+
+        blocker = new BlockerFutex(task->address_space, (uintptr_t)address);
+    }
+
+    if (task_block(task, blocker, timeout) == BLOCKER_TIMEOUT)
+    {
+        return TIMEOUT;
+    }
+
+    return SUCCESS;
+}
+
+size_t task_futex_wake(Task *task, int *address, size_t count)
+{
+    InterruptsRetainer retainer;
+
+    return BlockerFutex::wake(task->address_space, (uintptr_t)address, count);
+}
+
 BlockerResult task_block(Task *task, Blocker *blocker, Timeout timeout)
 {
     assert(!task->blocker);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <abi/Process.h>
+#include <abi/Statistics.h>
 #include <abi/Task.h>
 
 #include <libsystem/utils/List.h>
@@ -11,6 +12,8 @@
 
 typedef void (*TaskEntryPoint)();
 
+struct ProfileBuffer;
+
 struct Task
 {
     int id;
@@ -20,6 +23,10 @@ struct Task
     TaskState _state;
     Blocker *blocker;
 
+    // The task owning the address space, the memory mappings and the
+    // handles, itself unless this is a thread.
+    Task *process;
+
     uintptr_t user_stack_pointer;
     void *user_stack;
 
@@ -35,8 +42,16 @@ struct Task
     List *memory_mapping;
     void *address_space;
 
+    // ProfileModule, the program and the libraries loaded so far.
+    List *modules;
+    ProfileBuffer *profile;
+
     int exit_value;
 
+    TaskStatistics *statistics;
+    uint32_t blocked_since;
+    uint32_t usage_ticks;
+
     TaskState state();
 
     void state(TaskState state);
@@ -48,6 +63,8 @@ Task *task_create(Task *parent, const char *name, bool user);
 
 Task *task_clone(Task *parent, uintptr_t sp, uintptr_t ip);
 
+Task *task_create_thread(Task *parent, uintptr_t sp, uintptr_t ip, uintptr_t argument);
+
 void task_destroy(Task *task);
 
 typedef Iteration (*TaskIterateCallback)(void *target, Task *task);
@@ -73,6 +90,10 @@ Result task_sleep(Task *task, int timeout);
 
 Result task_wait(int task_id, int *exit_value);
 
+Result task_futex_wait(Task *task, int *address, int expected, Timeout timeout);
+
+size_t task_futex_wake(Task *task, int *address, size_t count);
+
 BlockerResult task_block(Task *task, Blocker *blocker, Timeout timeout);
 
 void task_dump(Task *task);
@@ -1,3 +1,5 @@
+#include <libsystem/Logger.h>
+
 #include "kernel/tasking/Tasking.h"
 #include "kernel/scheduling/Scheduler.h"
 #include "kernel/system/System.h"
@@ -24,6 +26,17 @@ void garbage_collector()
     }
 }
 
+// Writes the log lines out of the trace ring, so logging from the kernel
+// never waits on the serial port.
+void logger_flusher()
+{
+    while (true)
+    {
+        task_sleep(scheduler_running(), 50);
+        logger_flush();
+    }
+}
+
 void tasking_initialize()
 {
     Task *idle_task = task_spawn(nullptr, "Idle", system_hang, nullptr, false);
@@ -39,4 +52,9 @@ void tasking_initialize()
 
     Task *garbage_task = task_spawn(nullptr, "GarbageCollector", garbage_collector, nullptr, false);
     task_go(garbage_task);
+
+    Task *logger_task = task_spawn(nullptr, "LoggerFlusher", logger_flusher, nullptr, false);
+    task_go(logger_task);
+
+    logger_defer(true);
 }
@@ -53,6 +53,41 @@ $(BUILD_DIRECTORY)/libraries/lib$($(1)_NAME)/%.s.o: libraries/lib$($(1)_NAME)/%.
 	@echo [LIB$(1)] [AS] $$<
 	@$(AS) $(ASFLAGS) $$^ -o $$@
 
+# Libraries with $(1)_SHARED set are also built from position independent
+# objects as a shared object, linked against the ones in $(1)_NEEDED.
+ifeq ($(CONFIG_SHARED_LIBRARIES)-$($(1)_SHARED), true-true)
+
+$(1)_SHARED_OBJECT ?= $(BUILD_DIRECTORY_LIBS)/lib$($(1)_NAME).so
+
+$(1)_PIC_OBJECTS = $$(patsubst libraries/%.cpp, $(BUILD_DIRECTORY)/libraries-pic/%.o, $$($(1)_SOURCES)) \
+				   $$(patsubst libraries/%.s, $(BUILD_DIRECTORY)/libraries-pic/%.s.o, $$($(1)_ASSEMBLY_SOURCES))
+
+TARGETS += $$($(1)_SHARED_OBJECT)
+OBJECTS += $$($(1)_PIC_OBJECTS)
+SHARED_LIBRARIES += $$($(1)_SHARED_OBJECT)
+
+$$($(1)_SHARED_OBJECT): $$($(1)_PIC_OBJECTS) $$(patsubst %, $(BUILD_DIRECTORY_LIBS)/lib%.so, $$($(1)_NEEDED))
+	$$(DIRECTORY_GUARD)
+	@echo [LIB$(1)] [LD] $$@
+	@$(CXX) $(SHARED_LDFLAGS) -o $$@ \
+		`$(CXX) -print-file-name=crtbeginS.o` \
+		$$($(1)_PIC_OBJECTS) \
+		$$(patsubst %, -l%, $$($(1)_NEEDED)) -lgcc \
+		`$(CXX) -print-file-name=crtendS.o`
+
+$(BUILD_DIRECTORY)/libraries-pic/lib$($(1)_NAME)/%.o: libraries/lib$($(1)_NAME)/%.cpp
+	$$(DIRECTORY_GUARD)
+	@echo [LIB$(1)] [CXX] [PIC] $$<
+	@$(CXX) $(CXXFLAGS) $(SHARED_CXXFLAGS) $($(1)_CXXFLAGS) -c -o $$@ $$<
+
+# Assembly has to be written position independent, it is assembled as is.
+$(BUILD_DIRECTORY)/libraries-pic/lib$($(1)_NAME)/%.s.o: libraries/lib$($(1)_NAME)/%.s
+	$$(DIRECTORY_GUARD)
+	@echo [LIB$(1)] [AS] [PIC] $$<
+	@$(AS) $(ASFLAGS) $$^ -o $$@
+
+endif
+
 endef
 
 $(BUILD_DIRECTORY_INCLUDE)/%.h: libraries/%.h
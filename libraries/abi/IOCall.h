@@ -1,6 +1,8 @@
 #pragma once
 
 #include <abi/Network.h>
+#include <abi/Profile.h>
+#include <abi/Trace.h>
 
 struct IOCallTerminalSizeArgs
 {
@@ -26,6 +28,59 @@ struct IOCallDisplayBlitArgs
     int blit_height;
 };
 
+// The framebuffer is laid out as 32bits BGRX pixels, pitch is in bytes.
+// Devices supporting page flipping stack `buffers` screens vertically.
+struct IOCallDisplayMapArgs
+{
+    uintptr_t address;
+    size_t size;
+
+    int width;
+    int height;
+    int pitch;
+    int buffers;
+};
+
+struct IOCallDisplayFlipArgs
+{
+    int buffer;
+};
+
+// Devices with host side scanout read straight from a shared bitmap, which
+// must match the current mode, and only need to be told what changed.
+struct IOCallDisplayAttachArgs
+{
+    int memory_object;
+    int width;
+    int height;
+};
+
+struct IOCallDisplayFlushArgs
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// Cursor images are RGBA and at most 64x64, the hotspot is relative to the
+// top left corner of the image.
+struct IOCallDisplayCursorArgs
+{
+    uint32_t *buffer;
+    int width;
+    int height;
+
+    int hotspot_x;
+    int hotspot_y;
+};
+
+struct IOCallDisplayCursorPositionArgs
+{
+    int x;
+    int y;
+};
+
 struct IOCallKeyboardSetKeymapArgs
 {
     void *keymap;
@@ -40,6 +95,55 @@ struct IOCallTextModeStateArgs
     int cursor_y;
 };
 
+struct IOCallStatisticsMapArgs
+{
+    uintptr_t address;
+    size_t size;
+};
+
+struct IOCallTraceRecordArgs
+{
+    TraceKind kind;
+    long argument;
+    char name[TRACE_NAME_SIZE];
+};
+
+// Reads the events recorded since the capture started, `read` is set to how
+// many were copied and `lost` to how many were overwritten before that.
+struct IOCallTraceReadArgs
+{
+    TraceEvent *events;
+    size_t count;
+
+    size_t read;
+    size_t lost;
+};
+
+struct IOCallProfileStartArgs
+{
+    int pid;
+};
+
+struct IOCallProfileReadArgs
+{
+    ProfileSample *samples;
+    size_t count;
+
+    size_t read;
+    size_t lost;
+
+    // Cleared once the task exited or the profile was stopped.
+    bool running;
+};
+
+struct IOCallProfileModulesArgs
+{
+    ProfileModule *modules;
+    size_t count;
+
+    size_t read;
+};
+
 struct IOCallNetworkSateAgs
 {
     MacAddress mac_address;
@@ -53,6 +157,12 @@ enum IOCall
     IOCALL_DISPLAY_GET_MODE,
     IOCALL_DISPLAY_SET_MODE,
     IOCALL_DISPLAY_BLIT,
+    IOCALL_DISPLAY_MAP,
+    IOCALL_DISPLAY_FLIP,
+    IOCALL_DISPLAY_ATTACH,
+    IOCALL_DISPLAY_FLUSH,
+    IOCALL_DISPLAY_SET_CURSOR,
+    IOCALL_DISPLAY_MOVE_CURSOR,
 
     IOCALL_KEYBOARD_SET_KEYMAP,
     IOCALL_KEYBOARD_GET_KEYMAP,
@@ -62,5 +172,17 @@ enum IOCall
 
     IOCALL_NETWORK_GET_STATE,
 
+    IOCALL_STATISTICS_MAP,
+
+    IOCALL_TRACE_START,
+    IOCALL_TRACE_STOP,
+    IOCALL_TRACE_RECORD,
+    IOCALL_TRACE_READ,
+
+    IOCALL_PROFILE_START,
+    IOCALL_PROFILE_STOP,
+    IOCALL_PROFILE_READ,
+    IOCALL_PROFILE_MODULES,
+
     __IOCALL_COUNT,
 };
@@ -22,3 +22,14 @@ struct Launchpad
 
     int handles[PROCESS_HANDLE_COUNT];
 };
+
+// Handed to the dynamic loader of a program, its address is pushed on the
+// user stack right after the environment (nullptr for static programs).
+struct LaunchpadImage
+{
+    uintptr_t program_headers;
+    size_t program_header_count;
+    size_t program_header_size;
+
+    uintptr_t entry;
+};
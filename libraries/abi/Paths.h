@@ -15,3 +15,7 @@
 #define SERIAL_DEVICE_PATH DEVICE_PATH "/serial"
 
 #define UNIX_DEVICE_PATH(__device) DEVICE_PATH "/" __device
+
+#define LIBRARIES_PATH "/System/Libraries"
+
+#define DYNAMIC_LOADER_PATH LIBRARIES_PATH "/ld.so"
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <abi/Filesystem.h>
+
+#include <libsystem/Common.h>
+
+#define PROFILE_DEPTH 16
+#define PROFILE_MODULE_COUNT 16
+
+// Return addresses, innermost first, the first `kernel` of them are in the
+// kernel and the others in the process.
+struct ProfileSample
+{
+    int task;
+    uint32_t depth;
+    uint32_t kernel;
+    uintptr_t frames[PROFILE_DEPTH];
+};
+
+// Where an executable or a library was loaded in the profiled process.
+struct ProfileModule
+{
+    uintptr_t base;
+    char path[PATH_LENGTH];
+};
+
+#define PROFILE_PATH "/System/profile"
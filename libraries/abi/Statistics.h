@@ -0,0 +1,45 @@
+#pragma once
+
+#include <abi/Process.h>
+#include <abi/Task.h>
+
+#define STATISTICS_MAGIC 0x54415453 // "STAT"
+#define STATISTICS_VERSION 2
+#define STATISTICS_TASK_COUNT 256
+
+// Length of the cpu usage window, in ticks.
+#define STATISTICS_USAGE_WINDOW 1000
+
+struct TaskStatistics
+{
+    bool used;
+    bool user;
+    int id;
+    TaskState state;
+    char name[PROCESS_NAME_SIZE];
+
+    uint32_t cpu_time;  // Ticks spent on the cpu.
+    uint32_t wait_time; // Ticks spent blocked.
+    uint32_t cpu_usage; // Percentage of the last usage window.
+    uint32_t context_switches;
+
+    size_t resident_memory;
+    int handles;
+};
+
+// The page is mapped read-only in the readers, the kernel increments
+// `sequence` before and after every update so it is odd while the
+// content is being changed.
+struct SystemStatistics
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sequence;
+    uint32_t tick;
+
+    // Set while events are being captured, so tracepoints know when to record.
+    uint32_t tracing;
+
+    int task_count;
+    TaskStatistics tasks[STATISTICS_TASK_COUNT];
+};
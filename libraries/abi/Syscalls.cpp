@@ -40,6 +40,31 @@ Result hj_process_wait(int tid, int *user_exit_value)
     return __syscall(HJ_PROCESS_WAIT, (uintptr_t)tid, (uintptr_t)user_exit_value);
 }
 
+Result hj_process_load_library(const char *path, size_t size, uintptr_t *out_base)
+{
+    return __syscall(HJ_PROCESS_LOAD_LIBRARY, (uintptr_t)path, size, (uintptr_t)out_base);
+}
+
+Result hj_thread_create(uintptr_t entry, uintptr_t stack, void *argument, int *tid)
+{
+    return __syscall(HJ_THREAD_CREATE, entry, stack, (uintptr_t)argument, (uintptr_t)tid);
+}
+
+Result hj_thread_exit(int exit_value)
+{
+    return __syscall(HJ_THREAD_EXIT, (uintptr_t)exit_value);
+}
+
+Result hj_futex_wait(int *address, int expected, Timeout timeout)
+{
+    return __syscall(HJ_FUTEX_WAIT, (uintptr_t)address, (uintptr_t)expected, (uintptr_t)timeout);
+}
+
+Result hj_futex_wake(int *address, size_t count, size_t *woken)
+{
+    return __syscall(HJ_FUTEX_WAKE, (uintptr_t)address, (uintptr_t)count, (uintptr_t)woken);
+}
+
 Result hj_memory_alloc(size_t size, uintptr_t *out_address)
 {
     return __syscall(HJ_MEMORY_ALLOC, (uintptr_t)size, (uintptr_t)out_address);
@@ -183,6 +208,11 @@ Result hj_handle_stat(int handle, FileState *state)
     return __syscall(HJ_HANDLE_STAT, (uintptr_t)handle, (uintptr_t)state);
 }
 
+Result hj_handle_mmap(int handle, uintptr_t *out_address, size_t *out_size)
+{
+    return __syscall(HJ_HANDLE_MMAP, (uintptr_t)handle, (uintptr_t)out_address, (uintptr_t)out_size);
+}
+
 Result hj_handle_connect(int *handle, const char *raw_path, size_t size)
 {
     return __syscall(HJ_HANDLE_CONNECT, (uintptr_t)handle, (uintptr_t)raw_path, (uintptr_t)size);
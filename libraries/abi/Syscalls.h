@@ -10,42 +10,48 @@
 #include <abi/Launchpad.h>
 #include <abi/System.h>
 
-#define SYSCALL_LIST(__ENTRY)     \
-    __ENTRY(HJ_PROCESS_THIS)      \
-    __ENTRY(HJ_PROCESS_NAME)      \
-    __ENTRY(HJ_PROCESS_LAUNCH)    \
-    __ENTRY(HJ_PROCESS_CLONE)     \
-    __ENTRY(HJ_PROCESS_EXIT)      \
-    __ENTRY(HJ_PROCESS_CANCEL)    \
-    __ENTRY(HJ_PROCESS_SLEEP)     \
-    __ENTRY(HJ_PROCESS_WAIT)      \
-    __ENTRY(HJ_MEMORY_ALLOC)      \
-    __ENTRY(HJ_MEMORY_FREE)       \
-    __ENTRY(HJ_MEMORY_INCLUDE)    \
-    __ENTRY(HJ_MEMORY_GET_HANDLE) \
-    __ENTRY(HJ_FILESYSTEM_LINK)   \
-    __ENTRY(HJ_FILESYSTEM_UNLINK) \
-    __ENTRY(HJ_FILESYSTEM_RENAME) \
-    __ENTRY(HJ_FILESYSTEM_MKPIPE) \
-    __ENTRY(HJ_FILESYSTEM_MKDIR)  \
-    __ENTRY(HJ_SYSTEM_INFO)       \
-    __ENTRY(HJ_SYSTEM_STATUS)     \
-    __ENTRY(HJ_SYSTEM_TIME)       \
-    __ENTRY(HJ_SYSTEM_TICKS)      \
-    __ENTRY(HJ_SYSTEM_REBOOT)     \
-    __ENTRY(HJ_SYSTEM_SHUTDOWN)   \
-    __ENTRY(HJ_HANDLE_OPEN)       \
-    __ENTRY(HJ_HANDLE_CLOSE)      \
-    __ENTRY(HJ_HANDLE_POLL)       \
-    __ENTRY(HJ_HANDLE_READ)       \
-    __ENTRY(HJ_HANDLE_WRITE)      \
-    __ENTRY(HJ_HANDLE_CALL)       \
-    __ENTRY(HJ_HANDLE_SEEK)       \
-    __ENTRY(HJ_HANDLE_TELL)       \
-    __ENTRY(HJ_HANDLE_STAT)       \
-    __ENTRY(HJ_HANDLE_CONNECT)    \
-    __ENTRY(HJ_HANDLE_ACCEPT)     \
-    __ENTRY(HJ_CREATE_PIPE)       \
+#define SYSCALL_LIST(__ENTRY)        \
+    __ENTRY(HJ_PROCESS_THIS)         \
+    __ENTRY(HJ_PROCESS_NAME)         \
+    __ENTRY(HJ_PROCESS_LAUNCH)       \
+    __ENTRY(HJ_PROCESS_CLONE)        \
+    __ENTRY(HJ_PROCESS_EXIT)         \
+    __ENTRY(HJ_PROCESS_CANCEL)       \
+    __ENTRY(HJ_PROCESS_SLEEP)        \
+    __ENTRY(HJ_PROCESS_WAIT)         \
+    __ENTRY(HJ_PROCESS_LOAD_LIBRARY) \
+    __ENTRY(HJ_THREAD_CREATE)        \
+    __ENTRY(HJ_THREAD_EXIT)          \
+    __ENTRY(HJ_FUTEX_WAIT)           \
+    __ENTRY(HJ_FUTEX_WAKE)           \
+    __ENTRY(HJ_MEMORY_ALLOC)         \
+    __ENTRY(HJ_MEMORY_FREE)          \
+    __ENTRY(HJ_MEMORY_INCLUDE)       \
+    __ENTRY(HJ_MEMORY_GET_HANDLE)    \
+    __ENTRY(HJ_FILESYSTEM_LINK)      \
+    __ENTRY(HJ_FILESYSTEM_UNLINK)    \
+    __ENTRY(HJ_FILESYSTEM_RENAME)    \
+    __ENTRY(HJ_FILESYSTEM_MKPIPE)    \
+    __ENTRY(HJ_FILESYSTEM_MKDIR)     \
+    __ENTRY(HJ_SYSTEM_INFO)          \
+    __ENTRY(HJ_SYSTEM_STATUS)        \
+    __ENTRY(HJ_SYSTEM_TIME)          \
+    __ENTRY(HJ_SYSTEM_TICKS)         \
+    __ENTRY(HJ_SYSTEM_REBOOT)        \
+    __ENTRY(HJ_SYSTEM_SHUTDOWN)      \
+    __ENTRY(HJ_HANDLE_OPEN)          \
+    __ENTRY(HJ_HANDLE_CLOSE)         \
+    __ENTRY(HJ_HANDLE_POLL)          \
+    __ENTRY(HJ_HANDLE_READ)          \
+    __ENTRY(HJ_HANDLE_WRITE)         \
+    __ENTRY(HJ_HANDLE_CALL)          \
+    __ENTRY(HJ_HANDLE_SEEK)          \
+    __ENTRY(HJ_HANDLE_TELL)          \
+    __ENTRY(HJ_HANDLE_STAT)          \
+    __ENTRY(HJ_HANDLE_MMAP)          \
+    __ENTRY(HJ_HANDLE_CONNECT)       \
+    __ENTRY(HJ_HANDLE_ACCEPT)        \
+    __ENTRY(HJ_CREATE_PIPE)          \
     __ENTRY(HJ_CREATE_TERM)
 
 #define SYSCALL_ENUM_ENTRY(__entry) __entry,
@@ -117,6 +123,13 @@ Result hj_process_exit(int exit_code);
 Result hj_process_cancel(int pid);
 Result hj_process_sleep(int time);
 Result hj_process_wait(int tid, int *user_exit_value);
+Result hj_process_load_library(const char *path, size_t size, uintptr_t *out_base);
+
+Result hj_thread_create(uintptr_t entry, uintptr_t stack, void *argument, int *tid);
+Result hj_thread_exit(int exit_value);
+
+Result hj_futex_wait(int *address, int expected, Timeout timeout);
+Result hj_futex_wake(int *address, size_t count, size_t *woken);
 
 Result hj_memory_alloc(size_t size, uintptr_t *out_address);
 Result hj_memory_free(uintptr_t address);
@@ -148,6 +161,7 @@ Result hj_handle_call(int handle, IOCall request, void *args);
 Result hj_handle_seek(int handle, int offset, Whence whence);
 Result hj_handle_tell(int handle, Whence whence, int *offset);
 Result hj_handle_stat(int handle, FileState *state);
+Result hj_handle_mmap(int handle, uintptr_t *out_address, size_t *out_size);
 Result hj_handle_connect(int *handle, const char *raw_path, size_t size);
 Result hj_handle_accept(int handle, int *connection_handle);
 
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+#define TRACE_NAME_SIZE 32
+
+enum TraceKind
+{
+    TRACE_LOG,
+    TRACE_BEGIN,
+    TRACE_END,
+    TRACE_INSTANT,
+};
+
+// Timestamps are in microseconds since boot, tasks are also processes.
+struct TraceEvent
+{
+    uint64_t timestamp;
+    int task;
+    TraceKind kind;
+    long argument;
+    char name[TRACE_NAME_SIZE];
+};
+
+#define TRACE_PATH "/System/trace"
@@ -30,7 +30,7 @@ struct __packed ELF32Header
                            magic[ELF_IDENT_CLASS] == ELF_IDENT_CLASS_32 &&
                            magic[ELF_IDENT_DATA] == ELF_IDENT_DATA_LSB;
 
-        return is_magic_ok && (type == ELF_ETYPE_REL || ELF_ETYPE_EXEC) &&
+        return is_magic_ok && (type == ELF_ETYPE_REL || type == ELF_ETYPE_EXEC || type == ELF_ETYPE_DYN) &&
                version == 1 && machine == ELF_MACHINE_386;
     }
 };
@@ -69,6 +69,37 @@ struct ELF32Symbole
     uint8_t info;
     uint8_t other;
     uint16_t shndx;
+
+    uint8_t binding() { return info >> 4; }
+
+    uint8_t type() { return info & 0xf; }
+};
+
+struct __packed ELF32Dynamic
+{
+    int32_t tag;
+    uint32_t value;
+};
+
+struct __packed ELF32Relocation
+{
+    uint32_t offset;
+    uint32_t info;
+
+    uint32_t symbole() { return info >> 8; }
+
+    uint32_t type() { return info & 0xff; }
+};
+
+struct __packed ELF32RelocationAddend
+{
+    uint32_t offset;
+    uint32_t info;
+    int32_t addend;
+
+    uint32_t symbole() { return info >> 8; }
+
+    uint32_t type() { return info & 0xff; }
 };
 
 struct ELF32
@@ -77,4 +108,7 @@ struct ELF32
     using Section = ELF32Section;
     using Program = ELF32Program;
     using Symbole = ELF32Symbole;
+    using Dynamic = ELF32Dynamic;
+    using Relocation = ELF32Relocation;
+    using RelocationAddend = ELF32RelocationAddend;
 };
@@ -30,7 +30,7 @@ struct __packed ELF64Header
                            magic[ELF_IDENT_CLASS] == ELF_IDENT_CLASS_64 &&
                            magic[ELF_IDENT_DATA] == ELF_IDENT_DATA_LSB;
 
-        return is_magic_ok && (type == ELF_ETYPE_REL || ELF_ETYPE_EXEC) &&
+        return is_magic_ok && (type == ELF_ETYPE_REL || type == ELF_ETYPE_EXEC || type == ELF_ETYPE_DYN) &&
                version == 1 && machine == ELF_MACHINE_AMD64;
     }
 };
@@ -70,6 +70,37 @@ struct __packed ELF64Symbole
     uint16_t shndx;
     uint64_t value;
     uint64_t size;
+
+    uint8_t binding() { return info >> 4; }
+
+    uint8_t type() { return info & 0xf; }
+};
+
+struct __packed ELF64Dynamic
+{
+    int64_t tag;
+    uint64_t value;
+};
+
+struct __packed ELF64Relocation
+{
+    uint64_t offset;
+    uint64_t info;
+
+    uint64_t symbole() { return info >> 32; }
+
+    uint64_t type() { return info & 0xffffffff; }
+};
+
+struct __packed ELF64RelocationAddend
+{
+    uint64_t offset;
+    uint64_t info;
+    int64_t addend;
+
+    uint64_t symbole() { return info >> 32; }
+
+    uint64_t type() { return info & 0xffffffff; }
 };
 
 struct ELF64
@@ -78,4 +109,7 @@ struct ELF64
     using Section = ELF64Section;
     using Program = ELF64Program;
     using Symbole = ELF64Symbole;
+    using Dynamic = ELF64Dynamic;
+    using Relocation = ELF64Relocation;
+    using RelocationAddend = ELF64RelocationAddend;
 };
@@ -51,6 +51,14 @@
 #define ELF_FLAG_SPARCV9_PSO 0x1
 #define ELF_FLAG_SPARCV9_RMO 0x2
 
+#define ELF_PROGRAM_TYPE_NULL 0
+#define ELF_PROGRAM_TYPE_LOAD 1
+#define ELF_PROGRAM_TYPE_DYNAMIC 2
+#define ELF_PROGRAM_TYPE_INTERP 3
+#define ELF_PROGRAM_TYPE_NOTE 4
+#define ELF_PROGRAM_TYPE_SHLIB 5
+#define ELF_PROGRAM_TYPE_PHDR 6
+
 #define ELF_PROGRAM_X 0x1
 #define ELF_PROGRAM_W 0x2
 #define ELF_PROGRAM_R 0x4
@@ -68,3 +76,48 @@
 #define ELF_SECTION_TYPE_SHLIB 10
 #define ELF_SECTION_TYPE_DYNSYM 11
 #define ELF_SECTION_TYPE_COUNT 12
+
+#define ELF_SYMBOLE_UNDEFINED 0
+
+#define ELF_SYMBOLE_BINDING_LOCAL 0
+#define ELF_SYMBOLE_BINDING_GLOBAL 1
+#define ELF_SYMBOLE_BINDING_WEAK 2
+
+#define ELF_SYMBOLE_TYPE_NONE 0
+#define ELF_SYMBOLE_TYPE_OBJECT 1
+#define ELF_SYMBOLE_TYPE_FUNCTION 2
+
+#define ELF_DYNAMIC_NULL 0
+#define ELF_DYNAMIC_NEEDED 1
+#define ELF_DYNAMIC_PLTRELSZ 2
+#define ELF_DYNAMIC_PLTGOT 3
+#define ELF_DYNAMIC_HASH 4
+#define ELF_DYNAMIC_STRTAB 5
+#define ELF_DYNAMIC_SYMTAB 6
+#define ELF_DYNAMIC_RELA 7
+#define ELF_DYNAMIC_RELASZ 8
+#define ELF_DYNAMIC_RELAENT 9
+#define ELF_DYNAMIC_STRSZ 10
+#define ELF_DYNAMIC_SYMENT 11
+#define ELF_DYNAMIC_INIT 12
+#define ELF_DYNAMIC_FINI 13
+#define ELF_DYNAMIC_SONAME 14
+#define ELF_DYNAMIC_REL 17
+#define ELF_DYNAMIC_RELSZ 18
+#define ELF_DYNAMIC_RELENT 19
+#define ELF_DYNAMIC_PLTREL 20
+#define ELF_DYNAMIC_TEXTREL 22
+#define ELF_DYNAMIC_JMPREL 23
+#define ELF_DYNAMIC_INIT_ARRAY 25
+#define ELF_DYNAMIC_FINI_ARRAY 26
+#define ELF_DYNAMIC_INIT_ARRAYSZ 27
+#define ELF_DYNAMIC_FINI_ARRAYSZ 28
+
+// The i386 and x86_64 relocations we need share the same numbers.
+#define ELF_RELOCATION_NONE 0
+#define ELF_RELOCATION_ABSOLUTE 1
+#define ELF_RELOCATION_PC_RELATIVE 2
+#define ELF_RELOCATION_COPY 5
+#define ELF_RELOCATION_GLOBAL_DATA 6
+#define ELF_RELOCATION_JUMP_SLOT 7
+#define ELF_RELOCATION_RELATIVE 8
@@ -3,3 +3,6 @@ LIBS += GRAPHIC
 GRAPHIC_NAME = graphic
 
 GRAPHIC_CXXFLAGS=-O3 -mmmx -msse -msse2
+
+GRAPHIC_SHARED = true
+GRAPHIC_NEEDED = system
@@ -1,17 +1,24 @@
 #define LODEPNG_NO_COMPILE_DISK
+#define LODEPNG_NO_COMPILE_DECODER
 #define LODEPNG_NO_COMPILE_ANCILLARY_CHUNKS
 #define LODEPNG_NO_COMPILE_CPP
 #include <thirdparty/lodepng/lodepng.cpp>
 #undef LODEPNG_NO_COMPILE_CPP
 #undef LODEPNG_NO_COMPILE_ANCILLARY_CHUNKS
+#undef LODEPNG_NO_COMPILE_DECODER
 #undef LODEPNG_NO_COMPILE_DISK
 
 #include <libgraphic/Bitmap.h>
+#include <libgraphic/BitmapCache.h>
+#include <libgraphic/PngDecoder.h>
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
 #include <libsystem/Result.h>
+#include <libsystem/core/CString.h>
 #include <libsystem/io/File.h>
+#include <libsystem/io/Stream.h>
 #include <libsystem/system/Memory.h>
+#include <libutils/OwnPtr.h>
 
 static Color _placeholder_buffer[] = {
     Colors::MAGENTA,
@@ -56,52 +63,77 @@ ResultOr<RefPtr<Bitmap>> Bitmap::create_shared_from_handle(int handle, Vec2i wid
     return make<Bitmap>(handle, BITMAP_SHARED, width_and_height.x(), width_and_height.y(), pixels);
 }
 
+ResultOr<RefPtr<Bitmap>> Bitmap::create_private(int width, int height)
+{
+    Color *pixels = (Color *)malloc(width * height * sizeof(Color));
+
+    if (pixels == nullptr)
+        return ERR_OUT_OF_MEMORY;
+
+    auto bitmap = make<Bitmap>(-1, BITMAP_MALLOC, width, height, pixels);
+    bitmap->clear(Colors::BLACK);
+    return bitmap;
+}
+
 RefPtr<Bitmap> Bitmap::create_static(int width, int height, Color *pixels)
 {
     return make<Bitmap>(-1, BITMAP_STATIC, width, height, pixels);
 }
 
-ResultOr<RefPtr<Bitmap>> Bitmap::load_from(const char *path)
+Result Bitmap::make_writable()
 {
-    void *rawdata;
-    size_t rawdata_size;
-    Result result = file_read_all(path, &rawdata, &rawdata_size);
+    if (_storage != BITMAP_MAPPED)
+    {
+        return SUCCESS;
+    }
+
+    Color *pixels = nullptr;
+    Result result = memory_alloc(_width * _height * sizeof(Color), reinterpret_cast<uintptr_t *>(&pixels));
 
     if (result != SUCCESS)
-    {
         return result;
-    }
 
-    uint decoded_width = 0;
-    uint decoded_height = 0;
-    void *decoded_data = nullptr;
+    memcpy(pixels, _pixels, _width * _height * sizeof(Color));
+    memory_free(reinterpret_cast<uintptr_t>(_pixels));
+
+    _storage = BITMAP_SHARED;
+    _pixels = pixels;
+    memory_get_handle(reinterpret_cast<uintptr_t>(pixels), &_handle);
 
-    int decode_result = lodepng_decode32(
-        (unsigned char **)&decoded_data,
-        &decoded_width,
-        &decoded_height,
-        (const unsigned char *)rawdata,
-        rawdata_size);
+    return SUCCESS;
+}
+
+ResultOr<RefPtr<Bitmap>> Bitmap::load_from(const char *path)
+{
+    __cleanup(stream_cleanup) Stream *stream = stream_open(path, OPEN_READ);
 
-    if (decode_result != 0)
+    if (handle_has_error(stream))
     {
-        return ERR_BAD_IMAGE_FILE_FORMAT;
+        return handle_get_error(stream);
     }
 
-    auto bitmap_or_result = Bitmap::create_shared(decoded_width, decoded_height);
+    BitmapCacheKey key = {};
+    bool cacheable = bitmap_cache_key(stream, &key) == SUCCESS;
 
-    if (bitmap_or_result.success())
+    if (cacheable)
     {
-        auto bitmap = bitmap_or_result.take_value();
-        memcpy(bitmap->pixels(), decoded_data, sizeof(Color) * decoded_width * decoded_height);
-        free(decoded_data);
-        return bitmap;
+        auto cached_or_result = bitmap_cache_lookup(path, key);
+
+        if (cached_or_result.success())
+        {
+            return cached_or_result;
+        }
     }
-    else
+
+    auto decoder = own<PngDecoder>(stream);
+    auto bitmap_or_result = decoder->decode();
+
+    if (cacheable && bitmap_or_result.success())
     {
-        free(decoded_data);
-        return bitmap_or_result;
+        bitmap_cache_store(path, key, *bitmap_or_result.value());
     }
+
+    return bitmap_or_result;
 }
 
 RefPtr<Bitmap> Bitmap::load_from_or_placeholder(const char *path)
@@ -140,7 +172,7 @@ Result Bitmap::save_to(const char *path)
 
 Bitmap::~Bitmap()
 {
-    if (_storage == BITMAP_SHARED)
+    if (_storage == BITMAP_SHARED || _storage == BITMAP_MAPPED)
         memory_free(reinterpret_cast<uintptr_t>(_pixels));
     else if (_storage == BITMAP_MALLOC)
         free(_pixels);
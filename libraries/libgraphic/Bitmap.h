@@ -13,6 +13,8 @@ enum BitmapStorage
     BITMAP_SHARED,
     BITMAP_STATIC,
     BITMAP_MALLOC,
+    // Read-only, see make_writable().
+    BITMAP_MAPPED,
 };
 
 enum BitmapFiltering
@@ -61,8 +63,15 @@ public:
 
     static ResultOr<RefPtr<Bitmap>> create_shared_from_handle(int handle, Vec2i width_and_height);
 
+    // For bitmaps that never leave the process, they have no handle.
+    static ResultOr<RefPtr<Bitmap>> create_private(int width, int height);
+
     static RefPtr<Bitmap> create_static(int width, int height, Color *pixels);
 
+    // Mapped bitmaps are copied before the first time they are painted on,
+    // Painter does it for its target.
+    Result make_writable();
+
     static ResultOr<RefPtr<Bitmap>> load_from(const char *path);
 
     static RefPtr<Bitmap> load_from_or_placeholder(const char *path);
@@ -0,0 +1,234 @@
+#include <libgraphic/BitmapCache.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/Directory.h>
+#include <libsystem/io/File.h>
+#include <libsystem/io/Filesystem.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/system/Memory.h>
+#include <libutils/Hash.h>
+
+static bool bitmap_cache_path(const char *path, char *cache_path)
+{
+    if (path[0] != '/')
+    {
+        return false;
+    }
+
+    snprintf(cache_path, PATH_LENGTH, BITMAP_CACHE_DIRECTORY "%s", path);
+
+    return strlen(cache_path) + 1 < PATH_LENGTH;
+}
+
+Result bitmap_cache_key(Stream *stream, BitmapCacheKey *key)
+{
+    FileState state = {};
+    stream_stat(stream, &state);
+
+    // The head holds the header of the image and the tail the checksum of
+    // its last chunk, hashing them is enough to notice a changed file
+    // without reading all of it.
+    uint8_t buffer[BITMAP_CACHE_KEY_SPAN * 2];
+    size_t buffer_size = 0;
+
+    if (state.size <= sizeof(buffer))
+    {
+        buffer_size = stream_read(stream, buffer, state.size);
+    }
+    else
+    {
+        buffer_size = stream_read(stream, buffer, BITMAP_CACHE_KEY_SPAN);
+
+        stream_seek(stream, -BITMAP_CACHE_KEY_SPAN, WHENCE_END);
+        buffer_size += stream_read(stream, buffer + buffer_size, BITMAP_CACHE_KEY_SPAN);
+    }
+
+    stream_seek(stream, 0, WHENCE_START);
+
+    if (buffer_size != MIN(state.size, sizeof(buffer)))
+    {
+        return ERR_NOT_READABLE;
+    }
+
+    *key = {
+        .source_size = (uint32_t)state.size,
+        .source_hash = hash(buffer, buffer_size),
+    };
+
+    return SUCCESS;
+}
+
+ResultOr<RefPtr<Bitmap>> bitmap_cache_lookup(const char *path, BitmapCacheKey key)
+{
+    char cache_path[PATH_LENGTH];
+
+    if (!bitmap_cache_path(path, cache_path))
+    {
+        return ERR_NO_SUCH_FILE_OR_DIRECTORY;
+    }
+
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    Result result = file_map(cache_path, &buffer, &size);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (size < sizeof(BitmapCacheTrailer))
+    {
+        file_unmap(buffer);
+        filesystem_unlink(cache_path);
+
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    auto trailer = reinterpret_cast<const BitmapCacheTrailer *>((const char *)buffer + size - sizeof(BitmapCacheTrailer));
+
+    if (trailer->magic != BITMAP_CACHE_MAGIC ||
+        trailer->version != BITMAP_CACHE_VERSION ||
+        trailer->key.source_size != key.source_size ||
+        trailer->key.source_hash != key.source_hash ||
+        (size_t)trailer->width * trailer->height * sizeof(Color) + sizeof(BitmapCacheTrailer) != size)
+    {
+        file_unmap(buffer);
+
+        // Stale or broken, it would only take space.
+        filesystem_unlink(cache_path);
+
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    // The bitmap is the mapping itself, every process that loads the image
+    // shares the pages until it paints on it.
+    int handle = -1;
+    memory_get_handle(reinterpret_cast<uintptr_t>(buffer), &handle);
+
+    return make<Bitmap>(handle, BITMAP_MAPPED, trailer->width, trailer->height, (Color *)buffer);
+}
+
+static size_t _bitmap_cache_usage = 0;
+static bool _bitmap_cache_usage_known = false;
+
+static size_t bitmap_cache_usage(const char *path)
+{
+    Directory *directory = directory_open(path, OPEN_READ);
+
+    if (handle_has_error(directory))
+    {
+        directory_close(directory);
+        return 0;
+    }
+
+    size_t usage = 0;
+    DirectoryEntry entry;
+
+    while (directory_read(directory, &entry) > 0)
+    {
+        if (entry.stat.type == FILE_TYPE_DIRECTORY)
+        {
+            char child_path[PATH_LENGTH];
+            snprintf(child_path, PATH_LENGTH, "%s/%s", path, entry.name);
+
+            usage += bitmap_cache_usage(child_path);
+        }
+        else
+        {
+            usage += entry.stat.size;
+        }
+    }
+
+    directory_close(directory);
+
+    return usage;
+}
+
+static void bitmap_cache_create_directories(const char *cache_path)
+{
+    char directory[PATH_LENGTH];
+
+    for (size_t i = 1; cache_path[i]; i++)
+    {
+        if (cache_path[i] == '/')
+        {
+            memcpy(directory, cache_path, i);
+            directory[i] = '\0';
+
+            filesystem_mkdir(directory);
+        }
+    }
+}
+
+void bitmap_cache_store(const char *path, BitmapCacheKey key, Bitmap &bitmap)
+{
+    char cache_path[PATH_LENGTH];
+
+    if (!bitmap_cache_path(path, cache_path))
+    {
+        return;
+    }
+
+    size_t pixels_size = bitmap.width() * bitmap.height() * sizeof(Color);
+
+    // The cache is walked once per process and the total kept up to date
+    // from there, entries written by other processes since are not counted.
+    if (!_bitmap_cache_usage_known)
+    {
+        _bitmap_cache_usage = bitmap_cache_usage(BITMAP_CACHE_DIRECTORY);
+        _bitmap_cache_usage_known = true;
+    }
+
+    size_t entry_size = pixels_size + sizeof(BitmapCacheTrailer);
+
+    // Nothing gets evicted, entries are small next to the limit and stale
+    // ones are removed when looked up.
+    if (_bitmap_cache_usage + entry_size > BITMAP_CACHE_LIMIT)
+    {
+        return;
+    }
+
+    bitmap_cache_create_directories(cache_path);
+
+    // Write to a temporary file first so other processes never map a
+    // partially written entry.
+    char temporary_path[PATH_LENGTH];
+    snprintf(temporary_path, PATH_LENGTH, "%s.%d", cache_path, process_this());
+
+    Stream *stream = stream_open(temporary_path, OPEN_WRITE | OPEN_CREATE | OPEN_TRUNC);
+
+    if (handle_has_error(stream))
+    {
+        stream_close(stream);
+        return;
+    }
+
+    BitmapCacheTrailer trailer = {
+        .magic = BITMAP_CACHE_MAGIC,
+        .version = BITMAP_CACHE_VERSION,
+        .width = (uint32_t)bitmap.width(),
+        .height = (uint32_t)bitmap.height(),
+        .key = key,
+    };
+
+    bool written = stream_write(stream, bitmap.pixels(), pixels_size) == pixels_size &&
+                   stream_write(stream, &trailer, sizeof(trailer)) == sizeof(trailer);
+
+    stream_close(stream);
+
+    if (written)
+    {
+        // Replace any stale entry, processes that mapped it keep their copy.
+        filesystem_unlink(cache_path);
+    }
+
+    if (!written || filesystem_rename(temporary_path, cache_path) != SUCCESS)
+    {
+        filesystem_unlink(temporary_path);
+        return;
+    }
+
+    _bitmap_cache_usage += entry_size;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <libgraphic/Bitmap.h>
+#include <libsystem/io/Stream.h>
+
+// Decoded bitmaps are kept as plain files in the ramdisk, so an image is
+// decoded once per boot instead of once per process. The file holds the raw
+// pixels followed by a trailer. Entries are either written the first time an
+// image is decoded or generated at build time by toolbox/bitmap-cache.py.
+//
+// Entries are keyed on the size of the source file and a hash of its first
+// and last BITMAP_CACHE_KEY_SPAN bytes, there are no modification times to
+// compare. A hit is a read-only bitmap over the mapping of the entry, so
+// processes loading the same image share its pages.
+//
+// The ramdisk is memory, the cache stops taking new entries once it holds
+// BITMAP_CACHE_LIMIT bytes. That is enough for a full HD wallpaper (8MB)
+// and the icons and cursors around it.
+
+#define BITMAP_CACHE_DIRECTORY "/System/Caches/Bitmaps"
+
+#define BITMAP_CACHE_LIMIT (16 * 1024 * 1024)
+
+#define BITMAP_CACHE_MAGIC 0x48434d42 /* BMCH */
+#define BITMAP_CACHE_VERSION 3
+
+#define BITMAP_CACHE_KEY_SPAN 1024
+
+struct BitmapCacheKey
+{
+    uint32_t source_size;
+    uint32_t source_hash;
+};
+
+struct BitmapCacheTrailer
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    BitmapCacheKey key;
+};
+
+// Leaves the stream at its start.
+Result bitmap_cache_key(Stream *stream, BitmapCacheKey *key);
+
+ResultOr<RefPtr<Bitmap>> bitmap_cache_lookup(const char *path, BitmapCacheKey key);
+
+void bitmap_cache_store(const char *path, BitmapCacheKey key, Bitmap &bitmap);
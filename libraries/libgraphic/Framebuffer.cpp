@@ -6,6 +6,8 @@
 #include <libsystem/Logger.h>
 #include <libsystem/Result.h>
 #include <libsystem/core/Plugs.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/system/Memory.h>
 
 ResultOr<OwnPtr<Framebuffer>> Framebuffer::open()
 {
@@ -40,13 +42,85 @@ Framebuffer::Framebuffer(Handle handle, RefPtr<Bitmap> bitmap)
       _bitmap(bitmap),
       _painter(bitmap)
 {
+    map_scanout();
 }
 
 Framebuffer::~Framebuffer()
 {
+    unmap_scanout();
     __plug_handle_close(&_handle);
 }
 
+bool Framebuffer::attach_scanout()
+{
+    IOCallDisplayAttachArgs args = {_bitmap->handle(), _bitmap->width(), _bitmap->height()};
+
+    __plug_handle_call(&_handle, IOCALL_DISPLAY_ATTACH, &args);
+
+    if (handle_has_error(&_handle))
+    {
+        handle_clear_error(&_handle);
+        _attached = false;
+    }
+    else
+    {
+        _attached = true;
+    }
+
+    return _attached;
+}
+
+void Framebuffer::map_scanout()
+{
+    if (attach_scanout())
+    {
+        return;
+    }
+
+    IOCallDisplayMapArgs args = {};
+
+    __plug_handle_call(&_handle, IOCALL_DISPLAY_MAP, &args);
+
+    if (handle_has_error(&_handle))
+    {
+        logger_warn("Failed to map the framebuffer, falling back to blit iocalls: %s", handle_error_string(&_handle));
+        handle_clear_error(&_handle);
+        return;
+    }
+
+    _scanout = reinterpret_cast<uint32_t *>(args.address);
+    _scanout_size = args.size;
+    _scanout_pitch = args.pitch;
+    _scanout_buffers = MAX(1, args.buffers);
+
+    // The device always shows the first buffer after a mode set.
+    _back_buffer = _scanout_buffers > 1 ? 1 : 0;
+    _previous_dirty_bounds.clear();
+}
+
+void Framebuffer::unmap_scanout()
+{
+    if (_scanout)
+    {
+        memory_free(reinterpret_cast<uintptr_t>(_scanout));
+        _scanout = nullptr;
+    }
+}
+
+// Plain shifts and masks over a whole row, the compiler turns this into
+// SSE2 code since libgraphic is built with -msse2.
+static void convert_row(const uint32_t *source, uint32_t *destination, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t pixel = source[i];
+
+        destination[i] = ((pixel >> 16) & 0x000000ff) |
+                         ((pixel)&0xff00ff00) |
+                         ((pixel << 16) & 0x00ff0000);
+    }
+}
+
 Result Framebuffer::set_resolution(Vec2i size)
 {
     auto bitmap_or_result = Bitmap::create_shared(size.x(), size.y());
@@ -68,6 +142,10 @@ Result Framebuffer::set_resolution(Vec2i size)
     _bitmap = bitmap_or_result.take_value();
     _painter = Painter(_bitmap);
 
+    // The pitch of the framebuffer might have changed with the mode.
+    unmap_scanout();
+    map_scanout();
+
     return SUCCESS;
 }
 
@@ -109,12 +187,104 @@ void Framebuffer::mark_dirty_all()
     mark_dirty(_bitmap->bound());
 }
 
+void Framebuffer::present_to_scanout(Rectangle bound, int buffer)
+{
+    auto pixels = reinterpret_cast<const uint32_t *>(_bitmap->pixels());
+
+    for (int y = bound.top(); y < bound.bottom(); y++)
+    {
+        size_t row = (size_t)buffer * _bitmap->height() + y;
+
+        if ((row + 1) * _scanout_pitch > _scanout_size)
+        {
+            break;
+        }
+
+        convert_row(
+            pixels + y * _bitmap->width() + bound.x(),
+            reinterpret_cast<uint32_t *>((uint8_t *)_scanout + row * _scanout_pitch) + bound.x(),
+            bound.width());
+    }
+}
+
+void Framebuffer::flip()
+{
+    // The back buffer missed the previous frame, catch it up before showing it.
+    _previous_dirty_bounds.foreach ([&](auto &bound) {
+        present_to_scanout(bound, _back_buffer);
+        return Iteration::CONTINUE;
+    });
+
+    IOCallDisplayFlipArgs args = {_back_buffer};
+
+    __plug_handle_call(&_handle, IOCALL_DISPLAY_FLIP, &args);
+
+    if (handle_has_error(&_handle))
+    {
+        logger_warn("Failed to flip the framebuffer, falling back to a single buffer: %s", handle_error_string(&_handle));
+        handle_clear_error(&_handle);
+
+        _scanout_buffers = 1;
+        _back_buffer = 0;
+        _previous_dirty_bounds.clear();
+
+        mark_dirty_all();
+        _dirty_bounds.foreach ([&](auto &bound) {
+            present_to_scanout(bound, _back_buffer);
+            return Iteration::CONTINUE;
+        });
+
+        return;
+    }
+
+    _back_buffer = (_back_buffer + 1) % _scanout_buffers;
+    _previous_dirty_bounds = _dirty_bounds;
+}
+
 void Framebuffer::blit()
 {
     if (_dirty_bounds.empty())
     {
         return;
     }
+
+    if (_attached)
+    {
+        _dirty_bounds.foreach ([&](auto &bound) {
+            IOCallDisplayFlushArgs args = {bound.x(), bound.y(), bound.width(), bound.height()};
+
+            __plug_handle_call(&_handle, IOCALL_DISPLAY_FLUSH, &args);
+
+            if (handle_has_error(&_handle))
+            {
+                handle_printf_error(&_handle, "Failed to iocall device " FRAMEBUFFER_DEVICE_PATH);
+            }
+
+            return Iteration::CONTINUE;
+        });
+
+        _dirty_bounds.clear();
+
+        return;
+    }
+
+    if (_scanout)
+    {
+        _dirty_bounds.foreach ([&](auto &bound) {
+            present_to_scanout(bound, _back_buffer);
+            return Iteration::CONTINUE;
+        });
+
+        if (_scanout_buffers > 1)
+        {
+            flip();
+        }
+
+        _dirty_bounds.clear();
+
+        return;
+    }
+
     _dirty_bounds.foreach ([&](auto &bound) {
         IOCallDisplayBlitArgs args;
 
@@ -139,3 +309,37 @@ void Framebuffer::blit()
 
     _dirty_bounds.clear();
 }
+
+Result Framebuffer::set_cursor(Bitmap &bitmap, Vec2i hotspot)
+{
+    IOCallDisplayCursorArgs args = {
+        reinterpret_cast<uint32_t *>(bitmap.pixels()),
+        bitmap.width(),
+        bitmap.height(),
+        hotspot.x(),
+        hotspot.y(),
+    };
+
+    __plug_handle_call(&_handle, IOCALL_DISPLAY_SET_CURSOR, &args);
+
+    if (handle_has_error(&_handle))
+    {
+        Result result = handle_get_error(&_handle);
+        handle_clear_error(&_handle);
+        return result;
+    }
+
+    return SUCCESS;
+}
+
+void Framebuffer::move_cursor(Vec2i position)
+{
+    IOCallDisplayCursorPositionArgs args = {position.x(), position.y()};
+
+    __plug_handle_call(&_handle, IOCALL_DISPLAY_MOVE_CURSOR, &args);
+
+    if (handle_has_error(&_handle))
+    {
+        handle_clear_error(&_handle);
+    }
+}
@@ -15,6 +15,32 @@ private:
 
     Vector<Rectangle> _dirty_bounds{};
 
+    // Linear framebuffer mapped in our address space, we fall back to
+    // IOCALL_DISPLAY_BLIT when the device doesn't support it.
+    uint32_t *_scanout = nullptr;
+    size_t _scanout_size = 0;
+    int _scanout_pitch = 0;
+
+    // With page flipping we draw into the hidden buffer, which is two
+    // frames old, so it also needs what was repainted in the last frame.
+    int _scanout_buffers = 1;
+    int _back_buffer = 0;
+    Vector<Rectangle> _previous_dirty_bounds{};
+
+    // Devices with host side scanout read our bitmap directly and only need
+    // to be told which regions changed.
+    bool _attached = false;
+
+    bool attach_scanout();
+
+    void map_scanout();
+
+    void unmap_scanout();
+
+    void present_to_scanout(Rectangle bound, int buffer);
+
+    void flip();
+
 public:
     static ResultOr<OwnPtr<Framebuffer>> open();
 
@@ -33,4 +59,8 @@ public:
     void mark_dirty_all();
 
     void blit();
+
+    Result set_cursor(Bitmap &bitmap, Vec2i hotspot);
+
+    void move_cursor(Vec2i position);
 };
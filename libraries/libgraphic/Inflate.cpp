@@ -0,0 +1,524 @@
+#include <libgraphic/Inflate.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+
+static constexpr uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+
+static constexpr uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+static constexpr uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+static constexpr uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static constexpr uint8_t CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+static inline uint32_t reverse16(uint32_t value)
+{
+    value = ((value & 0xAAAA) >> 1) | ((value & 0x5555) << 1);
+    value = ((value & 0xCCCC) >> 2) | ((value & 0x3333) << 2);
+    value = ((value & 0xF0F0) >> 4) | ((value & 0x0F0F) << 4);
+    value = ((value & 0xFF00) >> 8) | ((value & 0x00FF) << 8);
+
+    return value;
+}
+
+uint8_t Inflate::next_byte()
+{
+    if (_input_size == 0)
+    {
+        _input_size = _reader(&_input);
+
+        if (_input_size == 0)
+        {
+            _overread++;
+            return 0;
+        }
+    }
+
+    _input_size--;
+    return *_input++;
+}
+
+void Inflate::fill_bits()
+{
+    while (_bit_count <= 24)
+    {
+        _bits |= (uint32_t)next_byte() << _bit_count;
+        _bit_count += 8;
+    }
+}
+
+uint32_t Inflate::read_bits(int count)
+{
+    if (_bit_count < count)
+    {
+        fill_bits();
+    }
+
+    uint32_t value = _bits & ((1u << count) - 1);
+    _bits >>= count;
+    _bit_count -= count;
+
+    return value;
+}
+
+void Inflate::align_to_byte()
+{
+    read_bits(_bit_count % 8);
+}
+
+int Inflate::decode_symbol(Huffman &huffman)
+{
+    if (_bit_count < 16)
+    {
+        fill_bits();
+    }
+
+    int entry = huffman.fast[_bits & FAST_MASK];
+
+    if (entry)
+    {
+        int length = entry >> 9;
+        _bits >>= length;
+        _bit_count -= length;
+
+        return entry & 511;
+    }
+
+    // The code is longer than the fast table, walk the canonical code
+    // lengths instead. Huffman codes are stored most significant bit
+    // first, so the bits are reversed before being compared.
+    uint32_t code = reverse16(_bits & 0xffff);
+
+    int length = FAST_BITS + 1;
+
+    while (code >= huffman.max_code[length])
+    {
+        length++;
+    }
+
+    if (length >= 16)
+    {
+        return -1;
+    }
+
+    int index = (code >> (16 - length)) - huffman.first_code[length] + huffman.first_symbol[length];
+
+    if (index >= 288 || huffman.lengths[index] != length)
+    {
+        return -1;
+    }
+
+    _bits >>= length;
+    _bit_count -= length;
+
+    return huffman.symbols[index];
+}
+
+Result Inflate::build_huffman(Huffman &huffman, const uint8_t *lengths, int count)
+{
+    int sizes[17] = {};
+    uint32_t next_code[16] = {};
+
+    memset(huffman.fast, 0, sizeof(huffman.fast));
+
+    for (int i = 0; i < count; i++)
+    {
+        sizes[lengths[i]]++;
+    }
+
+    sizes[0] = 0;
+
+    uint32_t code = 0;
+    int symbol = 0;
+
+    for (int i = 1; i < 16; i++)
+    {
+        if (sizes[i] > (1 << i))
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        next_code[i] = code;
+        huffman.first_code[i] = code;
+        huffman.first_symbol[i] = symbol;
+
+        code += sizes[i];
+
+        if (sizes[i] && code - 1 >= (1u << i))
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        huffman.max_code[i] = code << (16 - i);
+
+        code <<= 1;
+        symbol += sizes[i];
+    }
+
+    huffman.max_code[16] = 0x10000;
+
+    for (int i = 0; i < count; i++)
+    {
+        int length = lengths[i];
+
+        if (length == 0)
+        {
+            continue;
+        }
+
+        int index = next_code[length] - huffman.first_code[length] + huffman.first_symbol[length];
+
+        huffman.lengths[index] = length;
+        huffman.symbols[index] = i;
+
+        if (length <= FAST_BITS)
+        {
+            for (uint32_t j = reverse16(next_code[length]) >> (16 - length); j < (1u << FAST_BITS); j += (1u << length))
+            {
+                huffman.fast[j] = (length << 9) | i;
+            }
+        }
+
+        next_code[length]++;
+    }
+
+    return SUCCESS;
+}
+
+void Inflate::flush()
+{
+    size_t start = _flushed & WINDOW_MASK;
+    size_t size = _position - _flushed;
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    const uint8_t *data = _window + start;
+    size_t remaining = size;
+
+    while (remaining > 0)
+    {
+        // 5552 is the largest run that cannot overflow the 32bits sums.
+        size_t run = MIN(remaining, 5552u);
+
+        for (size_t i = 0; i < run; i++)
+        {
+            _adler_a += data[i];
+            _adler_b += _adler_a;
+        }
+
+        _adler_a %= 65521;
+        _adler_b %= 65521;
+
+        data += run;
+        remaining -= run;
+    }
+
+    if (_result == SUCCESS)
+    {
+        _result = _writer(_window + start, size);
+    }
+
+    _flushed = _position;
+}
+
+Result Inflate::stored_block()
+{
+    align_to_byte();
+
+    uint32_t length = read_bits(16);
+    uint32_t length_complement = read_bits(16);
+
+    if ((length ^ 0xffff) != length_complement)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    // Drain what is left in the bit buffer before copying straight from the input.
+    while (length > 0 && _bit_count >= 8)
+    {
+        put(read_bits(8));
+        length--;
+    }
+
+    while (length > 0)
+    {
+        if (_input_size == 0)
+        {
+            _input_size = _reader(&_input);
+
+            if (_input_size == 0)
+            {
+                return ERR_BAD_IMAGE_FILE_FORMAT;
+            }
+        }
+
+        size_t space = WINDOW_SIZE - (_position & WINDOW_MASK);
+        size_t chunk = MIN(MIN((size_t)length, _input_size), space);
+
+        memcpy(_window + (_position & WINDOW_MASK), _input, chunk);
+
+        _input += chunk;
+        _input_size -= chunk;
+        _position += chunk;
+        length -= chunk;
+
+        if ((_position & WINDOW_MASK) == 0)
+        {
+            flush();
+        }
+    }
+
+    return _result;
+}
+
+Result Inflate::fixed_block()
+{
+    uint8_t lengths[288];
+
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+
+    build_huffman(_literals, lengths, 288);
+
+    memset(lengths, 5, 32);
+
+    build_huffman(_distances, lengths, 32);
+
+    return huffman_block();
+}
+
+Result Inflate::dynamic_block()
+{
+    int literal_count = read_bits(5) + 257;
+    int distance_count = read_bits(5) + 1;
+    int code_length_count = read_bits(4) + 4;
+
+    uint8_t code_lengths[19] = {};
+
+    for (int i = 0; i < code_length_count; i++)
+    {
+        code_lengths[CODE_LENGTH_ORDER[i]] = read_bits(3);
+    }
+
+    // The distance table is free until the end of the header, use it to
+    // decode the code lengths.
+    Result result = build_huffman(_distances, code_lengths, 19);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    uint8_t lengths[288 + 32];
+    int total = literal_count + distance_count;
+    int count = 0;
+
+    while (count < total)
+    {
+        int symbol = decode_symbol(_distances);
+
+        if (symbol < 0 || symbol >= 19)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        if (symbol < 16)
+        {
+            lengths[count++] = symbol;
+            continue;
+        }
+
+        uint8_t fill = 0;
+        int repeat = 0;
+
+        if (symbol == 16)
+        {
+            if (count == 0)
+            {
+                return ERR_BAD_IMAGE_FILE_FORMAT;
+            }
+
+            fill = lengths[count - 1];
+            repeat = 3 + read_bits(2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + read_bits(3);
+        }
+        else
+        {
+            repeat = 11 + read_bits(7);
+        }
+
+        if (count + repeat > total)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        memset(lengths + count, fill, repeat);
+        count += repeat;
+    }
+
+    result = build_huffman(_literals, lengths, literal_count);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    result = build_huffman(_distances, lengths + literal_count, distance_count);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    return huffman_block();
+}
+
+Result Inflate::huffman_block()
+{
+    while (_result == SUCCESS)
+    {
+        // The bit buffer is never more than 4 bytes ahead, past that we are
+        // decoding the zero padding of a truncated stream.
+        if (_overread > 4)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        int symbol = decode_symbol(_literals);
+
+        if (symbol < 0)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        if (symbol < 256)
+        {
+            put(symbol);
+            continue;
+        }
+
+        if (symbol == 256)
+        {
+            return SUCCESS;
+        }
+
+        symbol -= 257;
+
+        if (symbol >= 29)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        size_t length = LENGTH_BASE[symbol] + read_bits(LENGTH_EXTRA[symbol]);
+
+        symbol = decode_symbol(_distances);
+
+        if (symbol < 0 || symbol >= 30)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        size_t distance = DISTANCE_BASE[symbol] + read_bits(DISTANCE_EXTRA[symbol]);
+
+        if (distance > _position)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        size_t from = _position - distance;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            put(_window[(from + i) & WINDOW_MASK]);
+        }
+    }
+
+    return _result;
+}
+
+Result Inflate::perform()
+{
+    uint32_t method = read_bits(8);
+    uint32_t flags = read_bits(8);
+
+    if ((method & 15) != 8 ||
+        (method >> 4) > 7 ||
+        ((method << 8) | flags) % 31 != 0 ||
+        (flags & 32))
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    bool final = false;
+
+    while (!final)
+    {
+        final = read_bits(1);
+        uint32_t type = read_bits(2);
+
+        Result result = ERR_BAD_IMAGE_FILE_FORMAT;
+
+        if (type == 0)
+        {
+            result = stored_block();
+        }
+        else if (type == 1)
+        {
+            result = fixed_block();
+        }
+        else if (type == 2)
+        {
+            result = dynamic_block();
+        }
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    flush();
+
+    if (_result != SUCCESS)
+    {
+        return _result;
+    }
+
+    align_to_byte();
+
+    uint32_t checksum = read_bits(8) << 24;
+    checksum |= read_bits(8) << 16;
+    checksum |= read_bits(8) << 8;
+    checksum |= read_bits(8);
+
+    // Some of the bytes we just consumed were padding, the stream is truncated.
+    if (_overread * 8 > (size_t)_bit_count)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    if (checksum != ((_adler_b << 16) | _adler_a))
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    return SUCCESS;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <libsystem/Result.h>
+#include <libutils/Callback.h>
+
+// Streaming decoder for zlib (RFC 1950) wrapped DEFLATE (RFC 1951) data.
+// Compressed bytes are pulled from the reader as they are needed and the
+// decompressed bytes are pushed to the writer every time the 32Kio history
+// window fills up, so neither side needs to be fully held in memory.
+class Inflate
+{
+public:
+    // Returns a pointer to the next chunk of compressed data and its size, or
+    // zero at the end of the input.
+    using Reader = Callback<size_t(const uint8_t **data)>;
+
+    using Writer = Callback<Result(const uint8_t *data, size_t size)>;
+
+private:
+    static constexpr size_t WINDOW_SIZE = 32768;
+    static constexpr size_t WINDOW_MASK = WINDOW_SIZE - 1;
+
+    static constexpr int FAST_BITS = 9;
+    static constexpr int FAST_MASK = (1 << FAST_BITS) - 1;
+
+    struct Huffman
+    {
+        // (length << 9) | symbol for codes of at most FAST_BITS bits, 0 otherwise.
+        uint16_t fast[1 << FAST_BITS];
+
+        uint16_t first_code[16];
+        uint16_t first_symbol[16];
+        uint32_t max_code[17];
+
+        uint8_t lengths[288];
+        uint16_t symbols[288];
+    };
+
+    Reader _reader;
+    Writer _writer;
+
+    const uint8_t *_input = nullptr;
+    size_t _input_size = 0;
+    size_t _overread = 0;
+
+    uint32_t _bits = 0;
+    int _bit_count = 0;
+
+    uint8_t _window[WINDOW_SIZE];
+    size_t _position = 0;
+    size_t _flushed = 0;
+
+    uint32_t _adler_a = 1;
+    uint32_t _adler_b = 0;
+
+    Result _result = SUCCESS;
+
+    Huffman _literals;
+    Huffman _distances;
+
+    uint8_t next_byte();
+
+    void fill_bits();
+
+    uint32_t read_bits(int count);
+
+    void align_to_byte();
+
+    int decode_symbol(Huffman &huffman);
+
+    Result build_huffman(Huffman &huffman, const uint8_t *lengths, int count);
+
+    void flush();
+
+    void put(uint8_t byte)
+    {
+        _window[_position & WINDOW_MASK] = byte;
+        _position++;
+
+        if ((_position & WINDOW_MASK) == 0)
+        {
+            flush();
+        }
+    }
+
+    Result stored_block();
+
+    Result fixed_block();
+
+    Result dynamic_block();
+
+    Result huffman_block();
+
+public:
+    Inflate(Reader reader, Writer writer)
+        : _reader(move(reader)), _writer(move(writer))
+    {
+    }
+
+    Result perform();
+
+    size_t total_out() { return _position; }
+};
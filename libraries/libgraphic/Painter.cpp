@@ -2,10 +2,15 @@
 #include <libgraphic/Painter.h>
 #include <libgraphic/StackBlur.h>
 #include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
 #include <libsystem/math/Math.h>
+#include <libsystem/thread/ThreadPool.h>
 
 Painter::Painter(RefPtr<Bitmap> bitmap)
 {
+    Result result = bitmap->make_writable();
+    assert(result == SUCCESS);
+
     _bitmap = bitmap;
     _state_stack_top = 0;
     _state_stack[0] = {
@@ -62,6 +67,29 @@ Rectangle Painter::apply_transform(Rectangle rectangle)
     return rectangle.offset(_state_stack[_state_stack_top].origine);
 }
 
+// The rectangle is already transformed and clipped. Bands don't share any
+// pixel, so they can be drawn in any order.
+template <typename TCallback>
+void Painter::tiles(Rectangle rectangle, TCallback callback)
+{
+    if (_pool == nullptr || rectangle.area() < PAINTER_PARALLEL_AREA)
+    {
+        callback(rectangle);
+        return;
+    }
+
+    for (int y = 0; y < rectangle.height(); y += PAINTER_TILE_HEIGHT)
+    {
+        Rectangle tile = rectangle.cutoff_top(y).take_top(MIN(PAINTER_TILE_HEIGHT, rectangle.height() - y));
+
+        _pool->submit([&callback, tile]() {
+            callback(tile);
+        });
+    }
+
+    _pool->wait();
+}
+
 void Painter::plot_pixel(Vec2i position, Color color)
 {
     Vec2i transformed = position + _state_stack[_state_stack_top].origine;
@@ -83,17 +111,21 @@ void Painter::blit_bitmap_fast(Bitmap &bitmap, Rectangle source, Rectangle desti
     if (clipped_destination.is_empty())
         return;
 
-    for (int x = 0; x < clipped_destination.width(); x++)
-    {
-        for (int y = 0; y < clipped_destination.height(); y++)
+    Vec2i offset = clipped_source.position() - clipped_destination.position();
+
+    tiles(clipped_destination, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
         {
-            Vec2i position(x, y);
+            for (int x = tile.left(); x < tile.right(); x++)
+            {
+                Vec2i position(x, y);
 
-            Color sample = bitmap.get_pixel(clipped_source.position() + position);
+                Color sample = bitmap.get_pixel(position + offset);
 
-            _bitmap->blend_pixel(clipped_destination.position() + position, sample);
+                _bitmap->blend_pixel(position, sample);
+            }
         }
-    }
+    });
 }
 
 void Painter::blit_bitmap_scaled(Bitmap &bitmap, Rectangle source, Rectangle destination)
@@ -101,17 +133,26 @@ void Painter::blit_bitmap_scaled(Bitmap &bitmap, Rectangle source, Rectangle des
     if (destination.is_empty())
         return;
 
-    for (int x = 0; x < destination.width(); x++)
-    {
-        for (int y = 0; y < destination.height(); y++)
+    Rectangle transformed_destination = apply_transform(destination);
+    Rectangle clipped_destination = apply_clip(transformed_destination);
+
+    if (clipped_destination.is_empty())
+        return;
+
+    // Only what ends up inside the clip is sampled.
+    tiles(clipped_destination, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
         {
-            float xx = x / (float)destination.width();
-            float yy = y / (float)destination.height();
+            for (int x = tile.left(); x < tile.right(); x++)
+            {
+                float xx = (x - transformed_destination.x()) / (float)destination.width();
+                float yy = (y - transformed_destination.y()) / (float)destination.height();
 
-            Color sample = bitmap.sample(source, Vec2f(xx, yy));
-            plot_pixel(destination.position() + Vec2i(x, y), sample);
+                Color sample = bitmap.sample(source, Vec2f(xx, yy));
+                _bitmap->blend_pixel_no_check(Vec2i(x, y), sample);
+            }
         }
-    }
+    });
 }
 
 __flatten void Painter::blit_bitmap(Bitmap &bitmap, Rectangle source, Rectangle destination)
@@ -141,31 +182,46 @@ void Painter::blit_bitmap_fast_no_alpha(Bitmap &bitmap, Rectangle source, Rectan
     if (clipped_destination.is_empty())
         return;
 
-    for (int x = 0; x < clipped_destination.width(); x++)
-    {
-        for (int y = 0; y < clipped_destination.height(); y++)
+    Vec2i offset = clipped_source.position() - clipped_destination.position();
+
+    tiles(clipped_destination, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
         {
-            Vec2i position(x, y);
+            for (int x = tile.left(); x < tile.right(); x++)
+            {
+                Vec2i position(x, y);
 
-            Color sample = bitmap.get_pixel(clipped_source.position() + position);
-            _bitmap->set_pixel_no_check(clipped_destination.position() + position, sample.with_alpha(1));
+                Color sample = bitmap.get_pixel(position + offset);
+                _bitmap->set_pixel_no_check(position, sample.with_alpha(1));
+            }
         }
-    }
+    });
 }
 
 void Painter::blit_bitmap_scaled_no_alpha(Bitmap &bitmap, Rectangle source, Rectangle destination)
 {
-    for (int x = 0; x < destination.width(); x++)
-    {
-        for (int y = 0; y < destination.height(); y++)
+    if (destination.is_empty())
+        return;
+
+    Rectangle transformed_destination = apply_transform(destination);
+    Rectangle clipped_destination = apply_clip(transformed_destination);
+
+    if (clipped_destination.is_empty())
+        return;
+
+    tiles(clipped_destination, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
         {
-            float xx = x / (float)destination.width();
-            float yy = y / (float)destination.height();
+            for (int x = tile.left(); x < tile.right(); x++)
+            {
+                float xx = (x - transformed_destination.x()) / (float)destination.width();
+                float yy = (y - transformed_destination.y()) / (float)destination.height();
 
-            Color sample = bitmap.sample(source, Vec2f(xx, yy));
-            plot_pixel(destination.position() + Vec2i(x, y), sample);
+                Color sample = bitmap.sample(source, Vec2f(xx, yy));
+                _bitmap->blend_pixel_no_check(Vec2i(x, y), sample);
+            }
         }
-    }
+    });
 }
 
 __flatten void Painter::blit_bitmap_no_alpha(Bitmap &bitmap, Rectangle source, Rectangle destination)
@@ -181,6 +237,30 @@ __flatten void Painter::blit_bitmap_no_alpha(Bitmap &bitmap, Rectangle source, R
     }
 }
 
+void Painter::blit_bitmap_copy(Bitmap &bitmap, Rectangle source, Rectangle destination)
+{
+    Rectangle clipped_destination = apply_transform(destination);
+    clipped_destination = apply_clip(clipped_destination);
+
+    Vec2i offset = source.position() - apply_transform(destination).position();
+
+    // Rows are copied straight from memory, so nothing may be read past the
+    // edges of the source.
+    clipped_destination = clipped_destination.clipped_with(bitmap.bound().offset(-offset));
+
+    if (clipped_destination.is_empty())
+        return;
+
+    tiles(clipped_destination, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
+        {
+            memcpy(&_bitmap->pixels()[y * _bitmap->width() + tile.left()],
+                   &bitmap.pixels()[(y + offset.y()) * bitmap.width() + tile.left() + offset.x()],
+                   tile.width() * sizeof(Color));
+        }
+    });
+}
+
 __flatten void Painter::clear(Color color)
 {
     clear_rectangle(_bitmap->bound(), color);
@@ -196,13 +276,15 @@ __flatten void Painter::clear_rectangle(Rectangle rectangle, Color color)
         return;
     }
 
-    for (int x = 0; x < rectangle.width(); x++)
-    {
-        for (int y = 0; y < rectangle.height(); y++)
+    tiles(rectangle, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
         {
-            _bitmap->set_pixel_no_check(Vec2i(rectangle.x() + x, rectangle.y() + y), color);
+            for (int x = tile.left(); x < tile.right(); x++)
+            {
+                _bitmap->set_pixel_no_check(Vec2i(x, y), color);
+            }
         }
-    }
+    });
 }
 
 __flatten void Painter::fill_rectangle(Rectangle rectangle, Color color)
@@ -215,14 +297,15 @@ __flatten void Painter::fill_rectangle(Rectangle rectangle, Color color)
         return;
     }
 
-    for (int x = 0; x < rectangle.width(); x++)
-    {
-        for (int y = 0; y < rectangle.height(); y++)
+    tiles(rectangle, [&](Rectangle tile) {
+        for (int y = tile.top(); y < tile.bottom(); y++)
         {
-            _bitmap->blend_pixel_no_check(Vec2i(rectangle.x() + x, rectangle.y() + y),
-                                          color);
+            for (int x = tile.left(); x < tile.right(); x++)
+            {
+                _bitmap->blend_pixel_no_check(Vec2i(x, y), color);
+            }
         }
-    }
+    });
 }
 
 __flatten void Painter::fill_insets(Rectangle rectangle, Insets insets, Color color)
@@ -617,12 +700,45 @@ __flatten void Painter::blur_rectangle(Rectangle rectangle, int radius)
     rectangle = apply_transform(rectangle);
     rectangle = apply_clip(rectangle);
 
-    stackblurJob((unsigned char *)_bitmap->pixels(),
-                 _bitmap->width(),
-                 _bitmap->height(),
-                 radius,
-                 rectangle.x(), rectangle.x() + rectangle.width(),
-                 rectangle.y(), rectangle.y() + rectangle.height());
+    if (rectangle.is_empty())
+    {
+        return;
+    }
+
+    unsigned char *pixels = (unsigned char *)_bitmap->pixels();
+
+    if (_pool == nullptr || rectangle.area() < PAINTER_PARALLEL_AREA)
+    {
+        stackblurJob(pixels,
+                     _bitmap->width(),
+                     _bitmap->height(),
+                     radius,
+                     rectangle.left(), rectangle.right(),
+                     rectangle.top(), rectangle.bottom());
+
+        return;
+    }
+
+    // Rows are blurred by bands first, then columns by strips, every one of
+    // them only reads and writes its own pixels.
+    tiles(rectangle, [&](Rectangle tile) {
+        stackblur_horizontal(pixels, _bitmap->width(), radius,
+                             tile.left(), tile.right(),
+                             tile.top(), tile.bottom());
+    });
+
+    for (int x = rectangle.left(); x < rectangle.right(); x += PAINTER_TILE_HEIGHT)
+    {
+        int right = MIN(x + PAINTER_TILE_HEIGHT, rectangle.right());
+
+        _pool->submit([=, this]() {
+            stackblur_vertical(pixels, _bitmap->width(), radius,
+                               x, right,
+                               rectangle.top(), rectangle.bottom());
+        });
+    }
+
+    _pool->wait();
 }
 
 __flatten void Painter::blit_bitmap_colored(Bitmap &bitmap, Rectangle source, Rectangle destination, Color color)
@@ -7,6 +7,13 @@
 
 #define STATESTACK_SIZE 32
 
+// Operations covering at least this many pixels are split into bands of
+// rows when the painter has a pool to run them on.
+#define PAINTER_TILE_HEIGHT 32
+#define PAINTER_PARALLEL_AREA (128 * 128)
+
+class ThreadPool;
+
 struct PainterState
 {
     Vec2i origine;
@@ -19,10 +26,16 @@ private:
     RefPtr<Bitmap> _bitmap;
     int _state_stack_top = 0;
     PainterState _state_stack[STATESTACK_SIZE];
+    ThreadPool *_pool = nullptr;
 
 public:
     Painter(RefPtr<Bitmap> bitmap);
 
+    // Without a pool everything is drawn by the caller, one pixel after the
+    // other. With one, large fills, blits and blurs are shared between its
+    // workers, which gives the same pixels.
+    void pool(ThreadPool *pool) { _pool = pool; }
+
     void push();
 
     void pop();
@@ -37,6 +50,10 @@ public:
 
     void blit_bitmap_no_alpha(Bitmap &bitmap, Rectangle source, Rectangle destination);
 
+    // Copies the pixels as they are, alpha included, row by row. The source
+    // and the destination are the same size.
+    void blit_bitmap_copy(Bitmap &bitmap, Rectangle source, Rectangle destination);
+
     void blit_icon(Icon &icon, IconSize size, Rectangle destination, Color color);
 
     void clear(Color color);
@@ -86,6 +103,9 @@ private:
 
     Rectangle apply_transform(Rectangle rectangle);
 
+    template <typename TCallback>
+    void tiles(Rectangle rectangle, TCallback callback);
+
     void blit_bitmap_fast(Bitmap &bitmap, Rectangle source, Rectangle destination);
 
     void blit_bitmap_scaled(Bitmap &bitmap, Rectangle source, Rectangle destination);
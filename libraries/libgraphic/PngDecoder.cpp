@@ -0,0 +1,731 @@
+#include <libgraphic/Inflate.h>
+#include <libgraphic/PngDecoder.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/OwnPtr.h>
+
+static_assert(sizeof(Color) == 4, "Color must be laid out as RGBA bytes");
+
+static constexpr uint8_t PNG_SIGNATURE[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+
+static constexpr uint32_t PNG_MAX_PIXELS = 64 * 1024 * 1024;
+
+#define PNG_CHUNK(__a, __b, __c, __d) \
+    (((uint32_t)(__a) << 24) | ((uint32_t)(__b) << 16) | ((uint32_t)(__c) << 8) | (uint32_t)(__d))
+
+static constexpr uint32_t PNG_CHUNK_IHDR = PNG_CHUNK('I', 'H', 'D', 'R');
+static constexpr uint32_t PNG_CHUNK_PLTE = PNG_CHUNK('P', 'L', 'T', 'E');
+static constexpr uint32_t PNG_CHUNK_TRNS = PNG_CHUNK('t', 'R', 'N', 'S');
+static constexpr uint32_t PNG_CHUNK_IDAT = PNG_CHUNK('I', 'D', 'A', 'T');
+static constexpr uint32_t PNG_CHUNK_IEND = PNG_CHUNK('I', 'E', 'N', 'D');
+
+enum PngColorType
+{
+    PNG_GREYSCALE = 0,
+    PNG_TRUECOLOR = 2,
+    PNG_INDEXED = 3,
+    PNG_GREYSCALE_ALPHA = 4,
+    PNG_TRUECOLOR_ALPHA = 6,
+};
+
+static constexpr uint8_t ADAM7_X[7] = {0, 4, 0, 2, 0, 1, 0};
+static constexpr uint8_t ADAM7_Y[7] = {0, 0, 4, 0, 2, 0, 1};
+static constexpr uint8_t ADAM7_DX[7] = {8, 8, 4, 4, 2, 2, 1};
+static constexpr uint8_t ADAM7_DY[7] = {8, 8, 8, 4, 4, 2, 2};
+
+static inline uint32_t read_be32(const uint8_t *data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+static inline uint16_t read_be16(const uint8_t *data)
+{
+    return ((uint16_t)data[0] << 8) | data[1];
+}
+
+static inline uint8_t paeth(int a, int b, int c)
+{
+    int pa = b - c;
+    int pb = a - c;
+    int pc = pa + pb;
+
+    pa = pa < 0 ? -pa : pa;
+    pb = pb < 0 ? -pb : pb;
+    pc = pc < 0 ? -pc : pc;
+
+    if (pa <= pb && pa <= pc)
+    {
+        return a;
+    }
+
+    return pb <= pc ? b : c;
+}
+
+// The pixel size is a compile time constant so the inner loop is fully
+// unrolled and works on a whole pixel at once.
+template <size_t BPP>
+static void unfilter_paeth(uint8_t *row, const uint8_t *previous, size_t size)
+{
+    for (size_t i = 0; i < BPP; i++)
+    {
+        row[i] += previous[i];
+    }
+
+    for (size_t i = BPP; i < size; i += BPP)
+    {
+        for (size_t j = 0; j < BPP; j++)
+        {
+            row[i + j] += paeth(row[i + j - BPP], previous[i + j], previous[i + j - BPP]);
+        }
+    }
+}
+
+PngDecoder::~PngDecoder()
+{
+    free(_previous);
+    free(_current);
+    free(_scratch);
+}
+
+size_t PngDecoder::fill()
+{
+    if (_buffer_offset == _buffer_used)
+    {
+        _buffer_used = stream_read(_stream, _buffer, BUFFER_SIZE);
+        _buffer_offset = 0;
+    }
+
+    return _buffer_used - _buffer_offset;
+}
+
+Result PngDecoder::read(void *buffer, size_t size)
+{
+    uint8_t *destination = (uint8_t *)buffer;
+
+    while (size > 0)
+    {
+        size_t available = fill();
+
+        if (available == 0)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        size_t chunk = MIN(available, size);
+        memcpy(destination, _buffer + _buffer_offset, chunk);
+
+        _buffer_offset += chunk;
+        destination += chunk;
+        size -= chunk;
+    }
+
+    return SUCCESS;
+}
+
+Result PngDecoder::skip(size_t size)
+{
+    while (size > 0)
+    {
+        size_t available = fill();
+
+        if (available == 0)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        size_t chunk = MIN(available, size);
+
+        _buffer_offset += chunk;
+        size -= chunk;
+    }
+
+    return SUCCESS;
+}
+
+Result PngDecoder::read_chunk_header(uint32_t *length, uint32_t *type)
+{
+    uint8_t header[8];
+
+    Result result = read(header, 8);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    *length = read_be32(header);
+    *type = read_be32(header + 4);
+
+    if (*length > 0x7fffffff)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    return SUCCESS;
+}
+
+size_t PngDecoder::row_bytes(uint32_t width)
+{
+    size_t bits_per_pixel = _bit_depth;
+
+    if (_color_type == PNG_TRUECOLOR)
+    {
+        bits_per_pixel *= 3;
+    }
+    else if (_color_type == PNG_GREYSCALE_ALPHA)
+    {
+        bits_per_pixel *= 2;
+    }
+    else if (_color_type == PNG_TRUECOLOR_ALPHA)
+    {
+        bits_per_pixel *= 4;
+    }
+
+    return (width * bits_per_pixel + 7) / 8;
+}
+
+Result PngDecoder::read_header(uint32_t length)
+{
+    uint8_t header[13];
+
+    if (length != 13 || read(header, 13) != SUCCESS)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    _width = read_be32(header);
+    _height = read_be32(header + 4);
+    _bit_depth = header[8];
+    _color_type = header[9];
+    _interlaced = header[12] == 1;
+
+    if (_width == 0 || _height == 0 ||
+        _width > PNG_MAX_PIXELS || _height > PNG_MAX_PIXELS ||
+        (uint64_t)_width * _height > PNG_MAX_PIXELS ||
+        header[10] != 0 || header[11] != 0 || header[12] > 1)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    bool valid_depth = false;
+
+    switch (_color_type)
+    {
+    case PNG_GREYSCALE:
+        valid_depth = _bit_depth == 1 || _bit_depth == 2 || _bit_depth == 4 || _bit_depth == 8 || _bit_depth == 16;
+        break;
+
+    case PNG_INDEXED:
+        valid_depth = _bit_depth == 1 || _bit_depth == 2 || _bit_depth == 4 || _bit_depth == 8;
+        break;
+
+    case PNG_TRUECOLOR:
+    case PNG_GREYSCALE_ALPHA:
+    case PNG_TRUECOLOR_ALPHA:
+        valid_depth = _bit_depth == 8 || _bit_depth == 16;
+        break;
+
+    default:
+        break;
+    }
+
+    if (!valid_depth)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    _bytes_per_pixel = MAX(row_bytes(1), 1u);
+    _row_size = row_bytes(_width) + 1;
+
+    _previous = (uint8_t *)malloc(_row_size);
+    _current = (uint8_t *)malloc(_row_size);
+
+    if (_interlaced)
+    {
+        _scratch = (Color *)malloc(sizeof(Color) * _width);
+    }
+
+    auto bitmap_or_result = Bitmap::create_shared(_width, _height);
+
+    if (!bitmap_or_result.success())
+    {
+        return bitmap_or_result.result();
+    }
+
+    _bitmap = bitmap_or_result.take_value();
+
+    return SUCCESS;
+}
+
+Result PngDecoder::read_palette(uint32_t length)
+{
+    if (length % 3 != 0 || length / 3 > 256)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    uint8_t palette[256 * 3];
+
+    Result result = read(palette, length);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    _palette_size = length / 3;
+
+    for (size_t i = 0; i < _palette_size; i++)
+    {
+        _palette[i] = Color::from_byte(palette[i * 3], palette[i * 3 + 1], palette[i * 3 + 2]);
+    }
+
+    return SUCCESS;
+}
+
+Result PngDecoder::read_transparency(uint32_t length)
+{
+    uint8_t transparency[256];
+
+    if (length > 256)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    Result result = read(transparency, length);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (_color_type == PNG_INDEXED)
+    {
+        for (size_t i = 0; i < MIN(length, _palette_size); i++)
+        {
+            _palette[i] = Color::from_byte(_palette[i].red(), _palette[i].green(), _palette[i].blue(), transparency[i]);
+        }
+    }
+    else if (_color_type == PNG_GREYSCALE && length == 2)
+    {
+        _has_color_key = true;
+        _color_key[0] = read_be16(transparency);
+    }
+    else if (_color_type == PNG_TRUECOLOR && length == 6)
+    {
+        _has_color_key = true;
+        _color_key[0] = read_be16(transparency);
+        _color_key[1] = read_be16(transparency + 2);
+        _color_key[2] = read_be16(transparency + 4);
+    }
+
+    return SUCCESS;
+}
+
+size_t PngDecoder::next_data(const uint8_t **data)
+{
+    while (_chunk_remaining == 0)
+    {
+        if (!_in_data)
+        {
+            return 0;
+        }
+
+        // The image data may be split across consecutive IDAT chunks.
+        uint32_t length = 0;
+        uint32_t type = 0;
+
+        if (skip(4) != SUCCESS ||
+            read_chunk_header(&length, &type) != SUCCESS ||
+            type != PNG_CHUNK_IDAT)
+        {
+            _in_data = false;
+            return 0;
+        }
+
+        _chunk_remaining = length;
+    }
+
+    size_t available = fill();
+
+    if (available == 0)
+    {
+        _in_data = false;
+        return 0;
+    }
+
+    size_t size = MIN(available, (size_t)_chunk_remaining);
+
+    *data = _buffer + _buffer_offset;
+    _buffer_offset += size;
+    _chunk_remaining -= size;
+
+    return size;
+}
+
+void PngDecoder::begin_pass()
+{
+    _row = 0;
+    _row_used = 0;
+
+    if (!_interlaced)
+    {
+        _pass_width = _width;
+        _pass_height = _height;
+    }
+    else
+    {
+        for (; _pass < 7; _pass++)
+        {
+            _pass_width = (_width - ADAM7_X[_pass] + ADAM7_DX[_pass] - 1) / ADAM7_DX[_pass];
+            _pass_height = (_height - ADAM7_Y[_pass] + ADAM7_DY[_pass] - 1) / ADAM7_DY[_pass];
+
+            if (_width > ADAM7_X[_pass] && _height > ADAM7_Y[_pass])
+            {
+                break;
+            }
+        }
+
+        _row_size = row_bytes(_pass_width) + 1;
+    }
+
+    memset(_previous, 0, _row_size);
+}
+
+Result PngDecoder::unfilter()
+{
+    uint8_t *row = _current + 1;
+    const uint8_t *previous = _previous + 1;
+    size_t size = _row_size - 1;
+    size_t bpp = _bytes_per_pixel;
+
+    switch (_current[0])
+    {
+    case 0:
+        break;
+
+    case 1:
+        for (size_t i = bpp; i < size; i++)
+        {
+            row[i] += row[i - bpp];
+        }
+        break;
+
+    case 2:
+        for (size_t i = 0; i < size; i++)
+        {
+            row[i] += previous[i];
+        }
+        break;
+
+    case 3:
+        for (size_t i = 0; i < bpp; i++)
+        {
+            row[i] += previous[i] >> 1;
+        }
+
+        for (size_t i = bpp; i < size; i++)
+        {
+            row[i] += (row[i - bpp] + previous[i]) >> 1;
+        }
+        break;
+
+    case 4:
+        switch (bpp)
+        {
+        case 1:
+            unfilter_paeth<1>(row, previous, size);
+            break;
+        case 2:
+            unfilter_paeth<2>(row, previous, size);
+            break;
+        case 3:
+            unfilter_paeth<3>(row, previous, size);
+            break;
+        case 4:
+            unfilter_paeth<4>(row, previous, size);
+            break;
+        case 6:
+            unfilter_paeth<6>(row, previous, size);
+            break;
+        case 8:
+            unfilter_paeth<8>(row, previous, size);
+            break;
+        }
+        break;
+
+    default:
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    return SUCCESS;
+}
+
+void PngDecoder::convert_row(const uint8_t *row, Color *pixels, uint32_t count)
+{
+    if (_color_type == PNG_TRUECOLOR_ALPHA && _bit_depth == 8)
+    {
+        memcpy(pixels, row, count * sizeof(Color));
+        return;
+    }
+
+    size_t step = _bit_depth / 8;
+
+    switch (_color_type)
+    {
+    case PNG_TRUECOLOR_ALPHA:
+        for (uint32_t i = 0; i < count; i++, row += 8)
+        {
+            pixels[i] = Color::from_byte(row[0], row[2], row[4], row[6]);
+        }
+        break;
+
+    case PNG_GREYSCALE_ALPHA:
+        for (uint32_t i = 0; i < count; i++, row += 2 * step)
+        {
+            pixels[i] = Color::from_byte(row[0], row[0], row[0], row[step]);
+        }
+        break;
+
+    case PNG_TRUECOLOR:
+        for (uint32_t i = 0; i < count; i++, row += 3 * step)
+        {
+            uint8_t alpha = 255;
+
+            if (_has_color_key)
+            {
+                uint16_t red = step == 2 ? read_be16(row) : row[0];
+                uint16_t green = step == 2 ? read_be16(row + 2) : row[1];
+                uint16_t blue = step == 2 ? read_be16(row + 4) : row[2];
+
+                if (red == _color_key[0] && green == _color_key[1] && blue == _color_key[2])
+                {
+                    alpha = 0;
+                }
+            }
+
+            pixels[i] = Color::from_byte(row[0], row[step], row[2 * step], alpha);
+        }
+        break;
+
+    case PNG_GREYSCALE:
+    case PNG_INDEXED:
+    {
+        uint32_t depth = _bit_depth;
+        uint32_t mask = (1u << MIN(depth, 8u)) - 1;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t value;
+
+            if (depth == 16)
+            {
+                value = read_be16(row + i * 2);
+            }
+            else
+            {
+                uint32_t bit = i * depth;
+                value = (row[bit / 8] >> (8 - depth - bit % 8)) & mask;
+            }
+
+            if (_color_type == PNG_INDEXED)
+            {
+                pixels[i] = value < _palette_size ? _palette[value] : Colors::BLACK;
+                continue;
+            }
+
+            uint8_t alpha = (_has_color_key && value == _color_key[0]) ? 0 : 255;
+            uint8_t grey = depth == 16 ? (value >> 8) : (value * 255 / mask);
+
+            pixels[i] = Color::from_byte(grey, grey, grey, alpha);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void PngDecoder::emit_row()
+{
+    const uint8_t *row = _current + 1;
+
+    if (!_interlaced)
+    {
+        convert_row(row, _bitmap->pixels() + (size_t)_row * _width, _pass_width);
+        return;
+    }
+
+    convert_row(row, _scratch, _pass_width);
+
+    Color *destination = _bitmap->pixels() + (size_t)(ADAM7_Y[_pass] + _row * ADAM7_DY[_pass]) * _width;
+
+    for (uint32_t i = 0; i < _pass_width; i++)
+    {
+        destination[ADAM7_X[_pass] + i * ADAM7_DX[_pass]] = _scratch[i];
+    }
+}
+
+Result PngDecoder::consume(const uint8_t *data, size_t size)
+{
+    while (size > 0 && !done())
+    {
+        size_t chunk = MIN(size, _row_size - _row_used);
+
+        memcpy(_current + _row_used, data, chunk);
+
+        _row_used += chunk;
+        data += chunk;
+        size -= chunk;
+
+        if (_row_used < _row_size)
+        {
+            continue;
+        }
+
+        Result result = unfilter();
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+
+        emit_row();
+
+        swap(_previous, _current);
+
+        _row_used = 0;
+        _row++;
+
+        if (_row == _pass_height)
+        {
+            _pass++;
+
+            if (!done())
+            {
+                begin_pass();
+            }
+        }
+    }
+
+    return SUCCESS;
+}
+
+Result PngDecoder::read_data(uint32_t length)
+{
+    _chunk_remaining = length;
+    _in_data = true;
+
+    begin_pass();
+
+    auto inflate = own<Inflate>(
+        [this](const uint8_t **data) {
+            return next_data(data);
+        },
+        [this](const uint8_t *data, size_t size) {
+            return consume(data, size);
+        });
+
+    Result result = inflate->perform();
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    if (!done())
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    return SUCCESS;
+}
+
+ResultOr<RefPtr<Bitmap>> PngDecoder::decode()
+{
+    uint8_t signature[8];
+
+    if (read(signature, 8) != SUCCESS ||
+        memcmp(signature, PNG_SIGNATURE, 8) != 0)
+    {
+        return ERR_BAD_IMAGE_FILE_FORMAT;
+    }
+
+    bool first = true;
+
+    while (true)
+    {
+        uint32_t length = 0;
+        uint32_t type = 0;
+
+        Result result = read_chunk_header(&length, &type);
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+
+        if (first != (type == PNG_CHUNK_IHDR))
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+
+        first = false;
+
+        if (type == PNG_CHUNK_IHDR)
+        {
+            result = read_header(length);
+        }
+        else if (type == PNG_CHUNK_PLTE)
+        {
+            result = read_palette(length);
+        }
+        else if (type == PNG_CHUNK_TRNS)
+        {
+            result = read_transparency(length);
+        }
+        else if (type == PNG_CHUNK_IDAT)
+        {
+            if (_color_type == PNG_INDEXED && _palette_size == 0)
+            {
+                return ERR_BAD_IMAGE_FILE_FORMAT;
+            }
+
+            // Everything after the image data is ancillary, we are done.
+            result = read_data(length);
+
+            if (result != SUCCESS)
+            {
+                return result;
+            }
+
+            return _bitmap;
+        }
+        else if (type == PNG_CHUNK_IEND)
+        {
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+        else if (!(type & 0x20000000))
+        {
+            // Unknown critical chunk, we can't decode this image correctly.
+            return ERR_BAD_IMAGE_FILE_FORMAT;
+        }
+        else
+        {
+            result = skip(length);
+        }
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+
+        result = skip(4);
+
+        if (result != SUCCESS)
+        {
+            return result;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <libgraphic/Bitmap.h>
+#include <libsystem/io/Stream.h>
+
+// Decode a PNG image while reading it from a stream. Scanlines are
+// unfiltered as soon as they come out of the inflater and are written
+// straight into the pixels of a shared bitmap, neither the compressed file
+// nor the raw image are ever held in memory as a whole.
+//
+// Decoding runs on the calling thread. Unfiltering a row needs the one
+// above it, only the conversion to colors could be spread over a
+// ThreadPool, and that needs batches of raw rows to be kept around.
+class PngDecoder
+{
+private:
+    static constexpr size_t BUFFER_SIZE = 4096;
+
+    Stream *_stream;
+
+    uint8_t _buffer[BUFFER_SIZE];
+    size_t _buffer_used = 0;
+    size_t _buffer_offset = 0;
+
+    uint32_t _chunk_remaining = 0;
+    bool _in_data = false;
+
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    uint8_t _bit_depth = 0;
+    uint8_t _color_type = 0;
+    bool _interlaced = false;
+    size_t _bytes_per_pixel = 0;
+
+    Color _palette[256];
+    size_t _palette_size = 0;
+
+    bool _has_color_key = false;
+    uint16_t _color_key[3] = {};
+
+    RefPtr<Bitmap> _bitmap;
+    Color *_scratch = nullptr;
+
+    uint8_t *_previous = nullptr;
+    uint8_t *_current = nullptr;
+    size_t _row_size = 0;
+    size_t _row_used = 0;
+
+    int _pass = 0;
+    uint32_t _pass_width = 0;
+    uint32_t _pass_height = 0;
+    uint32_t _row = 0;
+
+    bool done() { return _pass >= (_interlaced ? 7 : 1); }
+
+    size_t fill();
+
+    Result read(void *buffer, size_t size);
+
+    Result skip(size_t size);
+
+    Result read_chunk_header(uint32_t *length, uint32_t *type);
+
+    Result read_header(uint32_t length);
+
+    Result read_palette(uint32_t length);
+
+    Result read_transparency(uint32_t length);
+
+    Result read_data(uint32_t length);
+
+    size_t next_data(const uint8_t **data);
+
+    size_t row_bytes(uint32_t width);
+
+    void begin_pass();
+
+    Result consume(const uint8_t *data, size_t size);
+
+    Result unfilter();
+
+    void convert_row(const uint8_t *row, Color *pixels, uint32_t count);
+
+    void emit_row();
+
+public:
+    PngDecoder(Stream *stream) : _stream(stream) {}
+
+    ~PngDecoder();
+
+    ResultOr<RefPtr<Bitmap>> decode();
+};
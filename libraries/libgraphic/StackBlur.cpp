@@ -1,4 +1,5 @@
 #include <libgraphic/Painter.h>
+#include <libgraphic/StackBlur.h>
 
 static unsigned short const stackblur_mul[255] = {
     512, 512, 456, 512, 328, 456, 335, 512, 405, 328, 271, 456, 388, 335, 292, 512,
@@ -36,19 +37,16 @@ static unsigned char const stackblur_shr[255] = {
     24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
     24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24};
 
-/// Stackblur algorithm body
-__attribute__((optimize("O3"))) void stackblurJob(unsigned char *src,  ///< input image data
-                                                  unsigned int w,      ///< image width
-                                                  unsigned int h,      ///< image height
-                                                  unsigned int radius, ///< blur intensity (should be in 2..254 range)
-                                                  unsigned int minX,
-                                                  unsigned int maxX,
-                                                  unsigned int minY,
-                                                  unsigned int maxY)
+/// Blurs the rows from minY to maxY, each one on its own.
+__attribute__((optimize("O3"))) void stackblur_horizontal(unsigned char *src,
+                                                          unsigned int w,
+                                                          unsigned int radius,
+                                                          unsigned int minX,
+                                                          unsigned int maxX,
+                                                          unsigned int minY,
+                                                          unsigned int maxY)
 {
-    __unused(h);
-
-    unsigned int x, y, xp, yp, i;
+    unsigned int x, y, xp, i;
     unsigned int sp;
     unsigned int stack_start;
     unsigned char *stack_ptr;
@@ -67,7 +65,6 @@ __attribute__((optimize("O3"))) void stackblurJob(unsigned char *src,  ///< inpu
     unsigned long sum_out_b;
 
     unsigned int wm = maxX - minX - 1;
-    unsigned int hm = maxY - minY - 1;
     unsigned int w4 = w * 4;
     unsigned int div = (radius * 2) + 1;
     unsigned int mul_sum = stackblur_mul[radius];
@@ -172,6 +169,41 @@ __attribute__((optimize("O3"))) void stackblurJob(unsigned char *src,  ///< inpu
             }
         }
     }
+}
+
+/// Blurs the columns from minX to maxX, each one on its own.
+__attribute__((optimize("O3"))) void stackblur_vertical(unsigned char *src,
+                                                        unsigned int w,
+                                                        unsigned int radius,
+                                                        unsigned int minX,
+                                                        unsigned int maxX,
+                                                        unsigned int minY,
+                                                        unsigned int maxY)
+{
+    unsigned int x, y, yp, i;
+    unsigned int sp;
+    unsigned int stack_start;
+    unsigned char *stack_ptr;
+
+    unsigned char *src_ptr;
+    unsigned char *dst_ptr;
+
+    unsigned long sum_r;
+    unsigned long sum_g;
+    unsigned long sum_b;
+    unsigned long sum_in_r;
+    unsigned long sum_in_g;
+    unsigned long sum_in_b;
+    unsigned long sum_out_r;
+    unsigned long sum_out_g;
+    unsigned long sum_out_b;
+
+    unsigned int hm = maxY - minY - 1;
+    unsigned int w4 = w * 4;
+    unsigned int div = (radius * 2) + 1;
+    unsigned int mul_sum = stackblur_mul[radius];
+    unsigned char shr_sum = stackblur_shr[radius];
+    unsigned char stack[div * 3];
 
     {
 
@@ -271,4 +303,20 @@ __attribute__((optimize("O3"))) void stackblurJob(unsigned char *src,  ///< inpu
             }
         }
     }
-}
\ No newline at end of file
+}
+
+/// Stackblur algorithm body
+void stackblurJob(unsigned char *src,  ///< input image data
+                  unsigned int w,      ///< image width
+                  unsigned int h,      ///< image height
+                  unsigned int radius, ///< blur intensity (should be in 2..254 range)
+                  unsigned int minX,
+                  unsigned int maxX,
+                  unsigned int minY,
+                  unsigned int maxY)
+{
+    __unused(h);
+
+    stackblur_horizontal(src, w, radius, minX, maxX, minY, maxY);
+    stackblur_vertical(src, w, radius, minX, maxX, minY, maxY);
+}
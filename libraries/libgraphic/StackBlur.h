@@ -8,3 +8,14 @@ void stackblurJob(unsigned char *src,  ///< input image data
                   unsigned int maxX,
                   unsigned int minY,
                   unsigned int maxY);
+
+// The two passes of stackblurJob(), each row or column only depends on
+// itself, so a pass can be split between threads. The second one has to
+// wait for the first.
+void stackblur_horizontal(unsigned char *src, unsigned int w, unsigned int radius,
+                          unsigned int minX, unsigned int maxX,
+                          unsigned int minY, unsigned int maxY);
+
+void stackblur_vertical(unsigned char *src, unsigned int w, unsigned int radius,
+                        unsigned int minX, unsigned int maxX,
+                        unsigned int minY, unsigned int maxY);
@@ -1,13 +1,13 @@
 #include <libgraphic/Bitmap.h>
 #include <libgraphic/TrueType.h>
 #include <libgraphic/TrueTypeFont.h>
-#include <libsystem/io/Stream.h>
+#include <libsystem/io/File.h>
 #include <libsystem/math/Vectors.h>
 
 struct TrueTypeFamily
 {
     truetype_fontinfo info;
-    void *buffer;
+    const void *buffer;
     size_t buffer_size;
 };
 
@@ -25,28 +25,35 @@ struct TrueTypeFont
 
 TrueTypeFamily *truetype_family_create(const char *path)
 {
-    Stream *font_file = stream_open(path, OPEN_READ);
+    const void *buffer;
+    size_t buffer_size;
 
-    FileState state = {};
-    stream_stat(font_file, &state);
+    if (file_map(path, &buffer, &buffer_size) != SUCCESS)
+    {
+        return nullptr;
+    }
 
-    TrueTypeFamily *family = __create(TrueTypeFamily);
-    family->buffer_size = state.size;
-    family->buffer = malloc(state.size);
+    if (buffer_size == 0)
+    {
+        file_unmap(buffer);
+        return nullptr;
+    }
 
-    stream_read(font_file, family->buffer, state.size);
+    TrueTypeFamily *family = __create(TrueTypeFamily);
+    family->buffer = buffer;
+    family->buffer_size = buffer_size;
 
     truetype_InitFont(
         &family->info,
-        (unsigned char *)family->buffer,
-        truetype_GetFontOffsetForIndex((unsigned char *)family->buffer, 0));
+        (const unsigned char *)family->buffer,
+        truetype_GetFontOffsetForIndex((const unsigned char *)family->buffer, 0));
 
     return family;
 }
 
 void truetype_family_destroy(TrueTypeFamily *family)
 {
-    free(family->buffer);
+    file_unmap(family->buffer);
     free(family);
 }
 
@@ -1,3 +1,7 @@
 LIBS += MARKUP
 
 MARKUP_NAME = markup
+MARKUP_CXXFLAGS = -msse2
+
+MARKUP_SHARED = true
+MARKUP_NEEDED = system
@@ -2,23 +2,25 @@
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
 #include <libsystem/unicode/Codepoint.h>
 #include <libsystem/utils/BufferBuilder.h>
 #include <libsystem/utils/NumberParser.h>
 
 #include <libutils/Scanner.h>
 #include <libutils/ScannerUtils.h>
+#include <libutils/SpanScanner.h>
 
-#define MARKUP_WHITESPACE " \n\r\t"
-#define MARKUP_XDIGITS "0123456789abcdef"
-#define MARKUP_ALPHA "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+static constexpr CharClass MARKUP_ALPHA{"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"};
 
-static void whitespace(Scanner &scan)
+template <typename TScanner>
+static void whitespace(TScanner &scan)
 {
-    scan.eat(MARKUP_WHITESPACE);
+    scan.eat_whitespace();
 }
 
-static char *identifier(Scanner &scan)
+template <typename TScanner>
+static char *identifier(TScanner &scan)
 {
     BufferBuilder *builder = buffer_builder_create(6);
 
@@ -32,7 +34,8 @@ static char *identifier(Scanner &scan)
     return buffer_builder_finalize(builder);
 }
 
-char *string(Scanner &scan)
+template <typename TScanner>
+static char *string(TScanner &scan)
 {
     BufferBuilder *builder = buffer_builder_create(16);
 
@@ -47,8 +50,9 @@ char *string(Scanner &scan)
         }
         else
         {
-            buffer_builder_append_chr(builder, scan.current());
-            scan.foreward();
+            scan.read_until('"', '\\', [&](const char *span, size_t size) {
+                buffer_builder_append_str_size(builder, span, size);
+            });
         }
     }
 
@@ -57,7 +61,8 @@ char *string(Scanner &scan)
     return buffer_builder_finalize(builder);
 }
 
-static MarkupAttribute *attribute(Scanner &scan)
+template <typename TScanner>
+static MarkupAttribute *attribute(TScanner &scan)
 {
     char *ident = identifier(scan);
 
@@ -76,7 +81,8 @@ static MarkupAttribute *attribute(Scanner &scan)
     }
 }
 
-static bool opening_tag(MarkupNode **node, Scanner &scan)
+template <typename TScanner>
+static bool opening_tag(MarkupNode **node, TScanner &scan)
 {
     scan.skip('<');
 
@@ -105,7 +111,8 @@ static bool opening_tag(MarkupNode **node, Scanner &scan)
     return true;
 }
 
-static void closing_tag(MarkupNode *node, Scanner &scan)
+template <typename TScanner>
+static void closing_tag(MarkupNode *node, TScanner &scan)
 {
     scan.skip('<');
     scan.skip('/');
@@ -129,7 +136,8 @@ static void closing_tag(MarkupNode *node, Scanner &scan)
     scan.skip('>');
 }
 
-static MarkupNode *node(Scanner &scan)
+template <typename TScanner>
+static MarkupNode *node(TScanner &scan)
 {
     whitespace(scan);
 
@@ -158,13 +166,24 @@ static MarkupNode *node(Scanner &scan)
 
 MarkupNode *markup_parse(const char *string, size_t size)
 {
-    StringScanner scan{string, size};
+    SpanScanner scan{string, size};
     scan_skip_utf8bom(scan);
     return node(scan);
 }
 
 MarkupNode *markup_parse_file(const char *path)
 {
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(path, &buffer, &size) == SUCCESS)
+    {
+        MarkupNode *root = markup_parse((const char *)buffer, size);
+        file_unmap(buffer);
+
+        return root;
+    }
+
     __cleanup(stream_cleanup) Stream *markup_file = stream_open(path, OPEN_READ);
 
     if (handle_has_error(markup_file))
@@ -4,4 +4,7 @@ SYSTEM_NAME = system
 SYSTEM_CXXFLAGS = \
 	-fno-tree-loop-distribute-patterns \
 	-fno-rtti \
-	-fno-exceptions
+	-fno-exceptions \
+	-msse2
+
+SYSTEM_SHARED = true
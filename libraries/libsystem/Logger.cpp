@@ -1,17 +1,32 @@
-
 #include <libsystem/core/CString.h>
 
 #include <libsystem/Logger.h>
 #include <libsystem/core/Plugs.h>
 #include <libsystem/io/Stream.h>
+#include <libsystem/math/MinMax.h>
 #include <libsystem/process/Process.h>
+#include <libsystem/trace/Trace.h>
 
 static bool logger_log_level = LOGGER_TRACE;
 
 static bool logger_is_quiet = false;
 
+#ifdef __KERNEL__
+
+// Lines are recorded in the log ring and written out by logger_flush(),
+// right away unless the logger is deferred.
+static bool logger_is_deferred = false;
+
+static TraceCursor logger_cursor = {};
+
+#    define LOGGER_LINE_SIZE 512
+
+#else
+
 static const char *logger_level_colors[] = {"\e[34m", "\e[36m", "\e[32m", "\e[33m", "\e[31m", "\e[35m"};
 
+#endif
+
 void logger_level(LogLevel log_level)
 {
     logger_log_level = log_level;
@@ -22,50 +37,112 @@ void logger_quiet(bool quiet)
     logger_is_quiet = quiet;
 }
 
-void logger_log(LogLevel level, const char *file, uint line, const char *fmt, ...)
+void logger_defer(bool defer)
+{
+#ifdef __KERNEL__
+    logger_is_deferred = defer;
+#else
+    __unused(defer);
+#endif
+}
+
+void logger_flush()
 {
-    if (level >= logger_log_level)
+#ifdef __KERNEL__
+    TraceRecord record;
+    char line[LOGGER_LINE_SIZE];
+
+    size_t lost = logger_cursor.lost;
+
+    while (true)
     {
         __plug_logger_lock();
+        bool has_record = trace_log_ring().next(logger_cursor, record);
+        __plug_logger_unlock();
 
-#ifndef __KERNEL__
-        stream_format(log_stream, "\e[1m");
-#endif
-
-        if (process_this() >= 0)
+        // Lines that were overwritten before they could be written out.
+        if (logger_cursor.lost != lost)
         {
-            stream_format(log_stream, "%3d: ", process_this());
+            size_t length = snprintf(line, LOGGER_LINE_SIZE, "(%d lines lost)\n", (int)(logger_cursor.lost - lost));
+            stream_write(log_stream, line, MIN(length, LOGGER_LINE_SIZE - 1));
+
+            lost = logger_cursor.lost;
         }
-        else
+
+        if (!has_record)
         {
-            stream_format(log_stream, "     ", process_this());
+            break;
         }
 
-        stream_format(log_stream, "%s: ", process_name());
-
-#ifndef __KERNEL__
-        stream_format(log_stream, "\e[m");
+        size_t length = trace_format(record, line, LOGGER_LINE_SIZE);
+        stream_write(log_stream, line, length);
+    }
 #endif
 
-        DateTime datetime = datetime_now();
-        stream_format(log_stream, "%02d:%02d:%02d ", datetime.hour, datetime.minute, datetime.second);
+    stream_flush(log_stream);
+}
 
-        stream_format(log_stream, "%s%s:%d:\e[37;1m ", logger_level_colors[level], file, line);
+void logger_log(LogLevel level, const char *file, uint line, const char *fmt, ...)
+{
+    if (level < logger_log_level || (logger_is_quiet && level != LOGGER_FATAL))
+    {
+        return;
+    }
 
-        va_list va;
-        va_start(va, fmt);
+#ifdef __KERNEL__
+    va_list va;
+    va_start(va, fmt);
+    trace_log_ring().record(level, file, line, fmt, va);
+    va_end(va);
 
-        stream_vprintf(log_stream, fmt, va);
-        stream_format(log_stream, "\e[0m\n");
-        stream_flush(log_stream);
+    if (!logger_is_deferred || level == LOGGER_FATAL)
+    {
+        logger_flush();
+    }
 
-        va_end(va);
+    if (level == LOGGER_FATAL)
+    {
+        __plug_logger_fatal();
+    }
+#else
+    // Processes write their lines right away, there is nothing to gain from
+    // deferring them and strings are kept whole.
+    __plug_logger_lock();
 
-        if (level == LOGGER_FATAL)
-        {
-            __plug_logger_fatal();
-        }
+    stream_format(log_stream, "\e[1m");
 
-        __plug_logger_unlock();
+    if (process_this() >= 0)
+    {
+        stream_format(log_stream, "%3d: ", process_this());
+    }
+    else
+    {
+        stream_format(log_stream, "     ", process_this());
     }
+
+    stream_format(log_stream, "%s: ", process_name());
+
+    stream_format(log_stream, "\e[m");
+
+    DateTime datetime = datetime_now();
+    stream_format(log_stream, "%02d:%02d:%02d ", datetime.hour, datetime.minute, datetime.second);
+
+    stream_format(log_stream, "%s%s:%d:\e[37;1m ", logger_level_colors[level], file, line);
+
+    va_list va;
+    va_start(va, fmt);
+
+    stream_vprintf(log_stream, fmt, va);
+    stream_format(log_stream, "\e[0m\n");
+    stream_flush(log_stream);
+
+    va_end(va);
+
+    if (level == LOGGER_FATAL)
+    {
+        __plug_logger_fatal();
+    }
+
+    __plug_logger_unlock();
+#endif
 }
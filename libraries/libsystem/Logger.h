@@ -18,6 +18,13 @@ void logger_colors(bool use_colors);
 
 void logger_quiet(bool quiet);
 
+// In the kernel, when deferred, logging only records into the log ring and
+// something else has to call logger_flush() to get the lines written out.
+// Processes always write their lines right away.
+void logger_defer(bool defer);
+
+void logger_flush();
+
 void logger_log(LogLevel level, const char *file, uint line, const char *fmt, ...);
 
 #define logger_trace(__args...) logger_log(LOGGER_TRACE, __FILE__, __LINE__, __args)
@@ -18,6 +18,11 @@ void __no_return __plug_assert_failed(const char *expr, const char *file, const
 
 void __plug_lock_assert_failed(Lock *lock, const char *file, const char *function, int line);
 
+// Waits while the lock is contended, it may return early.
+void __plug_lock_wait(Lock *lock);
+
+void __plug_lock_wake(Lock *lock);
+
 /* --- Logger --------------------------------------------------------------- */
 
 void __plug_logger_lock();
@@ -50,6 +55,8 @@ TimeStamp __plug_system_get_time();
 
 uint __plug_system_get_ticks();
 
+uint64_t __plug_system_get_microseconds();
+
 /* --- Processes ------------------------------------------------------------ */
 
 int __plug_process_this();
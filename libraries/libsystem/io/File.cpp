@@ -1,3 +1,6 @@
+#include <abi/Syscalls.h>
+
+#include <libsystem/core/Plugs.h>
 #include <libsystem/io/File.h>
 #include <libsystem/io/Stream.h>
 
@@ -56,6 +59,42 @@ Result file_write_all(const char *path, void *buffer, size_t size)
     return SUCCESS;
 }
 
+Result file_map(const char *path, const void **buffer, size_t *size)
+{
+    *buffer = nullptr;
+    *size = 0;
+
+    Handle handle;
+    __plug_handle_open(&handle, path, OPEN_READ);
+
+    if (handle_has_error(&handle))
+    {
+        return handle_get_error(&handle);
+    }
+
+    uintptr_t address = 0;
+    Result result = hj_handle_mmap(handle.id, &address, size);
+
+    __plug_handle_close(&handle);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    *buffer = reinterpret_cast<const void *>(address);
+
+    return SUCCESS;
+}
+
+void file_unmap(const void *buffer)
+{
+    if (buffer)
+    {
+        hj_memory_free(reinterpret_cast<uintptr_t>(buffer));
+    }
+}
+
 bool file_exist(const char *path)
 {
     __cleanup(stream_cleanup) Stream *stream = stream_open(path, OPEN_READ);
@@ -7,6 +7,13 @@ Result file_read_all(const char *path, void **buffer, size_t *size);
 
 Result file_write_all(const char *path, void *buffer, size_t size);
 
+// Map the content of a file read-only in the address space of the process,
+// the buffer must be released with file_unmap(). Empty files are mapped to a
+// null buffer of size 0.
+Result file_map(const char *path, const void **buffer, size_t *size);
+
+void file_unmap(const void *buffer);
+
 bool file_exist(const char *path);
 
 Result file_copy(const char *src, const char *dst);
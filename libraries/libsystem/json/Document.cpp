@@ -0,0 +1,342 @@
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/json/Document.h>
+#include <libsystem/json/Reader.h>
+#include <libutils/SpanScanner.h>
+
+namespace json
+{
+
+static constexpr Node _nil{};
+
+const Node &Node::nil()
+{
+    return _nil;
+}
+
+const char *Node::as_string() const
+{
+    if (_type == STRING)
+    {
+        return _string;
+    }
+    else if (_type == TRUE)
+    {
+        return "true";
+    }
+    else if (_type == FALSE)
+    {
+        return "false";
+    }
+    else if (_type == NIL)
+    {
+        return "null";
+    }
+    else
+    {
+        ASSERT_NOT_REACHED();
+    }
+}
+
+int Node::as_integer() const
+{
+    if (_type == INTEGER)
+    {
+        return _integer;
+    }
+
+#ifndef __KERNEL__
+
+    else if (_type == DOUBLE)
+    {
+        return _double;
+    }
+
+#endif
+
+    else if (_type == TRUE)
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+#ifndef __KERNEL__
+
+double Node::as_double() const
+{
+    if (_type == INTEGER)
+    {
+        return _integer;
+    }
+    else if (_type == DOUBLE)
+    {
+        return _double;
+    }
+    else if (_type == TRUE)
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+#endif
+
+bool Node::has(const char *key) const
+{
+    return &get(key) != &_nil;
+}
+
+const Node &Node::get(const char *key) const
+{
+    if (_type != OBJECT)
+    {
+        return _nil;
+    }
+
+    for (size_t i = 0; i < _length; i++)
+    {
+        if (strcmp(_members[i].key, key) == 0)
+        {
+            return _members[i].value;
+        }
+    }
+
+    return _nil;
+}
+
+const Node &Node::get(size_t index) const
+{
+    assert(is(ARRAY));
+    assert(index < _length);
+
+    return _elements[index];
+}
+
+const char *Node::key(size_t index) const
+{
+    assert(is(OBJECT));
+    assert(index < _length);
+
+    return _members[index].key;
+}
+
+// Values of the containers still open wait on a stack until the container
+// ends, then they are copied to the arena side by side. Each container has
+// a slot of its own on the stack, below its values, filled once it ends.
+class DocumentBuilder
+{
+    __noncopyable(DocumentBuilder);
+    __nonmovable(DocumentBuilder);
+
+private:
+    struct Frame
+    {
+        size_t slot;
+        Type type;
+    };
+
+    Arena &_arena;
+
+    Member *_stack = nullptr;
+    size_t _stack_count = 0;
+    size_t _stack_capacity = 0;
+
+    Frame *_frames = nullptr;
+    size_t _frames_count = 0;
+    size_t _frames_capacity = 0;
+
+    const char *_key = nullptr;
+
+    template <typename T>
+    static void grow(T *&buffer, size_t &capacity, size_t count)
+    {
+        if (count < capacity)
+        {
+            return;
+        }
+
+        capacity = MAX(capacity * 2, 16);
+        buffer = (T *)realloc(buffer, sizeof(T) * capacity);
+    }
+
+    void push(Node node)
+    {
+        grow(_stack, _stack_capacity, _stack_count);
+
+        _stack[_stack_count] = {_key, node};
+        _stack_count++;
+
+        _key = nullptr;
+    }
+
+    void begin(Type type)
+    {
+        grow(_frames, _frames_capacity, _frames_count);
+
+        _frames[_frames_count] = {_stack_count, type};
+        _frames_count++;
+
+        push(Node{});
+    }
+
+    void end()
+    {
+        if (_frames_count == 0)
+        {
+            return;
+        }
+
+        _frames_count--;
+        Frame &frame = _frames[_frames_count];
+
+        Member *values = &_stack[frame.slot + 1];
+        size_t count = _stack_count - frame.slot - 1;
+
+        if (frame.type == OBJECT)
+        {
+            Member *members = _arena.make_array<Member>(count);
+            memcpy(members, values, sizeof(Member) * count);
+
+            _stack[frame.slot].value = Node{(const Member *)members, count};
+        }
+        else
+        {
+            Node *elements = _arena.make_array<Node>(count);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                elements[i] = values[i].value;
+            }
+
+            _stack[frame.slot].value = Node{(const Node *)elements, count};
+        }
+
+        _stack_count = frame.slot + 1;
+    }
+
+public:
+    DocumentBuilder(Arena &arena) : _arena(arena) {}
+
+    ~DocumentBuilder()
+    {
+        free(_stack);
+        free(_frames);
+    }
+
+    const Node *finalize()
+    {
+        // The document was truncated, close what was left open.
+        while (_frames_count > 0)
+        {
+            end();
+        }
+
+        if (_stack_count == 0)
+        {
+            return &Node::nil();
+        }
+
+        return _arena.make<Node>(_stack[0].value);
+    }
+
+    void begin_object() { begin(OBJECT); }
+
+    void key(const char *key, size_t length)
+    {
+        _key = _arena.duplicate(key, length);
+    }
+
+    void end_object() { end(); }
+
+    void begin_array() { begin(ARRAY); }
+
+    void end_array() { end(); }
+
+    void string(const char *string, size_t length)
+    {
+        push(Node{_arena.duplicate(string, length), length});
+    }
+
+    void integer(int value) { push(Node{value}); }
+
+#ifndef __KERNEL__
+    void number(double value)
+    {
+        push(Node{value});
+    }
+#endif
+
+    void boolean(bool value) { push(Node{value}); }
+
+    void null() { push(Node{}); }
+};
+
+template <typename TScanner>
+static const Node *build(TScanner &scan, Arena &arena)
+{
+    DocumentBuilder builder{arena};
+
+    Reader reader{};
+    reader.read(scan, builder);
+
+    return builder.finalize();
+}
+
+void Document::parse(Scanner &scan)
+{
+    _arena.clear();
+    _root = build(scan, _arena);
+}
+
+void Document::parse(const char *str, size_t size)
+{
+    _arena.clear();
+
+    // Start from a chunk as big as the document, the next ones grow from there.
+    _arena.reserve(size);
+
+    SpanScanner scan{str, size};
+    _root = build(scan, _arena);
+}
+
+Result Document::parse_file(const char *path)
+{
+#ifndef __KERNEL__
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(path, &buffer, &size) == SUCCESS)
+    {
+        parse((const char *)buffer, size);
+        file_unmap(buffer);
+
+        return SUCCESS;
+    }
+#endif
+
+    __cleanup(stream_cleanup) Stream *json_file = stream_open(path, OPEN_READ);
+
+    if (handle_has_error(json_file))
+    {
+        _arena.clear();
+        _root = &Node::nil();
+
+        return handle_get_error(json_file);
+    }
+
+    StreamScanner scan{json_file};
+    parse(scan);
+
+    return SUCCESS;
+}
+
+} // namespace json
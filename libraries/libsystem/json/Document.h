@@ -0,0 +1,107 @@
+#pragma once
+
+#include <libsystem/Result.h>
+#include <libsystem/json/Value.h>
+#include <libutils/Arena.h>
+#include <libutils/Scanner.h>
+
+namespace json
+{
+
+struct Member;
+
+// A read-only value of a Document. Strings, elements and members all live in
+// the document's arena, so nodes are only valid as long as their document.
+class Node
+{
+private:
+    Type _type = NIL;
+    uint32_t _length = 0;
+
+    union {
+        const char *_string;
+        int _integer;
+#ifndef __KERNEL__
+        double _double;
+#endif
+        const Node *_elements;
+        const Member *_members;
+    };
+
+public:
+    static const Node &nil();
+
+    bool is(Type type) const { return _type == type; }
+
+    const char *as_string() const;
+
+    int as_integer() const;
+
+#ifndef __KERNEL__
+    double as_double() const;
+#endif
+
+    // Characters of a string, elements of an array or members of an object.
+    size_t length() const { return _length; }
+
+    // Lookups by key walk the members, objects are expected to be small.
+    bool has(const char *key) const;
+
+    const Node &get(const char *key) const;
+
+    const Node &get(size_t index) const;
+
+    const char *key(size_t index) const;
+
+    constexpr Node() : _string(nullptr) {}
+
+    constexpr Node(const char *string, size_t length)
+        : _type(STRING), _length(length), _string(string) {}
+
+    constexpr Node(int value) : _type(INTEGER), _integer(value) {}
+
+#ifndef __KERNEL__
+    constexpr Node(double value) : _type(DOUBLE), _double(value) {}
+#endif
+
+    constexpr Node(bool value) : _type(value ? TRUE : FALSE), _string(nullptr) {}
+
+    constexpr Node(const Node *elements, size_t length)
+        : _type(ARRAY), _length(length), _elements(elements) {}
+
+    constexpr Node(const Member *members, size_t length)
+        : _type(OBJECT), _length(length), _members(members) {}
+};
+
+struct Member
+{
+    const char *key;
+    Node value;
+};
+
+// A whole document in a single arena, built without going through Value and
+// freed at once when the document goes away or is parsed again.
+class Document
+{
+    __noncopyable(Document);
+    __nonmovable(Document);
+
+private:
+    Arena _arena;
+    const Node *_root = &Node::nil();
+
+public:
+    const Node &root() const { return *_root; }
+
+    size_t allocated() const { return _arena.allocated(); }
+
+    Document() {}
+
+    void parse(Scanner &scan);
+
+    void parse(const char *str, size_t size);
+
+    Result parse_file(const char *path);
+};
+
+} // namespace json
@@ -4,8 +4,10 @@
 #include <libutils/String.h>
 
 #include <libsystem/json/Array.h>
+#include <libsystem/json/Document.h>
 #include <libsystem/json/Object.h>
 #include <libsystem/json/Value.h>
+#include <libsystem/json/Visitor.h>
 
 namespace json
 {
@@ -20,4 +22,12 @@ Value parse(const char *str, size_t size);
 
 Value parse_file(const char *path);
 
+// Streams the document to the visitor without building anything, see
+// Document for a tree that doesn't go through Value.
+void visit(Scanner &scan, Visitor &visitor);
+
+void visit(const char *str, size_t size, Visitor &visitor);
+
+Result visit_file(const char *path, Visitor &visitor);
+
 } // namespace json
@@ -1,5 +1,6 @@
 #include <libsystem/Assert.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
 #include <libsystem/io/Stream.h>
 #include <libsystem/json/Json.h>
 #include <libsystem/math/Math.h>
@@ -7,22 +8,28 @@
 #include <libsystem/utils/NumberParser.h>
 #include <libutils/Scanner.h>
 #include <libutils/ScannerUtils.h>
+#include <libutils/SpanScanner.h>
 #include <libutils/StringBuilder.h>
+#include <libutils/StringPool.h>
 
 namespace json
 {
-static constexpr const char *WHITESPACE = " \n\r\t";
-static constexpr const char *DIGITS = "0123456789";
-static constexpr const char *ALPHA = "abcdefghijklmnopqrstuvwxyz";
+static constexpr CharClass DIGITS{"0123456789"};
+static constexpr CharClass ALPHA{"abcdefghijklmnopqrstuvwxyz"};
 
-static Value value(Scanner &scan);
+// Everything is templated on the scanner, so documents in memory are parsed
+// by a SpanScanner without any virtual call.
+template <typename TScanner>
+static Value value(TScanner &scan, StringPool &keys);
 
-static void whitespace(Scanner &scan)
+template <typename TScanner>
+static void whitespace(TScanner &scan)
 {
-    scan.eat(WHITESPACE);
+    scan.eat_whitespace();
 }
 
-static int digits(Scanner &scan)
+template <typename TScanner>
+static int digits(TScanner &scan)
 {
     int digits = 0;
 
@@ -36,7 +43,8 @@ static int digits(Scanner &scan)
     return digits;
 }
 
-static Value number(Scanner &scan)
+template <typename TScanner>
+static Value number(TScanner &scan)
 {
     int ipart_sign = 1;
 
@@ -99,7 +107,8 @@ static Value number(Scanner &scan)
 #endif
 }
 
-static String string(Scanner &scan)
+template <typename TScanner>
+static String string(TScanner &scan)
 {
     StringBuilder builder{};
 
@@ -113,8 +122,9 @@ static String string(Scanner &scan)
         }
         else
         {
-            builder.append(scan.current());
-            scan.foreward();
+            scan.read_until('"', '\\', [&](const char *span, size_t size) {
+                builder.append(span, size);
+            });
         }
     }
 
@@ -123,7 +133,8 @@ static String string(Scanner &scan)
     return builder.finalize();
 }
 
-static Value array(Scanner &scan)
+template <typename TScanner>
+static Value array(TScanner &scan, StringPool &keys)
 {
     scan.skip('[');
 
@@ -140,7 +151,7 @@ static Value array(Scanner &scan)
     do
     {
         scan.skip(',');
-        array.push_back(value(scan));
+        array.push_back(value(scan, keys));
         index++;
     } while (scan.current() == ',');
 
@@ -149,7 +160,8 @@ static Value array(Scanner &scan)
     return move(array);
 }
 
-static Value object(Scanner &scan)
+template <typename TScanner>
+static Value object(TScanner &scan, StringPool &keys)
 {
     scan.skip('{');
 
@@ -164,12 +176,13 @@ static Value object(Scanner &scan)
 
     while (scan.current() != '}')
     {
-        auto k = string(scan);
+        // Arrays of objects repeat the same keys over and over.
+        auto k = keys.intern(string(scan));
         whitespace(scan);
 
         scan.skip(':');
 
-        auto v = value(scan);
+        auto v = value(scan, keys);
 
         object[k] = v;
 
@@ -183,7 +196,8 @@ static Value object(Scanner &scan)
     return object;
 }
 
-static Value keyword(Scanner &scan)
+template <typename TScanner>
+static Value keyword(TScanner &scan)
 {
     StringBuilder builder{};
 
@@ -210,7 +224,8 @@ static Value keyword(Scanner &scan)
     }
 }
 
-static Value value(Scanner &scan)
+template <typename TScanner>
+static Value value(TScanner &scan, StringPool &keys)
 {
     whitespace(scan);
 
@@ -226,11 +241,11 @@ static Value value(Scanner &scan)
     }
     else if (scan.current() == '{')
     {
-        value = object(scan);
+        value = object(scan, keys);
     }
     else if (scan.current() == '[')
     {
-        value = array(scan);
+        value = array(scan, keys);
     }
     else
     {
@@ -242,20 +257,41 @@ static Value value(Scanner &scan)
     return value;
 }
 
-Value parse(Scanner &scan)
+template <typename TScanner>
+static Value parse_document(TScanner &scan)
 {
     scan_skip_utf8bom(scan);
-    return value(scan);
+
+    StringPool keys;
+    return value(scan, keys);
+}
+
+Value parse(Scanner &scan)
+{
+    return parse_document(scan);
 }
 
 Value parse(const char *str, size_t size)
 {
-    StringScanner scan{str, size};
-    return parse(scan);
+    SpanScanner scan{str, size};
+    return parse_document(scan);
 };
 
 Value parse_file(const char *path)
 {
+#ifndef __KERNEL__
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(path, &buffer, &size) == SUCCESS)
+    {
+        Value result = parse((const char *)buffer, size);
+        file_unmap(buffer);
+
+        return result;
+    }
+#endif
+
     __cleanup(stream_cleanup) Stream *json_file = stream_open(path, OPEN_READ);
 
     if (handle_has_error(json_file))
@@ -264,8 +300,7 @@ Value parse_file(const char *path)
     }
 
     StreamScanner scan{json_file};
-    scan_skip_utf8bom(scan);
-    return value(scan);
+    return parse_document(scan);
 }
 
 } // namespace json
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <libsystem/json/Visitor.h>
+#include <libsystem/math/Math.h>
+#include <libutils/Scanner.h>
+#include <libutils/ScannerUtils.h>
+#include <libutils/StringBuilder.h>
+
+namespace json
+{
+
+// Walks a document and reports what it finds to a visitor. Templated on
+// both so a concrete visitor over a SpanScanner has no virtual calls left.
+// Strings are decoded in a single buffer reused for the whole document.
+class Reader
+{
+private:
+    static constexpr CharClass DIGITS{"0123456789"};
+    static constexpr CharClass ALPHA{"abcdefghijklmnopqrstuvwxyz"};
+
+    StringBuilder _buffer{};
+
+    template <typename TScanner>
+    static int digits(TScanner &scan)
+    {
+        int digits = 0;
+
+        while (scan.current_is(DIGITS))
+        {
+            digits *= 10;
+            digits += scan.current() - '0';
+            scan.foreward();
+        }
+
+        return digits;
+    }
+
+    template <typename TScanner, typename TVisitor>
+    static void number(TScanner &scan, TVisitor &visitor)
+    {
+        int ipart_sign = 1;
+
+        if (scan.skip('-'))
+        {
+            ipart_sign = -1;
+        }
+
+        int ipart = digits(scan);
+
+#ifdef __KERNEL__
+        visitor.integer(ipart_sign * ipart);
+#else
+        double fpart = 0;
+
+        if (scan.skip('.'))
+        {
+            double multiplier = 0.1;
+
+            while (scan.current_is(DIGITS))
+            {
+                fpart += multiplier * (scan.current() - '0');
+                multiplier *= 0.1;
+                scan.foreward();
+            }
+        }
+
+        int exp = 0;
+
+        if (scan.current_is("eE"))
+        {
+            scan.foreward();
+            int exp_sign = 1;
+
+            if (scan.current() == '-')
+            {
+                exp_sign = -1;
+            }
+
+            if (scan.current_is("+-"))
+            {
+                scan.foreward();
+            }
+
+            exp = digits(scan) * exp_sign;
+        }
+
+        if (fpart == 0 && exp >= 0)
+        {
+            visitor.integer(ipart_sign * ipart * (int)pow(10, exp));
+        }
+        else
+        {
+            visitor.number(ipart_sign * (ipart + fpart) * pow(10, exp));
+        }
+#endif
+    }
+
+    template <typename TScanner>
+    void string(TScanner &scan)
+    {
+        _buffer.rewind(_buffer.length());
+
+        scan.skip('"');
+
+        while (scan.current() != '"' && scan.do_continue())
+        {
+            if (scan.current() == '\\')
+            {
+                _buffer.append(scan_json_escape_sequence(scan));
+            }
+            else
+            {
+                scan.read_until('"', '\\', [&](const char *span, size_t size) {
+                    _buffer.append(span, size);
+                });
+            }
+        }
+
+        scan.skip('"');
+    }
+
+    template <typename TScanner, typename TVisitor>
+    void array(TScanner &scan, TVisitor &visitor)
+    {
+        scan.skip('[');
+        visitor.begin_array();
+
+        scan.eat_whitespace();
+
+        if (scan.skip(']'))
+        {
+            visitor.end_array();
+            return;
+        }
+
+        do
+        {
+            scan.skip(',');
+            value(scan, visitor);
+        } while (scan.current() == ',');
+
+        scan.skip(']');
+        visitor.end_array();
+    }
+
+    template <typename TScanner, typename TVisitor>
+    void object(TScanner &scan, TVisitor &visitor)
+    {
+        scan.skip('{');
+        visitor.begin_object();
+
+        scan.eat_whitespace();
+
+        while (scan.current() != '}' && scan.do_continue())
+        {
+            string(scan);
+            visitor.key(_buffer.cstring(), _buffer.length());
+
+            scan.eat_whitespace();
+            scan.skip(':');
+
+            value(scan, visitor);
+
+            scan.skip(',');
+            scan.eat_whitespace();
+        }
+
+        scan.skip('}');
+        visitor.end_object();
+    }
+
+    template <typename TScanner, typename TVisitor>
+    static void keyword(TScanner &scan, TVisitor &visitor)
+    {
+        if (scan.skip_word("true"))
+        {
+            visitor.boolean(true);
+        }
+        else if (scan.skip_word("false"))
+        {
+            visitor.boolean(false);
+        }
+        else
+        {
+            // Like the tree parser, anything unknown reads as null.
+            scan.eat(ALPHA);
+            visitor.null();
+        }
+    }
+
+    template <typename TScanner, typename TVisitor>
+    void value(TScanner &scan, TVisitor &visitor)
+    {
+        scan.eat_whitespace();
+
+        if (scan.current() == '"')
+        {
+            string(scan);
+            visitor.string(_buffer.cstring(), _buffer.length());
+        }
+        else if (scan.current_is("-0123456789"))
+        {
+            number(scan, visitor);
+        }
+        else if (scan.current() == '{')
+        {
+            object(scan, visitor);
+        }
+        else if (scan.current() == '[')
+        {
+            array(scan, visitor);
+        }
+        else
+        {
+            keyword(scan, visitor);
+        }
+
+        scan.eat_whitespace();
+    }
+
+public:
+    template <typename TScanner, typename TVisitor>
+    void read(TScanner &scan, TVisitor &visitor)
+    {
+        scan_skip_utf8bom(scan);
+        value(scan, visitor);
+    }
+};
+
+} // namespace json
@@ -129,7 +129,7 @@ Value::Value(String &&value)
 Value::Value(const char *cstring)
 {
     _type = STRING;
-    _string = new StringStorage(cstring);
+    _string = StringStorage::create(cstring).give_ref();
 }
 
 Value::Value(int value)
@@ -250,6 +250,18 @@ bool Value::has(String key) const
     }
 }
 
+bool Value::has(const char *key) const
+{
+    if (is(OBJECT))
+    {
+        return _object->has_key(key);
+    }
+    else
+    {
+        return false;
+    }
+}
+
 const Value &Value::get(String key) const
 {
     assert(is(OBJECT));
@@ -257,6 +269,13 @@ const Value &Value::get(String key) const
     return _object->operator[](key);
 }
 
+const Value &Value::get(const char *key) const
+{
+    assert(is(OBJECT));
+
+    return _object->operator[](key);
+}
+
 void Value::put(String key, const Value &value) const
 {
     assert(is(OBJECT));
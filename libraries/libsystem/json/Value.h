@@ -97,8 +97,12 @@ public:
 
     bool has(String key) const;
 
+    bool has(const char *key) const;
+
     const Value &get(String key) const;
 
+    const Value &get(const char *key) const;
+
     void put(String key, const Value &value) const;
 
     void remove(String key);
@@ -0,0 +1,52 @@
+#include <libsystem/io/File.h>
+#include <libsystem/io/Stream.h>
+#include <libsystem/json/Json.h>
+#include <libsystem/json/Reader.h>
+#include <libutils/SpanScanner.h>
+
+namespace json
+{
+
+void visit(Scanner &scan, Visitor &visitor)
+{
+    Reader reader{};
+    reader.read(scan, visitor);
+}
+
+void visit(const char *str, size_t size, Visitor &visitor)
+{
+    SpanScanner scan{str, size};
+
+    Reader reader{};
+    reader.read(scan, visitor);
+}
+
+Result visit_file(const char *path, Visitor &visitor)
+{
+#ifndef __KERNEL__
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(path, &buffer, &size) == SUCCESS)
+    {
+        visit((const char *)buffer, size, visitor);
+        file_unmap(buffer);
+
+        return SUCCESS;
+    }
+#endif
+
+    __cleanup(stream_cleanup) Stream *json_file = stream_open(path, OPEN_READ);
+
+    if (handle_has_error(json_file))
+    {
+        return handle_get_error(json_file);
+    }
+
+    StreamScanner scan{json_file};
+    visit(scan, visitor);
+
+    return SUCCESS;
+}
+
+} // namespace json
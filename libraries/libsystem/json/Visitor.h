@@ -0,0 +1,56 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+namespace json
+{
+
+// Receives the content of a document as it is read, without any tree being
+// built. Strings and keys are nul terminated but only valid for the duration
+// of the call, copy them to keep them around.
+class Visitor
+{
+public:
+    virtual ~Visitor() {}
+
+    virtual void begin_object() {}
+
+    virtual void key(const char *key, size_t length)
+    {
+        __unused(key);
+        __unused(length);
+    }
+
+    virtual void end_object() {}
+
+    virtual void begin_array() {}
+
+    virtual void end_array() {}
+
+    virtual void string(const char *string, size_t length)
+    {
+        __unused(string);
+        __unused(length);
+    }
+
+    virtual void integer(int value)
+    {
+        __unused(value);
+    }
+
+#ifndef __KERNEL__
+    virtual void number(double value)
+    {
+        __unused(value);
+    }
+#endif
+
+    virtual void boolean(bool value)
+    {
+        __unused(value);
+    }
+
+    virtual void null() {}
+};
+
+} // namespace json
@@ -17,3 +17,9 @@ uint __plug_system_get_ticks()
     assert(hj_system_tick(&result) == SUCCESS);
     return result;
 }
+
+uint64_t __plug_system_get_microseconds()
+{
+    // There is no finer clock for userspace, yet.
+    return (uint64_t)__plug_system_get_ticks() * 1000;
+}
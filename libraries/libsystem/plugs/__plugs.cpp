@@ -1,4 +1,6 @@
 
+#include <abi/Syscalls.h>
+
 #include <libsystem/Assert.h>
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
@@ -32,6 +34,10 @@ void __plug_init()
     err_stream = stream_open_handle(2, OPEN_WRITE | OPEN_BUFFERED);
     log_stream = stream_open_handle(3, OPEN_WRITE | OPEN_BUFFERED);
 
+    // When libsystem is a shared object the dynamic loader has already run
+    // the constructors of every library and of the program, the symbols
+    // below would only cover libsystem itself.
+#ifndef __SHARED_LIBRARY__
     _init();
 
     extern void (*__init_array_start[])(int, char **, char **) __attribute__((visibility("hidden")));
@@ -40,6 +46,7 @@ void __plug_init()
     const size_t size = __init_array_end - __init_array_start;
     for (size_t i = 0; i < size; i++)
         (*__init_array_start[i])(0, nullptr, nullptr);
+#endif
 }
 
 void __plug_fini(int exit_code)
@@ -82,6 +89,16 @@ void __plug_lock_assert_failed(Lock *lock, const char *file, const char *functio
     process_abort();
 }
 
+void __plug_lock_wait(Lock *lock)
+{
+    hj_futex_wait(&lock->locked, LOCK_CONTENDED, -1);
+}
+
+void __plug_lock_wake(Lock *lock)
+{
+    hj_futex_wake(&lock->locked, 1, nullptr);
+}
+
 void __plug_logger_lock()
 {
     lock_acquire(loglock);
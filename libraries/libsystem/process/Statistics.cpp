@@ -0,0 +1,85 @@
+#include <abi/IOCall.h>
+#include <abi/Syscalls.h>
+
+#include <libsystem/core/CString.h>
+#include <libsystem/core/Plugs.h>
+#include <libsystem/process/Statistics.h>
+
+Result statistics_map(const SystemStatistics **out_statistics)
+{
+    *out_statistics = nullptr;
+
+    Handle handle;
+    __plug_handle_open(&handle, STATISTICS_PATH, OPEN_READ);
+
+    if (handle_has_error(&handle))
+    {
+        return handle_get_error(&handle);
+    }
+
+    IOCallStatisticsMapArgs args = {};
+    __plug_handle_call(&handle, IOCALL_STATISTICS_MAP, &args);
+
+    Result result = handle_get_error(&handle);
+
+    __plug_handle_close(&handle);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    auto statistics = reinterpret_cast<const SystemStatistics *>(args.address);
+
+    if (statistics->magic != STATISTICS_MAGIC ||
+        statistics->version != STATISTICS_VERSION)
+    {
+        hj_memory_free(args.address);
+        return ERR_OPERATION_NOT_SUPPORTED;
+    }
+
+    *out_statistics = statistics;
+
+    return SUCCESS;
+}
+
+void statistics_unmap(const SystemStatistics *statistics)
+{
+    if (statistics)
+    {
+        hj_memory_free(reinterpret_cast<uintptr_t>(statistics));
+    }
+}
+
+size_t statistics_snapshot(const SystemStatistics *statistics, TaskStatistics *tasks, size_t count)
+{
+    size_t copied = 0;
+
+    while (true)
+    {
+        uint32_t sequence = __atomic_load_n(&statistics->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence & 1)
+        {
+            continue;
+        }
+
+        copied = 0;
+
+        for (size_t i = 0; i < STATISTICS_TASK_COUNT && copied < count; i++)
+        {
+            if (statistics->tasks[i].used)
+            {
+                memcpy(&tasks[copied], &statistics->tasks[i], sizeof(TaskStatistics));
+                copied++;
+            }
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&statistics->sequence, __ATOMIC_RELAXED) == sequence)
+        {
+            return copied;
+        }
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <abi/Statistics.h>
+
+#include <libsystem/Common.h>
+#include <libsystem/Result.h>
+
+#define STATISTICS_PATH "/System/processes"
+
+Result statistics_map(const SystemStatistics **out_statistics);
+
+void statistics_unmap(const SystemStatistics *statistics);
+
+// Copy the tasks out of the shared page, retrying while the kernel is
+// updating it. Return the number of tasks copied.
+size_t statistics_snapshot(const SystemStatistics *statistics, TaskStatistics *tasks, size_t count);
@@ -5,3 +5,8 @@ uint system_get_ticks()
 {
     return __plug_system_get_ticks();
 }
+
+uint64_t system_get_microseconds()
+{
+    return __plug_system_get_microseconds();
+}
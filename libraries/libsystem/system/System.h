@@ -3,3 +3,5 @@
 #include <abi/System.h>
 
 uint system_get_ticks();
+
+uint64_t system_get_microseconds();
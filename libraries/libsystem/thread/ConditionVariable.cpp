@@ -0,0 +1,46 @@
+#include <abi/Syscalls.h>
+
+#include <libsystem/thread/ConditionVariable.h>
+
+void ConditionVariable::wait(Mutex &mutex)
+{
+    wait(mutex, -1);
+}
+
+bool ConditionVariable::wait(Mutex &mutex, Timeout timeout)
+{
+    // Signals bump the sequence, one sent between the unlock and the wait
+    // makes the wait return right away instead of being missed.
+    int sequence = __atomic_load_n(&_sequence, __ATOMIC_ACQUIRE);
+    __atomic_add_fetch(&_waiters, 1, __ATOMIC_SEQ_CST);
+
+    mutex.unlock();
+
+    Result result = hj_futex_wait(&_sequence, sequence, timeout);
+
+    __atomic_sub_fetch(&_waiters, 1, __ATOMIC_SEQ_CST);
+
+    mutex.lock();
+
+    return result != TIMEOUT;
+}
+
+void ConditionVariable::signal()
+{
+    __atomic_add_fetch(&_sequence, 1, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        hj_futex_wake(&_sequence, 1, nullptr);
+    }
+}
+
+void ConditionVariable::broadcast()
+{
+    __atomic_add_fetch(&_sequence, 1, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        hj_futex_wake(&_sequence, (size_t)-1, nullptr);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <libsystem/Time.h>
+#include <libsystem/thread/Mutex.h>
+
+// Waiters may wake up without being signaled, they check what they are
+// waiting for again, in a loop.
+class ConditionVariable
+{
+    __noncopyable(ConditionVariable);
+    __nonmovable(ConditionVariable);
+
+private:
+    int _sequence = 0;
+    int _waiters = 0;
+
+public:
+    constexpr ConditionVariable() {}
+
+    void wait(Mutex &mutex);
+
+    // Returns false if nobody signaled before the timeout.
+    bool wait(Mutex &mutex, Timeout timeout);
+
+    void signal();
+
+    void broadcast();
+};
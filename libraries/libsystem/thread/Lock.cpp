@@ -9,7 +9,7 @@
 
 void __lock_init(Lock *lock, const char *name)
 {
-    lock->locked = 0;
+    lock->locked = LOCK_FREE;
     lock->name = name;
     lock->holder = LOCK_NO_HOLDER;
 }
@@ -21,8 +21,15 @@ void __lock_acquire(Lock *lock)
 
 void __lock_acquire_by(Lock *lock, int holder)
 {
-    while (!__sync_bool_compare_and_swap(&lock->locked, 0, 1))
-        asm("hlt"); // Don't burn the CPU ;)
+    // Once somebody had to wait, the lock stays contended until it is free
+    // again, so whoever releases it knows to wake the others up.
+    if (!__sync_bool_compare_and_swap(&lock->locked, LOCK_FREE, LOCK_HELD))
+    {
+        while (__atomic_exchange_n(&lock->locked, LOCK_CONTENDED, __ATOMIC_ACQUIRE) != LOCK_FREE)
+        {
+            __plug_lock_wait(lock);
+        }
+    }
 
     __sync_synchronize();
 
@@ -31,7 +38,7 @@ void __lock_acquire_by(Lock *lock, int holder)
 
 bool __lock_try_acquire(Lock *lock)
 {
-    if (__sync_bool_compare_and_swap(&lock->locked, 0, 1))
+    if (__sync_bool_compare_and_swap(&lock->locked, LOCK_FREE, LOCK_HELD))
     {
         __sync_synchronize();
 
@@ -51,8 +58,12 @@ void __lock_release(Lock *lock, const char *file, const char *function, int line
 
     __sync_synchronize();
 
-    lock->holder = 0xDEADDEAD;
-    __atomic_store_n(&lock->locked, 0, __ATOMIC_SEQ_CST);
+    lock->holder = LOCK_NO_HOLDER;
+
+    if (__atomic_exchange_n(&lock->locked, LOCK_FREE, __ATOMIC_SEQ_CST) == LOCK_CONTENDED)
+    {
+        __plug_lock_wake(lock);
+    }
 }
 
 void __lock_release_by(Lock *lock, int holder, const char *file, const char *function, int line)
@@ -72,7 +83,11 @@ void __lock_release_by(Lock *lock, int holder, const char *file, const char *fun
     __sync_synchronize();
 
     lock->holder = LOCK_NO_HOLDER;
-    __atomic_store_n(&lock->locked, 0, __ATOMIC_SEQ_CST);
+
+    if (__atomic_exchange_n(&lock->locked, LOCK_FREE, __ATOMIC_SEQ_CST) == LOCK_CONTENDED)
+    {
+        __plug_lock_wake(lock);
+    }
 }
 
 void __lock_assert(Lock *lock, const char *file, const char *function, int line)
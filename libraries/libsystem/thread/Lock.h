@@ -2,9 +2,13 @@
 
 #include <libsystem/Common.h>
 
+#define LOCK_FREE 0
+#define LOCK_HELD 1
+#define LOCK_CONTENDED 2 // Held, and someone is waiting for it.
+
 struct Lock
 {
-    bool locked;
+    int locked;
     int holder;
     const char *name;
 };
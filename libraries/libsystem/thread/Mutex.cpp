@@ -0,0 +1,35 @@
+#include <abi/Syscalls.h>
+
+#include <libsystem/thread/Mutex.h>
+
+#define MUTEX_FREE 0
+#define MUTEX_HELD 1
+#define MUTEX_CONTENDED 2
+
+bool Mutex::try_lock()
+{
+    return __sync_bool_compare_and_swap(&_state, MUTEX_FREE, MUTEX_HELD);
+}
+
+void Mutex::lock()
+{
+    if (try_lock())
+    {
+        return;
+    }
+
+    // Whoever gets the mutex this way can't tell whether others are still
+    // waiting, so it keeps it contended and wakes one of them up on unlock.
+    while (__atomic_exchange_n(&_state, MUTEX_CONTENDED, __ATOMIC_ACQUIRE) != MUTEX_FREE)
+    {
+        hj_futex_wait(&_state, MUTEX_CONTENDED, -1);
+    }
+}
+
+void Mutex::unlock()
+{
+    if (__atomic_exchange_n(&_state, MUTEX_FREE, __ATOMIC_RELEASE) == MUTEX_CONTENDED)
+    {
+        hj_futex_wake(&_state, 1, nullptr);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+// Stays in userspace unless it has to wait, the kernel is only asked to put
+// threads to sleep and wake them back up.
+class Mutex
+{
+    __noncopyable(Mutex);
+    __nonmovable(Mutex);
+
+private:
+    int _state = 0;
+
+public:
+    constexpr Mutex() {}
+
+    bool try_lock();
+
+    void lock();
+
+    void unlock();
+};
+
+class MutexHolder
+{
+    __noncopyable(MutexHolder);
+    __nonmovable(MutexHolder);
+
+private:
+    Mutex &_mutex;
+
+public:
+    MutexHolder(Mutex &mutex) : _mutex(mutex)
+    {
+        _mutex.lock();
+    }
+
+    ~MutexHolder()
+    {
+        _mutex.unlock();
+    }
+};
@@ -0,0 +1,73 @@
+#include <abi/Syscalls.h>
+
+#include <libsystem/Assert.h>
+#include <libsystem/system/Memory.h>
+#include <libsystem/thread/Thread.h>
+
+Thread::Thread(Callback<void()> entry)
+    : _entry(entry)
+{
+}
+
+Thread::~Thread()
+{
+    join();
+}
+
+void Thread::entry(Thread *thread)
+{
+    thread->_entry();
+
+    hj_thread_exit(PROCESS_SUCCESS);
+    ASSERT_NOT_REACHED();
+}
+
+Result Thread::start()
+{
+    if (started())
+    {
+        return ERR_INVALID_ARGUMENT;
+    }
+
+    Result result = memory_alloc(THREAD_STACK_SIZE, &_stack);
+
+    if (result != SUCCESS)
+    {
+        return result;
+    }
+
+    result = hj_thread_create((uintptr_t)&Thread::entry, _stack + THREAD_STACK_SIZE, this, &_id);
+
+    if (result != SUCCESS)
+    {
+        memory_free(_stack);
+        _stack = 0;
+        _id = -1;
+    }
+
+    return result;
+}
+
+Result Thread::join()
+{
+    if (!started())
+    {
+        return SUCCESS;
+    }
+
+    // The thread may already be gone, and destroyed, nothing is left to
+    // wait for then.
+    Result result = hj_process_wait(_id, nullptr);
+
+    if (result == ERR_NO_SUCH_TASK)
+    {
+        result = SUCCESS;
+    }
+
+    // It won't run again, its stack can go.
+    memory_free(_stack);
+    _stack = 0;
+    _id = -1;
+
+    return result;
+}
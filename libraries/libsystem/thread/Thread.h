@@ -0,0 +1,36 @@
+#pragma once
+
+#include <libsystem/Result.h>
+#include <libutils/Callback.h>
+
+#define THREAD_STACK_SIZE 65536
+
+// Threads share the memory and the handles of their process. The process
+// exits along with all its threads when its first one does, or when any of
+// them calls process_exit().
+class Thread
+{
+    __noncopyable(Thread);
+    __nonmovable(Thread);
+
+private:
+    int _id = -1;
+    uintptr_t _stack = 0;
+    Callback<void()> _entry;
+
+    static void __no_return entry(Thread *thread);
+
+public:
+    int id() { return _id; }
+
+    bool started() { return _id != -1; }
+
+    Thread(Callback<void()> entry);
+
+    // Waits for the thread to be done.
+    ~Thread();
+
+    Result start();
+
+    Result join();
+};
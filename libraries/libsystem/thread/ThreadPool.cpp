@@ -0,0 +1,151 @@
+#include <libsystem/process/Process.h>
+#include <libsystem/thread/ThreadPool.h>
+
+ThreadPool::ThreadPool(size_t count)
+    : _workers(count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        _workers.push_back(own<Worker>());
+    }
+
+    // Every worker is there before any of them looks at the others.
+    for (size_t i = 0; i < count; i++)
+    {
+        _workers[i]->thread = own<Thread>([this, i]() { run(i); });
+        _workers[i]->thread->start();
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexHolder holder(_mutex);
+        _exiting = true;
+    }
+
+    _work.broadcast();
+
+    for (size_t i = 0; i < _workers.count(); i++)
+    {
+        _workers[i]->thread->join();
+    }
+}
+
+ThreadPool::Worker *ThreadPool::current_worker()
+{
+    int id = process_this();
+
+    for (size_t i = 0; i < _workers.count(); i++)
+    {
+        if (_workers[i]->thread->id() == id)
+        {
+            return _workers[i].naked();
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::submit(Callback<void()> job)
+{
+    Worker *worker = current_worker();
+
+    if (worker == nullptr)
+    {
+        MutexHolder holder(_mutex);
+
+        worker = _workers[_next % _workers.count()].naked();
+        _next++;
+    }
+
+    {
+        MutexHolder holder(worker->mutex);
+        worker->jobs.push_back(job);
+    }
+
+    {
+        MutexHolder holder(_mutex);
+        _queued++;
+        _pending++;
+    }
+
+    _work.signal();
+}
+
+// A job was set aside for the worker before calling this, so there is one
+// in one of the queues. Other workers keep taking and submitting jobs while
+// the queues are looked at one by one, so go around until it is found.
+Callback<void()> ThreadPool::take(size_t index)
+{
+    while (true)
+    {
+        Worker &worker = *_workers[index];
+
+        {
+            MutexHolder holder(worker.mutex);
+
+            if (worker.jobs.any())
+            {
+                return worker.jobs.pop_back();
+            }
+        }
+
+        for (size_t i = 1; i < _workers.count(); i++)
+        {
+            Worker &victim = *_workers[(index + i) % _workers.count()];
+
+            MutexHolder holder(victim.mutex);
+
+            if (victim.jobs.any())
+            {
+                return victim.jobs.pop();
+            }
+        }
+    }
+}
+
+void ThreadPool::run(size_t index)
+{
+    while (true)
+    {
+        {
+            MutexHolder holder(_mutex);
+
+            while (_queued == 0 && !_exiting)
+            {
+                _work.wait(_mutex);
+            }
+
+            if (_queued == 0)
+            {
+                return;
+            }
+
+            _queued--;
+        }
+
+        auto job = take(index);
+        job();
+
+        {
+            MutexHolder holder(_mutex);
+            _pending--;
+
+            if (_pending == 0)
+            {
+                _idle.broadcast();
+            }
+        }
+    }
+}
+
+void ThreadPool::wait()
+{
+    MutexHolder holder(_mutex);
+
+    while (_pending > 0)
+    {
+        _idle.wait(_mutex);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <libsystem/thread/ConditionVariable.h>
+#include <libsystem/thread/Mutex.h>
+#include <libsystem/thread/Thread.h>
+#include <libutils/OwnPtr.h>
+#include <libutils/Vector.h>
+
+// Each worker has its own queue of jobs. It takes the most recent one from
+// its own queue, and when that is empty, the oldest one from somebody else's.
+// Jobs submitted by a job go to the queue of the worker running it.
+class ThreadPool
+{
+    __noncopyable(ThreadPool);
+    __nonmovable(ThreadPool);
+
+private:
+    struct Worker
+    {
+        Mutex mutex;
+        Vector<Callback<void()>> jobs;
+        OwnPtr<Thread> thread;
+    };
+
+    Vector<OwnPtr<Worker>> _workers;
+
+    Mutex _mutex;
+    ConditionVariable _work;
+    ConditionVariable _idle;
+
+    // Jobs in the queues, not yet taken by any worker.
+    size_t _queued = 0;
+
+    // Jobs submitted and not done yet.
+    size_t _pending = 0;
+
+    size_t _next = 0;
+    bool _exiting = false;
+
+    Worker *current_worker();
+
+    Callback<void()> take(size_t index);
+
+    void run(size_t index);
+
+public:
+    size_t count() { return _workers.count(); }
+
+    ThreadPool(size_t count);
+
+    // Runs what is left in the queues before returning.
+    ~ThreadPool();
+
+    void submit(Callback<void()> job);
+
+    // Waits for every job submitted so far, and the ones they submitted, to
+    // be done.
+    void wait();
+};
@@ -0,0 +1,391 @@
+#include <abi/IOCall.h>
+
+#include <libsystem/Time.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/core/CType.h>
+#include <libsystem/core/Plugs.h>
+#include <libsystem/math/MinMax.h>
+#include <libsystem/process/Process.h>
+#include <libsystem/process/Statistics.h>
+#include <libsystem/system/System.h>
+#include <libsystem/trace/Trace.h>
+
+#ifdef __KERNEL__
+
+static TraceRing _trace_ring{};
+
+static TraceRing _trace_log_ring{};
+
+TraceRing &trace_ring()
+{
+    return _trace_ring;
+}
+
+TraceRing &trace_log_ring()
+{
+    return _trace_log_ring;
+}
+
+#endif
+
+// Walks the conversions of a format string the way printf() does: flags,
+// then a width, then a letter, or %% for a percent sign. Everything but %s
+// takes a single word.
+template <typename TCallback>
+static void trace_conversions(const char *format, TCallback callback)
+{
+    for (size_t i = 0; format[i]; i++)
+    {
+        if (format[i] != '%')
+        {
+            continue;
+        }
+
+        size_t start = i;
+        i++;
+
+        while (format[i] && !isalpha(format[i]) && format[i] != '%')
+        {
+            i++;
+        }
+
+        if (format[i] == '\0')
+        {
+            return;
+        }
+
+        callback(start, i);
+    }
+}
+
+static size_t trace_pack(uint8_t *payload, const char *format, va_list va)
+{
+    size_t size = 0;
+    bool full = false;
+
+    trace_conversions(format, [&](size_t, size_t conversion) {
+        if (full || format[conversion] == '%')
+        {
+            return;
+        }
+
+        if (format[conversion] == 's')
+        {
+            const char *string = va_arg(va, const char *);
+
+            if (string == nullptr)
+            {
+                string = "(null)";
+            }
+
+            if (size == TRACE_PAYLOAD_SIZE)
+            {
+                full = true;
+                return;
+            }
+
+            // Long strings are cut short rather than dropped.
+            size_t length = MIN(strlen(string), TRACE_PAYLOAD_SIZE - size - 1);
+
+            memcpy(payload + size, string, length);
+            payload[size + length] = '\0';
+            size += length + 1;
+        }
+        else
+        {
+            unsigned long word = va_arg(va, unsigned long);
+
+            if (size + sizeof(word) > TRACE_PAYLOAD_SIZE)
+            {
+                full = true;
+                return;
+            }
+
+            memcpy(payload + size, &word, sizeof(word));
+            size += sizeof(word);
+        }
+    });
+
+    return size;
+}
+
+void TraceRing::record(LogLevel level, const char *file, uint line, const char *format, va_list va)
+{
+    uint32_t index = __atomic_fetch_add(&_head, 1, __ATOMIC_RELAXED);
+    TraceRecord &record = _records[index % TRACE_RING_SIZE];
+
+    // Readers copying this slot see it change under them and drop their copy.
+    __atomic_store_n(&record.sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record.timestamp = system_get_microseconds();
+    record.task = process_this();
+    record.kind = TRACE_LOG;
+    record.level = level;
+    record.line = line;
+    record.file = file;
+    record.format = format;
+    strlcpy(record.process, process_name(), TRACE_PROCESS_NAME_SIZE);
+    record.payload_size = trace_pack(record.payload, format, va);
+
+    __atomic_store_n(&record.sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+void TraceRing::event(TraceKind kind, const char *name, long argument)
+{
+    uint32_t index = __atomic_fetch_add(&_head, 1, __ATOMIC_RELAXED);
+    TraceRecord &record = _records[index % TRACE_RING_SIZE];
+
+    __atomic_store_n(&record.sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record.timestamp = system_get_microseconds();
+    record.task = process_this();
+    record.kind = kind;
+    record.level = 0;
+    record.line = 0;
+    record.file = nullptr;
+    record.format = nullptr;
+    record.process[0] = '\0';
+
+    // Names are copied, they may come from a process that is long gone by
+    // the time the record is read.
+    size_t length = MIN(strlen(name), TRACE_NAME_SIZE - 1);
+
+    memcpy(record.payload, &argument, sizeof(argument));
+    memcpy(record.payload + sizeof(argument), name, length);
+    record.payload[sizeof(argument) + length] = '\0';
+    record.payload_size = sizeof(argument) + length + 1;
+
+    __atomic_store_n(&record.sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+TraceRead TraceRing::read(uint32_t index, TraceRecord &record) const
+{
+    const TraceRecord &slot = _records[index % TRACE_RING_SIZE];
+
+    uint32_t sequence = __atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE);
+
+    if (sequence != index + 1)
+    {
+        // Zero or an older index means a writer is still busy with the slot.
+        return (int32_t)(sequence - (index + 1)) > 0 ? TRACE_READ_LOST : TRACE_READ_PENDING;
+    }
+
+    memcpy(&record, &slot, sizeof(TraceRecord));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) != sequence)
+    {
+        return TRACE_READ_LOST;
+    }
+
+    return TRACE_READ_OK;
+}
+
+bool TraceRing::next(TraceCursor &cursor, TraceRecord &record) const
+{
+    uint32_t head = this->head();
+
+    while (cursor.index != head)
+    {
+        if (head - cursor.index > TRACE_RING_SIZE)
+        {
+            cursor.lost += head - cursor.index - TRACE_RING_SIZE;
+            cursor.index = head - TRACE_RING_SIZE;
+        }
+
+        TraceRead result = read(cursor.index, record);
+
+        if (result == TRACE_READ_PENDING)
+        {
+            return false;
+        }
+
+        cursor.index++;
+
+        if (result == TRACE_READ_OK)
+        {
+            return true;
+        }
+
+        cursor.lost++;
+    }
+
+    return false;
+}
+
+static const char *trace_level_colors[] = {"\e[34m", "\e[36m", "\e[32m", "\e[33m", "\e[31m", "\e[35m"};
+
+// Formats into a fixed buffer, the logger can't allocate since the
+// allocator itself logs.
+struct TraceLine
+{
+    char *buffer;
+    size_t size;
+    size_t used;
+
+    void append(const char *string, size_t length)
+    {
+        length = MIN(length, size - used - 1);
+
+        memcpy(buffer + used, string, length);
+        used += length;
+        buffer[used] = '\0';
+    }
+
+    void append(const char *string)
+    {
+        append(string, strlen(string));
+    }
+
+    template <typename... TArgs>
+    void format(const char *format, TArgs... args)
+    {
+        used += snprintf(buffer + used, size - used, format, args...);
+        used = MIN(used, size - 1);
+    }
+};
+
+size_t trace_format(const TraceRecord &record, char *buffer, size_t size)
+{
+    TraceLine line{buffer, size, 0};
+    buffer[0] = '\0';
+
+    if (record.task >= 0)
+    {
+        line.format("%3d: ", record.task);
+    }
+    else
+    {
+        line.append("     ");
+    }
+
+    line.format("%s: ", record.process);
+
+    // Records only have the time since boot, go back from the current time.
+    uint64_t age = (system_get_microseconds() - record.timestamp) / 1000000;
+    DateTime datetime = timestamp_to_datetime(timestamp_now() - age);
+    line.format("%02d:%02d:%02d ", datetime.hour, datetime.minute, datetime.second);
+
+    line.append(trace_level_colors[record.level % __array_length(trace_level_colors)]);
+    line.format("%s:%d:\e[37;1m ", record.file, record.line);
+
+    const char *format = record.format;
+    size_t written = 0;
+    size_t offset = 0;
+
+    trace_conversions(format, [&](size_t start, size_t conversion) {
+        line.append(format + written, start - written);
+        written = conversion + 1;
+
+        if (format[conversion] == '%')
+        {
+            line.append("%");
+            return;
+        }
+
+        char spec[16] = {};
+        memcpy(spec, format + start, MIN(conversion - start + 1, sizeof(spec) - 1));
+        spec[MIN(conversion - start, sizeof(spec) - 2)] = format[conversion];
+
+        if (format[conversion] == 's' && offset < record.payload_size)
+        {
+            const char *string = (const char *)record.payload + offset;
+            offset += strlen(string) + 1;
+
+            line.format(spec, string);
+        }
+        else if (format[conversion] != 's' && offset + sizeof(unsigned long) <= record.payload_size)
+        {
+            unsigned long word;
+            memcpy(&word, record.payload + offset, sizeof(word));
+            offset += sizeof(word);
+
+            line.format(spec, word);
+        }
+        else
+        {
+            // Didn't fit in the payload.
+            line.append("...");
+        }
+    });
+
+    line.append(format + written);
+    line.append("\e[0m\n");
+
+    return line.used;
+}
+
+void trace_unpack(const TraceRecord &record, TraceEvent &event)
+{
+    event.timestamp = record.timestamp;
+    event.task = record.task;
+    event.kind = (TraceKind)record.kind;
+
+    memcpy(&event.argument, record.payload, sizeof(event.argument));
+    strlcpy(event.name, (const char *)record.payload + sizeof(event.argument), TRACE_NAME_SIZE);
+}
+
+#ifdef __KERNEL__
+
+static bool _trace_enabled = false;
+
+void trace_enable(bool enable)
+{
+    __atomic_store_n(&_trace_enabled, enable, __ATOMIC_RELEASE);
+}
+
+bool trace_enabled()
+{
+    return __atomic_load_n(&_trace_enabled, __ATOMIC_RELAXED);
+}
+
+void trace_event(TraceKind kind, const char *name, long argument)
+{
+    trace_ring().event(kind, name, argument);
+}
+
+#else
+
+// Whether the kernel is capturing is read from the statistics page, so
+// processes don't need a syscall to find out there is nothing to do.
+static const SystemStatistics *_trace_statistics = nullptr;
+static bool _trace_statistics_mapped = false;
+
+static Handle _trace_handle = {HANDLE_INVALID_ID, OPEN_READ, SUCCESS};
+
+bool trace_enabled()
+{
+    if (!_trace_statistics_mapped)
+    {
+        _trace_statistics_mapped = true;
+        statistics_map(&_trace_statistics);
+    }
+
+    return _trace_statistics &&
+           __atomic_load_n(&_trace_statistics->tracing, __ATOMIC_RELAXED);
+}
+
+void trace_event(TraceKind kind, const char *name, long argument)
+{
+    if (_trace_handle.id == HANDLE_INVALID_ID)
+    {
+        __plug_handle_open(&_trace_handle, TRACE_PATH, OPEN_READ);
+
+        if (handle_has_error(&_trace_handle))
+        {
+            _trace_handle.id = HANDLE_INVALID_ID;
+            return;
+        }
+    }
+
+    IOCallTraceRecordArgs args = {};
+    args.kind = kind;
+    args.argument = argument;
+    strlcpy(args.name, name, TRACE_NAME_SIZE);
+
+    __plug_handle_call(&_trace_handle, IOCALL_TRACE_RECORD, &args);
+}
+
+#endif
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <abi/Trace.h>
+
+#include <libsystem/Common.h>
+#include <libsystem/Logger.h>
+
+#define TRACE_PAYLOAD_SIZE 64
+
+#define TRACE_PROCESS_NAME_SIZE 16
+
+// Power of two, so indexes wrap cleanly.
+#define TRACE_RING_SIZE 2048
+
+// The arguments are kept raw in the payload, one word each, or the bytes of
+// the string for %s, and only turned into text when the record is read.
+// Events keep their argument followed by their name there instead.
+struct TraceRecord
+{
+    uint32_t sequence;
+    uint32_t line;
+    uint64_t timestamp; // Microseconds since boot.
+    int16_t task;
+    uint8_t kind;
+    uint8_t level;
+    uint8_t payload_size;
+    const char *file;
+    const char *format;
+    char process[TRACE_PROCESS_NAME_SIZE]; // Only for log lines.
+    uint8_t payload[TRACE_PAYLOAD_SIZE];
+};
+
+enum TraceRead
+{
+    TRACE_READ_OK,
+    TRACE_READ_PENDING,
+    TRACE_READ_LOST,
+};
+
+// Where a reader is in a ring, along with how many records were overwritten
+// before it could get to them.
+struct TraceCursor
+{
+    uint32_t index;
+    size_t lost;
+};
+
+// Writers take a slot with a single atomic increment, so they never wait on
+// each other or on readers, even from an interrupt handler. The oldest
+// records get overwritten, a slot's sequence tells readers whether what they
+// copied is still what they asked for.
+class TraceRing
+{
+    __noncopyable(TraceRing);
+    __nonmovable(TraceRing);
+
+private:
+    uint32_t _head = 0;
+    TraceRecord _records[TRACE_RING_SIZE] = {};
+
+public:
+    constexpr TraceRing() {}
+
+    uint32_t head() const
+    {
+        return __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    }
+
+    void record(LogLevel level, const char *file, uint line, const char *format, va_list va);
+
+    void event(TraceKind kind, const char *name, long argument);
+
+    TraceRead read(uint32_t index, TraceRecord &record) const;
+
+    // Moves the cursor past the next record, skipping to the oldest one still
+    // around if it fell behind.
+    bool next(TraceCursor &cursor, TraceRecord &record) const;
+};
+
+#ifdef __KERNEL__
+
+// Tracepoints and log lines each have their own ring, so capturing a trace
+// doesn't push log lines out before they are written.
+TraceRing &trace_ring();
+
+TraceRing &trace_log_ring();
+
+#endif
+
+// Returns the length of the line, cut short to fit in the buffer.
+size_t trace_format(const TraceRecord &record, char *buffer, size_t size);
+
+void trace_unpack(const TraceRecord &record, TraceEvent &event);
+
+/* --- Tracepoints ---------------------------------------------------------- */
+
+#ifdef __KERNEL__
+void trace_enable(bool enable);
+#endif
+
+// Tracepoints cost a single check while nobody is capturing.
+bool trace_enabled();
+
+void trace_event(TraceKind kind, const char *name, long argument = 0);
+
+static inline void trace_begin(const char *name, long argument = 0)
+{
+    if (trace_enabled())
+    {
+        trace_event(TRACE_BEGIN, name, argument);
+    }
+}
+
+static inline void trace_end(const char *name, long argument = 0)
+{
+    if (trace_enabled())
+    {
+        trace_event(TRACE_END, name, argument);
+    }
+}
+
+static inline void trace_instant(const char *name, long argument = 0)
+{
+    if (trace_enabled())
+    {
+        trace_event(TRACE_INSTANT, name, argument);
+    }
+}
+
+// Begins an event when built and ends it when going out of scope, the end
+// is still recorded if tracing stopped in between, so pairs stay matched.
+class TraceScope
+{
+    __noncopyable(TraceScope);
+    __nonmovable(TraceScope);
+
+private:
+    const char *_name;
+    bool _recorded;
+
+public:
+    TraceScope(const char *name, long argument = 0)
+        : _name(name), _recorded(trace_enabled())
+    {
+        if (_recorded)
+        {
+            trace_event(TRACE_BEGIN, _name, argument);
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (_recorded)
+        {
+            trace_event(TRACE_END, _name);
+        }
+    }
+};
+
+#define __TRACE_SCOPE_NAME(__line) __trace_scope_##__line
+#define __TRACE_SCOPE(__line, __args...) TraceScope __TRACE_SCOPE_NAME(__line)(__args)
+
+#define TRACE_SCOPE(__args...) __TRACE_SCOPE(__LINE__, __args)
@@ -0,0 +1,170 @@
+#include <libsystem/Assert.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libterminal/Scrollback.h>
+
+namespace terminal
+{
+
+static uint16_t attributes_pack(Attributes attributes)
+{
+    return attributes.foreground |
+           (attributes.background << 5) |
+           (attributes.bold << 10) |
+           (attributes.invert << 11) |
+           (attributes.underline << 12);
+}
+
+static Attributes attributes_unpack(uint16_t packed)
+{
+    return {
+        (Color)(packed & 0x1f),
+        (Color)((packed >> 5) & 0x1f),
+        (bool)(packed & (1 << 10)),
+        (bool)(packed & (1 << 11)),
+        (bool)(packed & (1 << 12)),
+    };
+}
+
+static Codepoint cell_codepoint(const Cell &cell)
+{
+    // Keep the text decodable, the UTF-8 decoder can produce more than the
+    // encoder accepts.
+    return cell.codepoint <= 0x10FFFF ? cell.codepoint : U'?';
+}
+
+static bool cell_is_blank(const Cell &cell)
+{
+    return cell.codepoint == U' ' &&
+           cell.attributes.background == BACKGROUND &&
+           !cell.attributes.invert &&
+           !cell.attributes.underline;
+}
+
+Scrollback::Scrollback(int capacity)
+{
+    _capacity = MAX(capacity, 0);
+
+    if (_capacity > 0)
+    {
+        _lines = (Line **)calloc(_capacity, sizeof(Line *));
+    }
+}
+
+Scrollback::~Scrollback()
+{
+    clear();
+    free(_lines);
+}
+
+void Scrollback::clear()
+{
+    for (int i = 0; i < _count; i++)
+    {
+        free(_lines[(_first + i) % _capacity]);
+    }
+
+    _first = 0;
+    _count = 0;
+}
+
+void Scrollback::push(const Cell *cells, int width)
+{
+    if (_capacity == 0)
+    {
+        return;
+    }
+
+    while (width > 0 && cell_is_blank(cells[width - 1]))
+    {
+        width--;
+    }
+
+    size_t runs = 0;
+    size_t text = 0;
+
+    for (int x = 0; x < width; x++)
+    {
+        if (x == 0 || cells[x].attributes != cells[x - 1].attributes)
+        {
+            runs++;
+        }
+
+        uint8_t utf8[5];
+        text += codepoint_to_utf8(cell_codepoint(cells[x]), utf8);
+    }
+
+    // codepoint_to_utf8() always writes a nul terminator after the bytes.
+    Line *line = (Line *)malloc(sizeof(Line) + sizeof(Run) * runs + text + 1);
+    Run *run = (Run *)(line + 1);
+    uint8_t *bytes = (uint8_t *)(run + runs);
+
+    line->cells = width;
+    line->runs = runs;
+    line->text = text;
+
+    for (int x = 0; x < width; x++)
+    {
+        if (x == 0 || cells[x].attributes != cells[x - 1].attributes)
+        {
+            if (x != 0)
+            {
+                run++;
+            }
+
+            run->cells = 0;
+            run->attributes = attributes_pack(cells[x].attributes);
+        }
+
+        run->cells++;
+        bytes += codepoint_to_utf8(cell_codepoint(cells[x]), bytes);
+    }
+
+    if (_count == _capacity)
+    {
+        free(_lines[_first]);
+        _lines[_first] = line;
+        _first = (_first + 1) % _capacity;
+    }
+    else
+    {
+        _lines[(_first + _count) % _capacity] = line;
+        _count++;
+    }
+}
+
+void Scrollback::line(int index, Cell *cells, int width) const
+{
+    assert(index >= 0 && index < _count);
+
+    const Line *line = _lines[(_first + index) % _capacity];
+    const Run *runs = (const Run *)(line + 1);
+    const uint8_t *bytes = (const uint8_t *)(runs + line->runs);
+
+    int x = 0;
+
+    for (size_t i = 0; i < line->runs; i++)
+    {
+        Attributes attributes = attributes_unpack(runs[i].attributes);
+
+        for (size_t j = 0; j < runs[i].cells; j++)
+        {
+            Codepoint codepoint = 0;
+            bytes += utf8_to_codepoint(bytes, &codepoint);
+
+            if (x < width)
+            {
+                cells[x] = {codepoint, attributes, true};
+            }
+
+            x++;
+        }
+    }
+
+    for (; x < width; x++)
+    {
+        cells[x] = {U' ', Attributes::defaults(), true};
+    }
+}
+
+} // namespace terminal
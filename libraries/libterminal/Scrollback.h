@@ -0,0 +1,54 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libterminal/Cell.h>
+
+namespace terminal
+{
+
+// Lines that scrolled off the top of the screen. They are stored as UTF-8
+// text with runs of packed attributes instead of full cells, trailing
+// blanks are dropped. Once full, the oldest line is forgotten.
+class Scrollback
+{
+    __noncopyable(Scrollback);
+    __nonmovable(Scrollback);
+
+private:
+    struct Run
+    {
+        uint16_t cells;
+        uint16_t attributes;
+    };
+
+    // Followed by the runs and then the text, in the same allocation.
+    struct Line
+    {
+        uint16_t cells;
+        uint16_t runs;
+        uint16_t text;
+    };
+
+    Line **_lines = nullptr;
+    int _capacity = 0;
+    int _first = 0;
+    int _count = 0;
+
+public:
+    int count() const { return _count; }
+
+    int capacity() const { return _capacity; }
+
+    Scrollback(int capacity);
+
+    ~Scrollback();
+
+    void clear();
+
+    void push(const Cell *cells, int width);
+
+    // Index 0 is the oldest line, cells past its end are blanks.
+    void line(int index, Cell *cells, int width) const;
+};
+
+} // namespace terminal
@@ -6,14 +6,19 @@
 namespace terminal
 {
 
-Terminal::Terminal(int width, int height)
+Terminal::Terminal(int width, int height, int scrollback)
+    : _scrollback(scrollback)
 {
     _width = width;
     _height = height;
     _buffer = (Cell *)calloc(_width * _height, sizeof(Cell));
+    _top = 0;
+    _dirty_first = 0;
+    _dirty_last = height - 1;
 
     _decoder.callback([this](auto codepoint) { write(codepoint); });
 
+    _state = State::WAIT_ESC;
     _cursor = {0, 0, true};
     _saved_cursor = {0, 0, true};
 
@@ -78,10 +83,14 @@ void Terminal::resize(int width, int height)
 
     free(_buffer);
     _buffer = new_buffer;
+    _top = 0;
 
     _width = width;
     _height = height;
 
+    _dirty_first = 0;
+    _dirty_last = height - 1;
+
     _cursor.x = clamp(_cursor.x, 0, width - 1);
     _cursor.y = clamp(_cursor.y, 0, height - 1);
 }
@@ -90,7 +99,7 @@ Cell Terminal::cell_at(int x, int y)
 {
     if (x >= 0 && x < _width && y >= 0 && y < _height)
     {
-        return _buffer[y * _width + x];
+        return row(y)[x];
     }
 
     return {U' ', _attributes, true};
@@ -100,7 +109,7 @@ void Terminal::cell_undirty(int x, int y)
 {
     if (x >= 0 && x < _width && y >= 0 && y < _height)
     {
-        _buffer[y * _width + x].dirty = false;
+        row(y)[x].dirty = false;
     }
 }
 
@@ -109,13 +118,15 @@ void Terminal::set_cell(int x, int y, Cell cell)
     if (x >= 0 && x < _width &&
         y >= 0 && y < _height)
     {
-        Cell old_cell = _buffer[y * _width + x];
+        Cell &old_cell = row(y)[x];
 
         if (old_cell.codepoint != cell.codepoint ||
             old_cell.attributes != cell.attributes)
         {
-            _buffer[y * _width + x] = cell;
-            _buffer[y * _width + x].dirty = true;
+            old_cell = cell;
+            old_cell.dirty = true;
+
+            damage(y, y);
         }
     }
 }
@@ -168,33 +179,25 @@ void Terminal::scroll(int how_many_line)
 {
     if (how_many_line < 0)
     {
-        for (int line = 0; line < how_many_line; line++)
+        for (int line = 0; line < -how_many_line; line++)
         {
-            for (int i = (_width * _height) - 1; i >= _height; i++)
-            {
-                int x = i % _width;
-                int y = i / _width;
-
-                set_cell(x, y, cell_at(x, y - 1));
-            }
-
+            _top = (_top + _height - 1) % _height;
             clear_line(0);
         }
+
+        damage(0, _height - 1);
     }
     else if (how_many_line > 0)
     {
         for (int line = 0; line < how_many_line; line++)
         {
-            for (int i = 0; i < _width * (_height - 1); i++)
-            {
-                int x = i % _width;
-                int y = i / _width;
-
-                set_cell(x, y, cell_at(x, y + 1));
-            }
+            _scrollback.push(row(0), _width);
 
+            _top = (_top + 1) % _height;
             clear_line(_height - 1);
         }
+
+        damage(0, _height - 1);
     }
 }
 
@@ -233,6 +236,56 @@ void Terminal::append(Codepoint codepoint)
     }
 }
 
+void Terminal::append(const uint8_t *text, size_t size)
+{
+    size_t i = 0;
+
+    while (i < size)
+    {
+        if (_cursor.x >= _width || _cursor.y >= _height)
+        {
+            Codepoint codepoint = 0;
+            i += utf8_to_codepoint(text + i, &codepoint);
+            append(codepoint);
+
+            continue;
+        }
+
+        // Fill the row up to the end of the text or of the line, whichever
+        // comes first, then let cursor_move() wrap and scroll.
+        Cell *cells = row(_cursor.y);
+        bool line_full = false;
+
+        while (i < size)
+        {
+            Codepoint codepoint = 0;
+            i += utf8_to_codepoint(text + i, &codepoint);
+
+            Cell &cell = cells[_cursor.x];
+
+            if (cell.codepoint != codepoint || cell.attributes != _attributes)
+            {
+                cell = {codepoint, _attributes, true};
+            }
+
+            if (_cursor.x + 1 == _width)
+            {
+                line_full = true;
+                break;
+            }
+
+            _cursor.x++;
+        }
+
+        damage(_cursor.y, _cursor.y);
+
+        if (line_full)
+        {
+            cursor_move(1, 0);
+        }
+    }
+}
+
 void Terminal::do_ansi(Codepoint codepoint)
 {
     switch (codepoint)
@@ -375,22 +428,22 @@ void Terminal::do_ansi(Codepoint codepoint)
     case U'S':
         if (_parameters[0].empty)
         {
-            scroll(-1);
+            scroll(1);
         }
         else
         {
-            scroll(-_parameters[0].value);
+            scroll(_parameters[0].value);
         }
         break;
 
     case U'T':
         if (_parameters[0].empty)
         {
-            scroll(1);
+            scroll(-1);
         }
         else
         {
-            scroll(_parameters[0].value);
+            scroll(-_parameters[0].value);
         }
         break;
 
@@ -526,11 +579,83 @@ void Terminal::write(char c)
     _decoder.write(c);
 }
 
+// Length of the run of printable ASCII and complete UTF-8 sequences at the
+// start of the buffer.
+static size_t printable_run(const uint8_t *buffer, size_t size)
+{
+    size_t i = 0;
+
+    while (i < size)
+    {
+        uint8_t byte = buffer[i];
+
+        if (byte >= 0x20 && byte < 0x7f)
+        {
+            i++;
+            continue;
+        }
+
+        size_t length = 0;
+
+        if ((byte & 0xe0) == 0xc0 && byte >= 0xc2)
+        {
+            length = 2;
+        }
+        else if ((byte & 0xf0) == 0xe0)
+        {
+            length = 3;
+        }
+        else if ((byte & 0xf8) == 0xf0 && byte <= 0xf4)
+        {
+            length = 4;
+        }
+
+        if (length == 0 || i + length > size)
+        {
+            return i;
+        }
+
+        for (size_t j = 1; j < length; j++)
+        {
+            if ((buffer[i + j] & 0xc0) != 0x80)
+            {
+                return i;
+            }
+        }
+
+        i += length;
+    }
+
+    return i;
+}
+
 void Terminal::write(const char *buffer, size_t size)
 {
-    for (size_t i = 0; i < size; i++)
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(buffer);
+
+    size_t i = 0;
+
+    while (i < size)
     {
-        write(buffer[i]);
+        // Escape sequences, control characters and codepoints split across
+        // two writes go through the decoder and the state machine.
+        size_t run = 0;
+
+        if (_state == State::WAIT_ESC && !_decoder.decoding())
+        {
+            run = printable_run(bytes + i, size - i);
+        }
+
+        if (run > 0)
+        {
+            append(bytes + i, run);
+            i += run;
+        }
+        else
+        {
+            write(buffer[i]);
+            i++;
+        }
     }
 }
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <libsystem/math/MinMax.h>
 #include <libsystem/unicode/UTF8Decoder.h>
 #include <libterminal/Attributes.h>
 #include <libterminal/Cell.h>
 #include <libterminal/Cursor.h>
+#include <libterminal/Scrollback.h>
 
 namespace terminal
 {
@@ -26,7 +28,17 @@ struct Terminal
 private:
     int _height;
     int _width;
+
+    // The rows on screen form a ring starting at _top, scrolling only moves
+    // _top and clears the row that comes in.
     Cell *_buffer;
+    int _top;
+
+    // Rows changed since the last undirty().
+    int _dirty_first;
+    int _dirty_last;
+
+    Scrollback _scrollback;
     UTF8Decoder _decoder;
 
     State _state;
@@ -39,14 +51,40 @@ private:
     int _parameters_top;
     Parameter _parameters[MAX_PARAMETERS];
 
+    Cell *row(int y) { return &_buffer[((_top + y) % _height) * _width]; }
+
+    void damage(int first, int last)
+    {
+        _dirty_first = MIN(_dirty_first, first);
+        _dirty_last = MAX(_dirty_last, last);
+    }
+
+    void append(const uint8_t *text, size_t size);
+
 public:
+    static constexpr int DEFAULT_SCROLLBACK = 1000;
+
     int width() { return _width; }
 
     int height() { return _height; }
 
     const Cursor &cursor() { return _cursor; }
 
-    Terminal(int width, int height);
+    const Scrollback &scrollback() { return _scrollback; }
+
+    bool dirty() { return _dirty_first <= _dirty_last; }
+
+    int dirty_first() { return _dirty_first; }
+
+    int dirty_last() { return _dirty_last; }
+
+    void undirty()
+    {
+        _dirty_first = _height;
+        _dirty_last = -1;
+    }
+
+    Terminal(int width, int height, int scrollback = DEFAULT_SCROLLBACK);
 
     ~Terminal();
 
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <libsystem/Common.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
+#include <libutils/Move.h>
+#include <libutils/New.h>
+
+// Hands out memory by bumping a pointer through large chunks. Nothing is
+// freed on its own, everything goes away at once when the arena is cleared
+// or destroyed, and destructors are never called.
+class Arena
+{
+    __noncopyable(Arena);
+    __nonmovable(Arena);
+
+private:
+    static constexpr size_t ALIGNMENT = 8;
+    static constexpr size_t MIN_CHUNK_SIZE = 4096;
+    static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024;
+
+    // Followed by the data, in the same allocation.
+    struct Chunk
+    {
+        Chunk *next;
+        size_t size;
+    };
+
+    Chunk *_chunks = nullptr;
+    size_t _used = 0;
+    size_t _next_chunk_size = MIN_CHUNK_SIZE;
+    size_t _allocated = 0;
+
+    Chunk *create_chunk(size_t size)
+    {
+        Chunk *chunk = (Chunk *)malloc(sizeof(Chunk) + size);
+        chunk->size = size;
+
+        _allocated += size;
+
+        return chunk;
+    }
+
+    void *allocate_slow(size_t size)
+    {
+        // Big allocations get their own chunk, behind the current one, so
+        // what is left of it doesn't go to waste.
+        if (_chunks && size > _next_chunk_size / 4)
+        {
+            Chunk *chunk = create_chunk(size);
+            chunk->next = _chunks->next;
+            _chunks->next = chunk;
+
+            return chunk + 1;
+        }
+
+        Chunk *chunk = create_chunk(MAX(size, _next_chunk_size));
+        chunk->next = _chunks;
+        _chunks = chunk;
+        _used = size;
+
+        _next_chunk_size = MIN(_next_chunk_size * 2, MAX_CHUNK_SIZE);
+
+        return chunk + 1;
+    }
+
+public:
+    // Bytes taken from the heap, used or not.
+    size_t allocated() const { return _allocated; }
+
+    Arena() {}
+
+    // Size the next chunk for what is known to come, like the size of a
+    // document about to be parsed.
+    void reserve(size_t size)
+    {
+        _next_chunk_size = __align_up(MAX(size, MIN_CHUNK_SIZE), ALIGNMENT);
+    }
+
+    ~Arena()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        while (_chunks)
+        {
+            Chunk *next = _chunks->next;
+            free(_chunks);
+            _chunks = next;
+        }
+
+        _used = 0;
+        _allocated = 0;
+        _next_chunk_size = MIN_CHUNK_SIZE;
+    }
+
+    void *allocate(size_t size)
+    {
+        size = __align_up(MAX(size, 1), ALIGNMENT);
+
+        if (!_chunks || _used + size > _chunks->size)
+        {
+            return allocate_slow(size);
+        }
+
+        void *address = (char *)(_chunks + 1) + _used;
+        _used += size;
+
+        return address;
+    }
+
+    template <typename T, typename... TArgs>
+    T *make(TArgs &&... args)
+    {
+        return new (allocate(sizeof(T))) T(forward<TArgs>(args)...);
+    }
+
+    template <typename T>
+    T *make_array(size_t count)
+    {
+        return (T *)allocate(sizeof(T) * count);
+    }
+
+    const char *duplicate(const char *string, size_t length)
+    {
+        char *copy = (char *)allocate(length + 1);
+
+        memcpy(copy, string, length);
+        copy[length] = '\0';
+
+        return copy;
+    }
+};
@@ -1,9 +1,19 @@
 #pragma once
 
 #include <libsystem/Logger.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/math/MinMax.h>
 #include <libutils/Hash.h>
-#include <libutils/Vector.h>
+#include <libutils/Iteration.h>
+#include <libutils/Move.h>
+#include <libutils/New.h>
 
+// Items live in a dense array in insertion order, which is also the order
+// of iteration. An open addressing index using robin hood hashing maps the
+// hashes to positions in that array and grows with the number of items.
+// Removing an item leaves a hole in the array until it is compacted when it
+// grows, so items can be removed while iterating but not added. An empty
+// map doesn't allocate anything.
 template <typename TKey, typename TValue>
 class HashMap
 {
@@ -11,106 +21,311 @@ private:
     struct Item
     {
         uint32_t hash;
+        bool used;
         TKey key;
         TValue value;
     };
 
-    static constexpr int BUCKET_COUNT = 256;
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t item;
+    };
+
+    static constexpr uint32_t SLOT_EMPTY = 0xffffffff;
+    static constexpr size_t MIN_CAPACITY = 8;
 
-    Vector<Vector<Item>> _buckets{};
+    Item *_items = nullptr;
+    size_t _items_count = 0;
+    size_t _items_capacity = 0;
+    size_t _count = 0;
 
-    Vector<Item> &bucket(uint32_t hash)
+    Slot *_slots = nullptr;
+    size_t _slots_capacity = 0;
+
+    static uint32_t key_hash(const TKey &key) { return hash<TKey>(key); }
+
+    // Lets maps with String keys be searched without building a String.
+    static uint32_t key_hash(const char *key) { return hash(key, strlen(key)); }
+
+    size_t distance(size_t slot, uint32_t hash) const
     {
-        return _buckets[hash % BUCKET_COUNT];
+        return (slot - hash) & (_slots_capacity - 1);
     }
 
-    Item *item_by_key(const TKey &key)
+    template <typename TLookup>
+    size_t slot_by_key(const TLookup &key, uint32_t hash) const
     {
-        return item_by_key(key, hash<TKey>(key));
+        if (_count == 0)
+        {
+            return SLOT_EMPTY;
+        }
+
+        size_t mask = _slots_capacity - 1;
+        size_t slot = hash & mask;
+
+        for (size_t probe = 0;; probe++)
+        {
+            const Slot &current = _slots[slot];
+
+            // Robin hood keeps the slots sorted by distance, the key can't
+            // be further than a slot closer to its own home.
+            if (current.item == SLOT_EMPTY || distance(slot, current.hash) < probe)
+            {
+                return SLOT_EMPTY;
+            }
+
+            if (current.hash == hash && _items[current.item].key == key)
+            {
+                return slot;
+            }
+
+            slot = (slot + 1) & mask;
+        }
     }
 
-    Item *item_by_key(const TKey &key, uint32_t hash)
+    void index_insert(uint32_t hash, uint32_t item)
     {
-        Item *result = nullptr;
-        auto &b = bucket(hash);
+        size_t mask = _slots_capacity - 1;
+        size_t slot = hash & mask;
+        size_t probe = 0;
 
-        b.foreach ([&](Item &item) {
-            if (item.hash == hash && item.key == key)
+        Slot carried = {hash, item};
+
+        while (_slots[slot].item != SLOT_EMPTY)
+        {
+            size_t existing = distance(slot, _slots[slot].hash);
+
+            if (existing < probe)
             {
-                result = &item;
-                return Iteration::STOP;
+                swap(_slots[slot], carried);
+                probe = existing;
             }
-            else
+
+            slot = (slot + 1) & mask;
+            probe++;
+        }
+
+        _slots[slot] = carried;
+    }
+
+    void index_remove(size_t slot)
+    {
+        size_t mask = _slots_capacity - 1;
+        size_t next = (slot + 1) & mask;
+
+        // Shift the following slots back instead of leaving a tombstone.
+        while (_slots[next].item != SLOT_EMPTY && distance(next, _slots[next].hash) > 0)
+        {
+            _slots[slot] = _slots[next];
+            slot = next;
+            next = (next + 1) & mask;
+        }
+
+        _slots[slot].item = SLOT_EMPTY;
+    }
+
+    void index_rebuild(size_t capacity)
+    {
+        free(_slots);
+
+        _slots = reinterpret_cast<Slot *>(malloc(capacity * sizeof(Slot)));
+        _slots_capacity = capacity;
+
+        for (size_t i = 0; i < capacity; i++)
+        {
+            _slots[i].item = SLOT_EMPTY;
+        }
+
+        for (size_t i = 0; i < _items_count; i++)
+        {
+            if (_items[i].used)
             {
-                return Iteration::CONTINUE;
+                index_insert(_items[i].hash, i);
             }
-        });
+        }
+    }
 
-        return result;
+    static size_t index_capacity_for(size_t count)
+    {
+        size_t capacity = MIN_CAPACITY;
+
+        // Keep the load factor under 80%.
+        while (count * 5 > capacity * 4)
+        {
+            capacity *= 2;
+        }
+
+        return capacity;
     }
 
-public:
-    size_t count()
+    void items_destroy(Item &item)
+    {
+        item.key.~TKey();
+        item.value.~TValue();
+        item.used = false;
+    }
+
+    void items_rebuild(size_t capacity)
     {
-        size_t result = 0;
+        Item *items = reinterpret_cast<Item *>(malloc(capacity * sizeof(Item)));
+        size_t count = 0;
 
-        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        for (size_t i = 0; i < _items_count; i++)
         {
-            result += _buckets[i].count();
+            if (!_items[i].used)
+            {
+                continue;
+            }
+
+            items[count].hash = _items[i].hash;
+            items[count].used = true;
+            new (&items[count].key) TKey(move(_items[i].key));
+            new (&items[count].value) TValue(move(_items[i].value));
+
+            items_destroy(_items[i]);
+            count++;
         }
 
-        return result;
+        free(_items);
+
+        _items = items;
+        _items_count = count;
+        _items_capacity = capacity;
     }
 
-    HashMap()
+    template <typename TLookup>
+    Item &insert(const TLookup &key, uint32_t hash)
+    {
+        if (_items_count == _items_capacity)
+        {
+            // Compacts the holes left by removed items, and only really
+            // grows when most of the items are still there.
+            items_rebuild(MAX(MIN_CAPACITY, _count * 2));
+            index_rebuild(index_capacity_for(_count + 1));
+        }
+        else if ((_count + 1) * 5 > _slots_capacity * 4)
+        {
+            index_rebuild(index_capacity_for(_count + 1));
+        }
+
+        size_t index = _items_count;
+        Item &item = _items[index];
+
+        item.hash = hash;
+        item.used = true;
+        new (&item.key) TKey(key);
+        new (&item.value) TValue();
+
+        _items_count++;
+        _count++;
+
+        index_insert(hash, index);
+
+        return item;
+    }
+
+    void remove_slot(size_t slot)
     {
-        for (size_t i = 0; i < BUCKET_COUNT; i++)
+        items_destroy(_items[_slots[slot].item]);
+        index_remove(slot);
+        _count--;
+
+        if (_count == 0)
         {
-            _buckets.push_back({});
+            _items_count = 0;
         }
     }
 
+    void copy_from(const HashMap &other)
+    {
+        other.foreach ([&](auto &key, auto &value) {
+            insert(key, key_hash(key)).value = value;
+            return Iteration::CONTINUE;
+        });
+    }
+
+public:
+    size_t count() const
+    {
+        return _count;
+    }
+
+    HashMap()
+    {
+    }
+
     HashMap(const HashMap &other)
-        : _buckets(other._buckets)
     {
+        copy_from(other);
     }
 
     HashMap(HashMap &&other)
-        : _buckets(move(other._buckets))
     {
+        swap(_items, other._items);
+        swap(_items_count, other._items_count);
+        swap(_items_capacity, other._items_capacity);
+        swap(_count, other._count);
+        swap(_slots, other._slots);
+        swap(_slots_capacity, other._slots_capacity);
     }
 
-    void clear()
+    ~HashMap()
     {
-        _buckets.clear();
+        clear();
+
+        free(_items);
+        free(_slots);
     }
 
-    void remove_key(TKey &key)
+    void clear()
     {
-        uint32_t h = hash<TKey>(key);
+        for (size_t i = 0; i < _items_count; i++)
+        {
+            if (_items[i].used)
+            {
+                items_destroy(_items[i]);
+            }
+        }
 
-        bucket(h).remove_all_match([&](auto &item) {
-            return item.hash == h && item.key == key;
-        });
+        for (size_t i = 0; i < _slots_capacity; i++)
+        {
+            _slots[i].item = SLOT_EMPTY;
+        }
+
+        _items_count = 0;
+        _count = 0;
     }
 
-    void remove_value(TValue &value)
+    template <typename TLookup>
+    void remove_key(const TLookup &key)
     {
-        _buckets.foreach ([&](auto &bucket) {
-            bucket.remove_all_match([&](auto &item) {
-                return item.value == value;
-            });
+        size_t slot = slot_by_key(key, key_hash(key));
 
-            return Iteration::CONTINUE;
-        });
+        if (slot != SLOT_EMPTY)
+        {
+            remove_slot(slot);
+        }
     }
 
-    bool has_key(const TKey &key)
+    void remove_value(const TValue &value)
     {
-        return item_by_key(key) != nullptr;
+        for (size_t i = 0; i < _items_count; i++)
+        {
+            if (_items[i].used && _items[i].value == value)
+            {
+                remove_key(_items[i].key);
+            }
+        }
     }
 
-    bool has_value(const TValue &value)
+    template <typename TLookup>
+    bool has_key(const TLookup &key) const
+    {
+        return slot_by_key(key, key_hash(key)) != SLOT_EMPTY;
+    }
+
+    bool has_value(const TValue &value) const
     {
         bool result = false;
 
@@ -132,38 +347,52 @@ public:
     template <typename TCallback>
     void foreach (TCallback callback) const
     {
-        _buckets.foreach ([&](auto &bucket) {
-            return bucket.foreach ([&](auto &item) {
-                return callback(item.key, item.value);
-            });
-        });
+        for (size_t i = 0; i < _items_count; i++)
+        {
+            if (_items[i].used && callback(_items[i].key, _items[i].value) == Iteration::STOP)
+            {
+                return;
+            }
+        }
     }
 
     HashMap &operator=(const HashMap &other)
     {
-        _buckets = other._buckets;
+        if (this != &other)
+        {
+            clear();
+            copy_from(other);
+        }
+
         return *this;
     }
 
     HashMap &operator=(HashMap &&other)
     {
-        swap(_buckets, other._buckets);
+        if (this != &other)
+        {
+            swap(_items, other._items);
+            swap(_items_count, other._items_count);
+            swap(_items_capacity, other._items_capacity);
+            swap(_count, other._count);
+            swap(_slots, other._slots);
+            swap(_slots_capacity, other._slots_capacity);
+        }
+
         return *this;
     }
 
-    TValue &operator[](const TKey &key)
+    template <typename TLookup>
+    TValue &operator[](const TLookup &key)
     {
-        auto h = hash<TKey>(key);
-        auto *i = item_by_key(key, h);
+        uint32_t hash = key_hash(key);
+        size_t slot = slot_by_key(key, hash);
 
-        if (i)
+        if (slot != SLOT_EMPTY)
         {
-            return i->value;
-        }
-        else
-        {
-            auto &b = bucket(h);
-            return b.push_back({h, key, {}}).value;
+            return _items[_slots[slot].item].value;
         }
+
+        return insert(key, hash).value;
     }
 };
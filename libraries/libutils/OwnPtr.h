@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libsystem/Assert.h>
+#include <libutils/Move.h>
 
 template <typename T>
 class OwnPtr
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libsystem/Common.h>
+#include <libutils/Move.h>
 #include <libutils/RefCounted.h>
 
 enum AdoptTag
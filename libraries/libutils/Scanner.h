@@ -8,6 +8,30 @@
 #include <libsystem/utils/NumberParser.h>
 #include <libutils/RingBuffer.h>
 
+// A set of characters with a constant time lookup, meant to be built at
+// compile time.
+class CharClass
+{
+private:
+    bool _table[256] = {};
+
+public:
+    constexpr explicit CharClass(const char *chars)
+    {
+        for (size_t i = 0; chars[i]; i++)
+        {
+            _table[(uint8_t)chars[i]] = true;
+        }
+    }
+
+    constexpr bool contains(char chr) const
+    {
+        return _table[(uint8_t)chr];
+    }
+};
+
+static constexpr CharClass SCANNER_WHITESPACE{" \n\r\t"};
+
 class Scanner
 {
 public:
@@ -99,6 +123,11 @@ public:
         return false;
     }
 
+    bool current_is(const CharClass &what)
+    {
+        return do_continue() && what.contains(current());
+    }
+
     bool current_is_word(const char *word)
     {
         for (size_t i = 0; word[i]; i++)
@@ -121,6 +150,32 @@ public:
         }
     }
 
+    void eat(const CharClass &what)
+    {
+        while (current_is(what))
+        {
+            foreward();
+        }
+    }
+
+    void eat_whitespace()
+    {
+        eat(SCANNER_WHITESPACE);
+    }
+
+    // Calls the callback with the characters up to one of the two stop
+    // characters or the end of the input.
+    template <typename TCallback>
+    void read_until(char stop, char other_stop, TCallback callback)
+    {
+        while (do_continue() && current() != stop && current() != other_stop)
+        {
+            char chr = current();
+            callback(&chr, 1);
+            foreward();
+        }
+    }
+
     bool skip(char chr)
     {
         if (current() == chr)
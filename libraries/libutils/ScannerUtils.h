@@ -2,7 +2,8 @@
 
 #include <libutils/Scanner.h>
 
-static inline const char *scan_json_escape_sequence(Scanner &scan)
+template <typename TScanner>
+static inline const char *scan_json_escape_sequence(TScanner &scan)
 {
     constexpr auto XDIGITS = "0123456789abcdef";
 
@@ -105,7 +106,8 @@ static inline const char *scan_json_escape_sequence(Scanner &scan)
     return buffer;
 }
 
-static inline void scan_skip_utf8bom(Scanner &scan)
+template <typename TScanner>
+static inline void scan_skip_utf8bom(TScanner &scan)
 {
     scan.skip_word("\xEF\xBB\xBF");
 }
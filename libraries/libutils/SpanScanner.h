@@ -0,0 +1,249 @@
+#pragma once
+
+#include <libsystem/math/MinMax.h>
+#include <libutils/Scanner.h>
+
+#ifdef __SSE2__
+// Vector extensions rather than <emmintrin.h>, which drags in <stdlib.h>.
+typedef char ScannerVector __attribute__((vector_size(16)));
+
+static inline int scanner_vector_mask(ScannerVector vector)
+{
+    return __builtin_ia32_pmovmskb128(vector);
+}
+#endif
+
+// Same interface as Scanner, over a buffer in memory. Nothing is virtual so
+// the parsers templated on their scanner get everything inlined, and the
+// hot loops skip 16 bytes at a time when the library is built with SSE2.
+class SpanScanner
+{
+private:
+    const char *_current;
+    const char *_end;
+
+    size_t remaining() const { return _end - _current; }
+
+public:
+    SpanScanner(const char *string, size_t size)
+        : _current(string), _end(string + size)
+    {
+    }
+
+    bool ended() const { return _current >= _end; }
+
+    bool do_continue() const { return !ended(); }
+
+    void foreward()
+    {
+        if (!ended())
+        {
+            _current++;
+        }
+    }
+
+    void foreward(size_t n)
+    {
+        _current += MIN(n, remaining());
+    }
+
+    char peek(size_t peek) const
+    {
+        if (peek >= remaining())
+        {
+            return '\0';
+        }
+
+        return _current[peek];
+    }
+
+    char current() const
+    {
+        return peek(0);
+    }
+
+    void foreward_codepoint()
+    {
+        if ((current() & 0xf8) == 0xf0)
+        {
+            foreward(4);
+        }
+        else if ((current() & 0xf0) == 0xe0)
+        {
+            foreward(3);
+        }
+        else if ((current() & 0xe0) == 0xc0)
+        {
+            foreward(2);
+        }
+        else
+        {
+            foreward(1);
+        }
+    }
+
+    Codepoint current_codepoint() const
+    {
+        size_t size = 0;
+        Codepoint codepoint = peek(0);
+
+        if ((current() & 0xf8) == 0xf0)
+        {
+            size = 4;
+            codepoint = (0x07 & codepoint) << 18;
+        }
+        else if ((current() & 0xf0) == 0xe0)
+        {
+            size = 3;
+            codepoint = (0x0f & codepoint) << 12;
+        }
+        else if ((current() & 0xe0) == 0xc0)
+        {
+            codepoint = (0x1f & codepoint) << 6;
+            size = 2;
+        }
+
+        for (size_t i = 1; i < size; i++)
+        {
+            codepoint |= (0x3f & peek(i)) << (6 * (size - i - 1));
+        }
+
+        return codepoint;
+    }
+
+    bool current_is(const char *what) const
+    {
+        for (size_t i = 0; what[i]; i++)
+        {
+            if (current() == what[i])
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool current_is(const CharClass &what) const
+    {
+        return !ended() && what.contains(*_current);
+    }
+
+    bool current_is_word(const char *word) const
+    {
+        for (size_t i = 0; word[i]; i++)
+        {
+            if (peek(i) != word[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void eat(const char *what)
+    {
+        while (current_is(what) && do_continue())
+        {
+            foreward();
+        }
+    }
+
+    void eat(const CharClass &what)
+    {
+        while (_current < _end && what.contains(*_current))
+        {
+            _current++;
+        }
+    }
+
+    void eat_whitespace()
+    {
+        // Most runs are a single space, don't bother with vectors for those.
+        if (!current_is(SCANNER_WHITESPACE))
+        {
+            return;
+        }
+
+#ifdef __SSE2__
+        while (remaining() >= 16)
+        {
+            ScannerVector chunk;
+            memcpy(&chunk, _current, 16);
+
+            ScannerVector whitespace = (ScannerVector)((chunk == ' ') | (chunk == '\n') | (chunk == '\r') | (chunk == '\t'));
+
+            int others = ~scanner_vector_mask(whitespace) & 0xffff;
+
+            if (others)
+            {
+                _current += __builtin_ctz(others);
+                return;
+            }
+
+            _current += 16;
+        }
+#endif
+
+        eat(SCANNER_WHITESPACE);
+    }
+
+    template <typename TCallback>
+    void read_until(char stop, char other_stop, TCallback callback)
+    {
+        const char *start = _current;
+
+#ifdef __SSE2__
+        while (remaining() >= 16)
+        {
+            ScannerVector chunk;
+            memcpy(&chunk, _current, 16);
+
+            int found = scanner_vector_mask((ScannerVector)((chunk == stop) | (chunk == other_stop)));
+
+            if (found)
+            {
+                _current += __builtin_ctz(found);
+                break;
+            }
+
+            _current += 16;
+        }
+#endif
+
+        while (_current < _end && *_current != stop && *_current != other_stop)
+        {
+            _current++;
+        }
+
+        if (_current != start)
+        {
+            callback(start, _current - start);
+        }
+    }
+
+    bool skip(char chr)
+    {
+        if (current() == chr)
+        {
+            foreward();
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool skip_word(const char *word)
+    {
+        if (current_is_word(word))
+        {
+            foreward(strlen(word));
+
+            return true;
+        }
+
+        return false;
+    }
+};
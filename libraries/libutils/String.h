@@ -5,55 +5,123 @@
 #include <libutils/RefPtr.h>
 #include <libutils/StringStorage.h>
 
+// Short strings are stored inline and never touch the heap, longer ones
+// share a reference counted StringStorage.
 class String
 {
+public:
+    static constexpr size_t INLINE_CAPACITY = 22;
+
 private:
-    RefPtr<StringStorage> _buffer;
+    static constexpr uint8_t ON_HEAP = 0xff;
+
+    union {
+        StringStorage *_storage;
+        char _inline[INLINE_CAPACITY + 1];
+    };
+
+    uint8_t _inline_length = 0;
+
+    bool on_heap() const { return _inline_length == ON_HEAP; }
+
+    void assign(const char *cstring, size_t length)
+    {
+        if (length <= INLINE_CAPACITY)
+        {
+            memcpy(_inline, cstring, length);
+            _inline[length] = '\0';
+            _inline_length = length;
+        }
+        else
+        {
+            _storage = StringStorage::create(cstring, length).give_ref();
+            _inline_length = ON_HEAP;
+        }
+    }
+
+    void assign(const String &other)
+    {
+        if (other.on_heap())
+        {
+            _storage = ref_if_not_null(other._storage);
+            _inline_length = ON_HEAP;
+        }
+        else
+        {
+            memcpy(_inline, other._inline, other._inline_length + 1);
+            _inline_length = other._inline_length;
+        }
+    }
+
+    void steal(String &other)
+    {
+        memcpy(_inline, other._inline, sizeof(_inline));
+        _inline_length = other._inline_length;
+
+        other._inline[0] = '\0';
+        other._inline_length = 0;
+    }
+
+    void release()
+    {
+        if (on_heap())
+        {
+            deref_if_not_null(_storage);
+        }
+
+        _inline[0] = '\0';
+        _inline_length = 0;
+    }
 
 public:
-    size_t length() const { return _buffer->length(); }
-    const char *cstring() const { return _buffer->cstring(); }
-    char at(int index) const { return _buffer->cstring()[index]; }
+    size_t length() const { return on_heap() ? _storage->length() : _inline_length; }
+    const char *cstring() const { return on_heap() ? _storage->cstring() : _inline; }
+    char at(int index) const { return cstring()[index]; }
 
-    bool null_or_empty() const { return _buffer == nullptr || _buffer->length() == 0; }
+    bool null_or_empty() const { return length() == 0; }
 
     String(const char *cstring = "")
     {
-        _buffer = make<StringStorage>(cstring);
+        assign(cstring, strlen(cstring));
     }
 
     String(const char *cstring, size_t length)
     {
-        _buffer = make<StringStorage>(cstring, length);
+        assign(cstring, length);
     }
 
     String(char c)
     {
-        char cstr[2];
-        cstr[0] = c;
-        _buffer = make<StringStorage>(cstr, 1);
+        assign(&c, 1);
     }
 
     String(RefPtr<StringStorage> storage)
-        : _buffer(storage)
     {
+        _storage = storage.give_ref();
+        _inline_length = ON_HEAP;
     }
 
     String(const String &other)
-        : _buffer(const_cast<String &>(other)._buffer)
     {
+        assign(other);
     }
 
     String(String &&other)
-        : _buffer(move(other._buffer))
     {
+        steal(other);
+    }
+
+    ~String()
+    {
+        release();
     }
 
     String &operator=(const String &other)
     {
         if (this != &other)
         {
-            _buffer = const_cast<String &>(other)._buffer;
+            release();
+            assign(other);
         }
 
         return *this;
@@ -63,7 +131,8 @@ public:
     {
         if (this != &other)
         {
-            swap(_buffer, other._buffer);
+            release();
+            steal(other);
         }
 
         return *this;
@@ -71,14 +140,31 @@ public:
 
     String &operator+=(String &other)
     {
-        _buffer = make<StringStorage>(*_buffer, *other._buffer);
+        size_t left_length = length();
+        size_t right_length = other.length();
+
+        if (!on_heap() && left_length + right_length <= INLINE_CAPACITY)
+        {
+            memcpy(_inline + left_length, other.cstring(), right_length);
+            _inline[left_length + right_length] = '\0';
+            _inline_length = left_length + right_length;
+        }
+        else
+        {
+            StringStorage *storage = StringStorage::create(cstring(), left_length, other.cstring(), right_length).give_ref();
+
+            release();
+
+            _storage = storage;
+            _inline_length = ON_HEAP;
+        }
 
         return *this;
     }
 
     bool operator==(const String &other) const
     {
-        if (_buffer == other._buffer)
+        if (on_heap() && other.on_heap() && _storage == other._storage)
         {
             return true;
         }
@@ -88,15 +174,7 @@ public:
             return false;
         }
 
-        for (size_t i = 0; i < length(); i++)
-        {
-            if (cstring()[i] != other.cstring()[i])
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return memcmp(cstring(), other.cstring(), length()) == 0;
     }
 
     bool operator==(const char *str) const
@@ -106,15 +184,7 @@ public:
             return false;
         }
 
-        for (size_t i = 0; i < length(); i++)
-        {
-            if (cstring()[i] != str[i])
-            {
-                return false;
-            }
-        }
-
-        return true;
+        return memcmp(cstring(), str, length()) == 0;
     }
 
     char operator[](int index) const
@@ -122,9 +192,15 @@ public:
         return at(index);
     }
 
+    // Short strings don't have a storage, one is made for them.
     RefPtr<StringStorage> underlying_storage()
     {
-        return _buffer;
+        if (on_heap())
+        {
+            return RefPtr<StringStorage>(*_storage);
+        }
+
+        return StringStorage::create(_inline, _inline_length);
     }
 };
 
@@ -12,9 +12,29 @@ struct StringBuilder
     __nonmovable(StringBuilder);
 
 private:
+    static constexpr size_t INLINE_CAPACITY = 32;
+
     size_t _used = 0;
-    size_t _size = 0;
-    char *_buffer = nullptr;
+    size_t _size = INLINE_CAPACITY;
+    char *_buffer = _inline;
+
+    // Most strings are short enough to be built without allocating.
+    char _inline[INLINE_CAPACITY];
+
+    void grow(size_t size)
+    {
+        _size = MAX(size, _size + _size / 4);
+
+        if (_buffer == _inline)
+        {
+            _buffer = (char *)malloc(_size);
+            memcpy(_buffer, _inline, _used + 1);
+        }
+        else
+        {
+            _buffer = (char *)realloc(_buffer, _size);
+        }
+    }
 
 public:
     size_t length() const
@@ -22,38 +42,46 @@ public:
         return _used;
     }
 
-    StringBuilder() : StringBuilder(16) {}
+    // Valid until the next append.
+    const char *cstring() const
+    {
+        return _buffer;
+    }
+
+    StringBuilder() : StringBuilder(INLINE_CAPACITY) {}
 
     StringBuilder(size_t preallocated)
     {
-        preallocated = MAX(preallocated, 16);
+        if (preallocated > INLINE_CAPACITY)
+        {
+            _buffer = (char *)malloc(preallocated);
+            _size = preallocated;
+        }
 
-        _buffer = new char[preallocated];
-        _size = preallocated;
-        _used = 0;
+        _buffer[0] = '\0';
     }
 
     ~StringBuilder()
     {
-        if (_buffer)
-            delete[] _buffer;
+        if (_buffer != _inline)
+        {
+            free(_buffer);
+        }
     }
 
     String finalize()
     {
-        char *result = _buffer;
-        size_t size = _used;
+        String result{_buffer, _used};
 
-        _buffer = nullptr;
         _used = 0;
-        _size = 0;
+        _buffer[0] = '\0';
 
-        return String(make<StringStorage>(AdoptTag::ADOPT, result, size));
+        return result;
     }
 
     String intermediate()
     {
-        return String(make<StringStorage>(_buffer, _used));
+        return String(_buffer, _used);
     }
 
     StringBuilder &append(String string)
@@ -86,10 +114,14 @@ public:
         }
         else
         {
-            for (size_t i = 0; i < size; i++)
+            if (_used + size + 1 > _size)
             {
-                append(str[i]);
+                grow(_used + size + 1);
             }
+
+            memcpy(_buffer + _used, str, size);
+            _used += size;
+            _buffer[_used] = '\0';
         }
 
         return *this;
@@ -97,17 +129,9 @@ public:
 
     StringBuilder &append(char chr)
     {
-        if (_size == 0)
-        {
-            _buffer = new char[16];
-            _size = 16;
-            _used = 0;
-        }
-
         if (_used + 1 == _size)
         {
-            _size += _size / 4;
-            _buffer = (char *)realloc(_buffer, _size);
+            grow(_size + _size / 4);
         }
 
         _buffer[_used] = chr;
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <libutils/HashMap.h>
+#include <libutils/String.h>
+
+// Interns identifiers that show up over and over, like the keys of a json
+// document, so they share a single storage and compare by pointer. Strings
+// short enough to be stored inline are returned as is.
+class StringPool
+{
+private:
+    HashMap<String, String> _strings;
+
+public:
+    size_t count() const { return _strings.count(); }
+
+    String intern(const String &string)
+    {
+        if (string.length() <= String::INLINE_CAPACITY)
+        {
+            return string;
+        }
+
+        String &interned = _strings[string];
+
+        if (interned.null_or_empty())
+        {
+            interned = string;
+        }
+
+        return interned;
+    }
+
+    String intern(const char *cstring)
+    {
+        if (_strings.has_key(cstring))
+        {
+            return _strings[cstring];
+        }
+
+        return intern(String(cstring));
+    }
+
+    void clear()
+    {
+        _strings.clear();
+    }
+};
@@ -2,50 +2,58 @@
 
 #include <libsystem/core/CString.h>
 #include <libutils/RefCounted.h>
+#include <libutils/RefPtr.h>
 
+// The characters are stored right after the header, in the same allocation.
 class StringStorage : public RefCounted<StringStorage>
 {
 private:
     size_t _length;
-    char *_buffer;
 
-public:
-    const char *cstring() { return _buffer; }
-
-    size_t length() { return _length; }
+    char *buffer() { return reinterpret_cast<char *>(this + 1); }
 
-    StringStorage(const char *cstring)
-        : StringStorage(cstring, strlen(cstring))
+    StringStorage(size_t length)
+        : _length(length)
     {
+        buffer()[length] = '\0';
     }
 
-    StringStorage(const char *cstring, size_t length)
+    static void *operator new(size_t size, size_t length)
     {
-        _length = length;
-        _buffer = new char[length + 1];
-        memcpy(_buffer, cstring, length);
-        _buffer[length] = '\0';
+        return ::operator new(size + length + 1);
     }
 
-    StringStorage(AdoptTag, char *buffer, size_t length)
+public:
+    static void operator delete(void *ptr)
     {
-        _length = length;
-        _buffer = buffer;
+        ::operator delete(ptr);
     }
 
-    StringStorage(StringStorage &left, StringStorage &right)
+    const char *cstring() { return buffer(); }
+
+    size_t length() { return _length; }
+
+    static RefPtr<StringStorage> create(const char *cstring)
     {
-        _length = left.length() + right.length();
-        _buffer = new char[_length + 1];
+        return create(cstring, strlen(cstring));
+    }
 
-        memcpy(_buffer, left.cstring(), left.length());
-        memcpy(_buffer + left.length(), right.cstring(), right.length());
+    static RefPtr<StringStorage> create(const char *cstring, size_t length)
+    {
+        StringStorage *storage = new (length) StringStorage(length);
+        memcpy(storage->buffer(), cstring, length);
 
-        _buffer[left.length() + right.length()] = '\0';
+        return adopt(*storage);
     }
 
-    ~StringStorage()
+    static RefPtr<StringStorage> create(const char *left, size_t left_length, const char *right, size_t right_length)
     {
-        delete _buffer;
+        StringStorage *storage = new (left_length + right_length) StringStorage(left_length + right_length);
+        memcpy(storage->buffer(), left, left_length);
+        memcpy(storage->buffer() + left_length, right, right_length);
+
+        return adopt(*storage);
     }
+
+    ~StringStorage() {}
 };
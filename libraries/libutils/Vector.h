@@ -191,15 +191,37 @@ public:
     template <typename Comparator>
     void sort(Comparator comparator)
     {
-        for (size_t i = 0; i < _count - 1; i++)
-        {
-            for (size_t j = i + 1; j < _count; j++)
+        // Heap sort, in place and without the quadratic worst case, vectors
+        // of a few thousand elements are sorted regularly.
+        auto sift_down = [&](size_t root, size_t end) {
+            while (root * 2 + 1 < end)
             {
-                if (comparator(_storage[i], _storage[j]) > 0)
+                size_t child = root * 2 + 1;
+
+                if (child + 1 < end && comparator(_storage[child], _storage[child + 1]) < 0)
+                {
+                    child++;
+                }
+
+                if (comparator(_storage[root], _storage[child]) >= 0)
                 {
-                    swap(_storage[i], _storage[j]);
+                    return;
                 }
+
+                swap(_storage[root], _storage[child]);
+                root = child;
             }
+        };
+
+        for (size_t i = _count / 2; i > 0; i--)
+        {
+            sift_down(i - 1, _count);
+        }
+
+        for (size_t end = _count; end > 1; end--)
+        {
+            swap(_storage[0], _storage[end - 1]);
+            sift_down(0, end - 1);
         }
     }
 
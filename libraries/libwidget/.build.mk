@@ -2,3 +2,6 @@ LIBS += WIDGET
 
 WIDGET_NAME = widget
 WIDGET_ICONS = chevron-up chevron-down alert
+
+WIDGET_SHARED = true
+WIDGET_NEEDED = markup graphic system
@@ -109,6 +109,9 @@ void application_wait_for_ack()
     }
 }
 
+// The compositor batches its events, so read as many as it sent at once.
+#define APPLICATION_MESSAGES_PER_READ 16
+
 void application_request_callback(
     void *target,
     Connection *connection,
@@ -117,24 +120,29 @@ void application_request_callback(
     __unused(target);
     __unused(events);
 
-    CompositorMessage message = {};
-    memset((void *)&message, 0xff, sizeof(CompositorMessage));
-    size_t message_size = connection_receive(connection, &message, sizeof(CompositorMessage));
+    CompositorMessage messages[APPLICATION_MESSAGES_PER_READ] = {};
+    memset((void *)&messages, 0xff, sizeof(messages));
+    size_t messages_size = connection_receive(connection, &messages, sizeof(messages));
 
     if (handle_has_error(connection))
     {
         logger_error("Connection to the compositor closed %s!", handle_error_string(connection));
         application_exit(-1);
+        return;
     }
 
-    if (message_size != sizeof(CompositorMessage))
+    if (messages_size == 0 || messages_size % sizeof(CompositorMessage) != 0)
     {
-        logger_error("Got a message with an invalid size from compositor %u != %u!", sizeof(CompositorMessage), message_size);
-        hexdump(&message, message_size);
+        logger_error("Got a message with an invalid size from compositor %u != %u!", sizeof(CompositorMessage), messages_size);
+        hexdump(&messages, messages_size);
         application_exit(-1);
+        return;
     }
 
-    application_do_message(&message);
+    for (size_t i = 0; i < messages_size / sizeof(CompositorMessage) && _state != APPLICATION_EXITING; i++)
+    {
+        application_do_message(&messages[i]);
+    }
 }
 
 Result application_initialize(int argc, char **argv)
@@ -1,10 +1,13 @@
 #include <libmarkup/Markup.h>
 #include <libsystem/Logger.h>
 #include <libsystem/core/CString.h>
+#include <libsystem/io/File.h>
 #include <libsystem/utils/NumberParser.h>
+#include <libutils/Hash.h>
 #include <libutils/Scanner.h>
 
 #include <libwidget/Markup.h>
+#include <libwidget/MarkupBinary.h>
 #include <libwidget/Widgets.h>
 
 static void whitespace(Scanner &scan)
@@ -395,7 +398,7 @@ Window *window_create_from_markup(MarkupNode *node)
     return window;
 }
 
-Window *window_create_from_file(const char *path)
+Window *window_create_from_markup_file(const char *path)
 {
     MarkupNode *root = markup_parse_file(path);
 
@@ -407,3 +410,333 @@ Window *window_create_from_file(const char *path)
 
     return window;
 }
+
+/* --- Compiled markup ------------------------------------------------------ */
+
+struct MarkupBinary
+{
+    const MarkupBinaryNode *nodes;
+    size_t node_count;
+
+    const char *strings;
+    size_t strings_size;
+
+    const char *string(uint32_t offset) const
+    {
+        if (offset >= strings_size)
+        {
+            return nullptr;
+        }
+
+        return strings + offset;
+    }
+
+    const char *string_or_default(uint32_t offset, const char *default_value) const
+    {
+        const char *result = string(offset);
+        return result ? result : default_value;
+    }
+};
+
+static bool markup_binary_validate(const MarkupBinary &binary)
+{
+    if (binary.node_count == 0 ||
+        binary.strings_size == 0 ||
+        binary.strings[binary.strings_size - 1] != '\0')
+    {
+        return false;
+    }
+
+    // Every node must be reached exactly once by the pre-order walk.
+    size_t pending = 1;
+
+    for (size_t i = 0; i < binary.node_count; i++)
+    {
+        if (pending == 0)
+        {
+            return false;
+        }
+
+        pending = pending - 1 + binary.nodes[i].childs;
+
+        if (binary.nodes[i].type >= binary.strings_size ||
+            binary.nodes[i].layout > LAYOUT_HFLOW ||
+            binary.nodes[i].position > (uint8_t)Position::BOTTOM_RIGHT)
+        {
+            return false;
+        }
+    }
+
+    return pending == 0;
+}
+
+static void widget_apply_attribute_from_binary(Widget *widget, const MarkupBinary &binary, const MarkupBinaryNode &node)
+{
+    const char *id = binary.string(node.id);
+
+    if (id)
+    {
+        widget->id(id);
+    }
+
+    if (node.flags & MARKUP_BINARY_HAS_LAYOUT)
+    {
+        widget->layout((Layout){
+            (LayoutType)node.layout,
+            node.layout_arguments[0],
+            node.layout_arguments[1],
+            Vec2i(node.layout_arguments[2], node.layout_arguments[3]),
+        });
+    }
+
+    if (node.flags & MARKUP_BINARY_HAS_PADDING)
+    {
+        widget->insets(Insets(node.padding[0], node.padding[1], node.padding[2], node.padding[3]));
+    }
+
+    if (node.flags & MARKUP_BINARY_FILL)
+    {
+        widget->attributes(LAYOUT_FILL);
+    }
+}
+
+static Widget *widget_create_from_binary(Widget *parent, const MarkupBinary &binary, const MarkupBinaryNode &node)
+{
+    Widget *widget = nullptr;
+
+    switch (node.widget)
+    {
+    case MARKUP_BINARY_CONTAINER:
+        widget = new Container(parent);
+        break;
+
+    case MARKUP_BINARY_PANEL:
+    {
+        auto panel = new Panel(parent);
+
+        if (node.flags & MARKUP_BINARY_ROUNDED)
+        {
+            panel->border_radius(6);
+        }
+
+        widget = panel;
+        break;
+    }
+
+    case MARKUP_BINARY_BUTTON:
+    {
+        ButtonStyle button_style = BUTTON_TEXT;
+
+        if (node.flags & MARKUP_BINARY_FILLED)
+        {
+            button_style = BUTTON_FILLED;
+        }
+
+        if (node.flags & MARKUP_BINARY_OUTLINED)
+        {
+            button_style = BUTTON_OUTLINE;
+        }
+
+        const char *text = binary.string(node.text);
+        const char *icon = binary.string(node.icon);
+
+        if (text && icon)
+        {
+            widget = new Button(parent, button_style, Icon::get(icon), text);
+        }
+        else if (text)
+        {
+            widget = new Button(parent, button_style, text);
+        }
+        else if (icon)
+        {
+            widget = new Button(parent, button_style, Icon::get(icon));
+        }
+        else
+        {
+            widget = new Button(parent, button_style);
+        }
+
+        break;
+    }
+
+    case MARKUP_BINARY_LABEL:
+        widget = new Label(parent, binary.string_or_default(node.text, "Label"), (Position)node.position);
+        break;
+
+    case MARKUP_BINARY_IMAGE:
+        widget = new Image(parent, Bitmap::load_from_or_placeholder(binary.string_or_default(node.path, "null")));
+        break;
+
+    case MARKUP_BINARY_SLIDER:
+        widget = new Slider(parent);
+        break;
+
+    default:
+        widget = new Placeholder(parent, binary.string(node.type));
+        break;
+    }
+
+    widget_apply_attribute_from_binary(widget, binary, node);
+
+    return widget;
+}
+
+static size_t widget_create_childs_from_binary(Widget *parent, const MarkupBinary &binary, size_t index)
+{
+    size_t childs = binary.nodes[index].childs;
+    index++;
+
+    for (size_t i = 0; i < childs; i++)
+    {
+        Widget *child_widget = widget_create_from_binary(parent, binary, binary.nodes[index]);
+
+        index = widget_create_childs_from_binary(child_widget, binary, index);
+    }
+
+    return index;
+}
+
+static Window *window_create_from_binary(const MarkupBinary &binary)
+{
+    const MarkupBinaryNode &root = binary.nodes[0];
+
+    WindowFlag flags = 0;
+
+    if (root.flags & MARKUP_BINARY_BORDERLESS)
+    {
+        flags |= WINDOW_BORDERLESS;
+    }
+
+    if (root.flags & MARKUP_BINARY_RESIZABLE)
+    {
+        flags |= WINDOW_RESIZABLE;
+    }
+
+    if (root.flags & MARKUP_BINARY_ALWAYS_FOCUSED)
+    {
+        flags |= WINDOW_ALWAYS_FOCUSED;
+    }
+
+    if (root.flags & MARKUP_BINARY_SWALLOW)
+    {
+        flags |= WINDOW_SWALLOW;
+    }
+
+    if (root.flags & MARKUP_BINARY_TRANSPARENT)
+    {
+        flags |= WINDOW_TRANSPARENT;
+    }
+
+    auto window = new Window(flags);
+
+    window->size(Vec2i(root.width, root.height));
+
+    const char *icon = binary.string(root.icon);
+
+    if (icon)
+    {
+        window->icon(Icon::get(icon));
+    }
+
+    const char *title = binary.string(root.title);
+
+    if (title)
+    {
+        window->title(title);
+    }
+
+    widget_apply_attribute_from_binary(window->root(), binary, root);
+    widget_create_childs_from_binary(window->root(), binary, 0);
+
+    return window;
+}
+
+static bool markup_source_match(const char *path, const MarkupBinaryHeader *header)
+{
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(path, &buffer, &size) != SUCCESS)
+    {
+        return false;
+    }
+
+    bool match = header->source_size == size &&
+                 header->source_hash == hash(buffer, size);
+
+    file_unmap(buffer);
+
+    return match;
+}
+
+Window *window_create_from_compiled_file(const char *path)
+{
+    char compiled_path[PATH_LENGTH];
+
+    if (snprintf(compiled_path, PATH_LENGTH, "%s" MARKUP_BINARY_EXTENSION, path) >= PATH_LENGTH)
+    {
+        return nullptr;
+    }
+
+    const void *buffer = nullptr;
+    size_t size = 0;
+
+    if (file_map(compiled_path, &buffer, &size) != SUCCESS)
+    {
+        return nullptr;
+    }
+
+    auto header = reinterpret_cast<const MarkupBinaryHeader *>(buffer);
+
+    if (size < sizeof(MarkupBinaryHeader) ||
+        header->node_count > size / sizeof(MarkupBinaryNode) ||
+        header->magic != MARKUP_BINARY_MAGIC ||
+        header->version != MARKUP_BINARY_VERSION ||
+        sizeof(MarkupBinaryHeader) + (size_t)header->node_count * sizeof(MarkupBinaryNode) + header->strings_size != size)
+    {
+        logger_warn("%s is not a valid compiled markup file", compiled_path);
+        file_unmap(buffer);
+        return nullptr;
+    }
+
+    // The source was edited since it was compiled.
+    if (!markup_source_match(path, header))
+    {
+        file_unmap(buffer);
+        return nullptr;
+    }
+
+    MarkupBinary binary = {
+        .nodes = reinterpret_cast<const MarkupBinaryNode *>(header + 1),
+        .node_count = header->node_count,
+        .strings = reinterpret_cast<const char *>(header + 1) + header->node_count * sizeof(MarkupBinaryNode),
+        .strings_size = header->strings_size,
+    };
+
+    if (!markup_binary_validate(binary))
+    {
+        logger_warn("%s is not a valid compiled markup file", compiled_path);
+        file_unmap(buffer);
+        return nullptr;
+    }
+
+    Window *window = window_create_from_binary(binary);
+
+    // Every string was copied by the widgets.
+    file_unmap(buffer);
+
+    return window;
+}
+
+Window *window_create_from_file(const char *path)
+{
+    Window *window = window_create_from_compiled_file(path);
+
+    if (window)
+    {
+        return window;
+    }
+
+    return window_create_from_markup_file(path);
+}
@@ -2,4 +2,11 @@
 
 #include <libwidget/Window.h>
 
+// Build the window described by the markup file at path, using the copy
+// compiled by toolbox/markup-compiler.py when there is an up to date one.
 Window *window_create_from_file(const char *path);
+
+Window *window_create_from_markup_file(const char *path);
+
+// Returns nullptr when there is no valid compiled copy of the markup file.
+Window *window_create_from_compiled_file(const char *path);
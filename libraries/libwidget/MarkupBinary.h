@@ -0,0 +1,83 @@
+#pragma once
+
+#include <libsystem/Common.h>
+
+// Markup files compiled ahead of time by toolbox/markup-compiler.py. The
+// compiler resolves every attribute the way libwidget/Markup.cpp would, so
+// building the widgets only walks a flat array of nodes. A compiled file
+// sits next to its source with MARKUP_BINARY_EXTENSION appended and holds
+// a header, the nodes in pre-order and a blob of nul terminated strings.
+// The header has the size and hash() (libutils/Hash.h) of the source, a
+// compiled file that doesn't match it anymore is ignored.
+
+#define MARKUP_BINARY_EXTENSION ".bin"
+
+#define MARKUP_BINARY_MAGIC 0x4250524d /* MRPB */
+#define MARKUP_BINARY_VERSION 2
+
+#define MARKUP_BINARY_NO_STRING 0xffffffff
+
+enum MarkupBinaryWidget : uint8_t
+{
+    MARKUP_BINARY_WINDOW,
+    MARKUP_BINARY_CONTAINER,
+    MARKUP_BINARY_PANEL,
+    MARKUP_BINARY_BUTTON,
+    MARKUP_BINARY_LABEL,
+    MARKUP_BINARY_IMAGE,
+    MARKUP_BINARY_SLIDER,
+    MARKUP_BINARY_PLACEHOLDER,
+};
+
+#define MARKUP_BINARY_HAS_LAYOUT (1 << 0)
+#define MARKUP_BINARY_HAS_PADDING (1 << 1)
+#define MARKUP_BINARY_FILL (1 << 2)
+#define MARKUP_BINARY_ROUNDED (1 << 3)
+#define MARKUP_BINARY_FILLED (1 << 4)
+#define MARKUP_BINARY_OUTLINED (1 << 5)
+#define MARKUP_BINARY_BORDERLESS (1 << 6)
+#define MARKUP_BINARY_RESIZABLE (1 << 7)
+#define MARKUP_BINARY_ALWAYS_FOCUSED (1 << 8)
+#define MARKUP_BINARY_SWALLOW (1 << 9)
+#define MARKUP_BINARY_TRANSPARENT (1 << 10)
+
+struct MarkupBinaryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t source_size;
+    uint32_t source_hash;
+    uint32_t node_count;
+    uint32_t strings_size;
+};
+
+struct MarkupBinaryNode
+{
+    uint8_t widget;
+    uint8_t layout;
+    uint8_t position;
+    uint8_t reserved;
+    uint16_t flags;
+    uint16_t childs;
+
+    // hcell, vcell, horizontal and vertical spacing.
+    int32_t layout_arguments[4];
+
+    // top, bottom, left and right.
+    int32_t padding[4];
+
+    // Offsets in the string blob, or MARKUP_BINARY_NO_STRING.
+    uint32_t type;
+    uint32_t id;
+    uint32_t text;
+    uint32_t icon;
+    uint32_t path;
+    uint32_t title;
+
+    // Only used by the root node.
+    int32_t width;
+    int32_t height;
+};
+
+static_assert(sizeof(MarkupBinaryHeader) == 24);
+static_assert(sizeof(MarkupBinaryNode) == 72);
@@ -4,6 +4,7 @@
 #include <libsystem/eventloop/EventLoop.h>
 #include <libsystem/io/Stream.h>
 #include <libsystem/system/Memory.h>
+#include <libsystem/trace/Trace.h>
 #include <libwidget/Application.h>
 #include <libwidget/Event.h>
 #include <libwidget/Screen.h>
@@ -154,6 +155,8 @@ void Window::repaint(Rectangle rectangle)
 
 void Window::repaint_dirty()
 {
+    TRACE_SCOPE("repaint");
+
     // FIXME: find a better way to schedule update after layout.
 
     if (dirty_layout)
@@ -2,12 +2,44 @@
 
 #include <libgraphic/Color.h>
 #include <libutils/Observable.h>
+#include <libutils/Vector.h>
 
 #include <libwidget/utils/Variant.h>
 
+// What changed during the last update. Row indexes of successive updates
+// are relative to the model as it was after the previous one.
+struct TableModelUpdate
+{
+    enum Type
+    {
+        EVERYTHING,
+        CHANGED,
+        INSERTED,
+        REMOVED,
+    };
+
+    Type type;
+
+    // Rows [first, first + count), unused for EVERYTHING.
+    int first;
+    int count;
+};
+
 class TableModel : public RefCounted<TableModel>,
                    public Observable<TableModel>
 {
+private:
+    static constexpr size_t MAX_INCREMENTAL_UPDATES = 64;
+
+    TableModelUpdate _last_update = {TableModelUpdate::EVERYTHING, 0, 0};
+
+    void notify(TableModelUpdate update)
+    {
+        _last_update = update;
+        Observable<TableModel>::did_update();
+        _last_update = {TableModelUpdate::EVERYTHING, 0, 0};
+    }
+
 public:
     TableModel() {}
 
@@ -42,4 +74,120 @@ public:
     {
         ASSERT_NOT_REACHED();
     }
+
+    const TableModelUpdate &last_update() const { return _last_update; }
+
+    void did_update()
+    {
+        notify({TableModelUpdate::EVERYTHING, 0, 0});
+    }
+
+    // The content of some rows changed, but not the number of rows.
+    void did_update_rows(int first, int count)
+    {
+        notify({TableModelUpdate::CHANGED, first, count});
+    }
+
+    void did_insert_rows(int first, int count)
+    {
+        notify({TableModelUpdate::INSERTED, first, count});
+    }
+
+    void did_remove_rows(int first, int count)
+    {
+        notify({TableModelUpdate::REMOVED, first, count});
+    }
+
+    // For models whose rows are sorted by a key, walk the previous and the
+    // current rows side by side and only notify what was inserted, removed
+    // or changed. compare_keys(old_row, new_row) orders the keys like strcmp
+    // and equal(old_row, new_row) tells if two rows with the same key are
+    // displayed the same way.
+    template <typename TCompareKeys, typename TEqual>
+    void did_update_sorted(int old_count, int new_count, TCompareKeys compare_keys, TEqual equal)
+    {
+        if (old_count == 0 || new_count == 0)
+        {
+            did_update();
+            return;
+        }
+
+        Vector<TableModelUpdate> updates{};
+
+        auto push = [&](TableModelUpdate::Type type, int row) {
+            if (updates.any())
+            {
+                auto &last = updates[updates.count() - 1];
+
+                if (last.type == type && type == TableModelUpdate::REMOVED && last.first == row)
+                {
+                    last.count++;
+                    return;
+                }
+
+                if (last.type == type && type != TableModelUpdate::REMOVED && last.first + last.count == row)
+                {
+                    last.count++;
+                    return;
+                }
+            }
+
+            updates.push_back({type, row, 1});
+        };
+
+        int old_row = 0;
+        int new_row = 0;
+
+        while (old_row < old_count || new_row < new_count)
+        {
+            int order = 0;
+
+            if (old_row == old_count)
+            {
+                order = 1;
+            }
+            else if (new_row == new_count)
+            {
+                order = -1;
+            }
+            else
+            {
+                order = compare_keys(old_row, new_row);
+            }
+
+            // new_row is also the position of the current row in the model
+            // as the observers see it after the updates pushed so far.
+            if (order < 0)
+            {
+                push(TableModelUpdate::REMOVED, new_row);
+                old_row++;
+            }
+            else if (order > 0)
+            {
+                push(TableModelUpdate::INSERTED, new_row);
+                new_row++;
+            }
+            else
+            {
+                if (!equal(old_row, new_row))
+                {
+                    push(TableModelUpdate::CHANGED, new_row);
+                }
+
+                old_row++;
+                new_row++;
+            }
+        }
+
+        if (updates.count() > MAX_INCREMENTAL_UPDATES)
+        {
+            did_update();
+            return;
+        }
+
+        for (size_t i = 0; i < updates.count(); i++)
+        {
+            notify(updates[i]);
+        }
+    }
 };
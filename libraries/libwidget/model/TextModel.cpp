@@ -1,3 +1,4 @@
+#include <libsystem/io/File.h>
 #include <libutils/Scanner.h>
 
 #include <libwidget/model/TextModel.h>
@@ -13,9 +14,15 @@ RefPtr<TextModel> TextModel::from_file(const char *path)
 {
     auto model = make<TextModel>();
 
-    Stream *stream = stream_open(path, OPEN_READ | OPEN_BUFFERED);
+    const void *buffer = nullptr;
+    size_t size = 0;
 
-    StreamScanner scan{stream};
+    if (file_map(path, &buffer, &size) != SUCCESS)
+    {
+        size = 0;
+    }
+
+    StringScanner scan{(const char *)buffer, size};
 
     // Skip the utf8 bom header if present.
     scan.skip_word("\xEF\xBB\xBF");
@@ -35,7 +42,7 @@ RefPtr<TextModel> TextModel::from_file(const char *path)
         model->append_line(line);
     }
 
-    stream_close(stream);
+    file_unmap(buffer);
 
     if (model->line_count() == 0)
     {
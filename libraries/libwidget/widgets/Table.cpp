@@ -1,4 +1,6 @@
 #include <libgraphic/Painter.h>
+#include <libsystem/core/CString.h>
+#include <libsystem/unicode/Codepoint.h>
 #include <libwidget/Theme.h>
 #include <libwidget/Window.h>
 #include <libwidget/widgets/ScrollBar.h>
@@ -73,25 +75,174 @@ int Table::row_at(Vec2i position) const
     return row;
 }
 
-void Table::paint_cell(Painter &painter, int row, int column)
+int Table::first_visible_row() const
 {
-    Rectangle bound = cell_bound(row, column);
-    Variant data = _model->data(row, column);
+    return MAX(0, _scroll_offset / TABLE_ROW_HEIGHT - 1);
+}
+
+int Table::last_visible_row() const
+{
+    return MIN(_model->rows() - 1, (_scroll_offset + list_bound().height()) / TABLE_ROW_HEIGHT);
+}
+
+Table::CachedRow &Table::cached_row(int row)
+{
+    if (_rows.empty())
+    {
+        _rows.push_back({});
+    }
+
+    CachedRow &cached = _rows[row % _rows.count()];
+
+    if (cached.row == row)
+    {
+        return cached;
+    }
+
+    cached.row = row;
+    cached.cells.clear();
+
+    int column_width = list_bound().width() / _model->columns();
 
+    for (int column = 0; column < _model->columns(); column++)
+    {
+        Variant data = _model->data(row, column);
+
+        // Glyphs past the end of the column would be clipped anyway.
+        int available = column_width - (data.has_icon() ? 7 + 18 + 7 : 7);
+        const char *text = data.as_string();
+
+        size_t length = 0;
+        int width = 0;
+
+        while (text[length] && width < available)
+        {
+            Codepoint codepoint = 0;
+            int size = utf8_to_codepoint(reinterpret_cast<const uint8_t *>(text + length), &codepoint);
+
+            if (size == 0)
+            {
+                break;
+            }
+
+            width += font()->glyph(codepoint).advance;
+            length += size;
+        }
+
+        cached.cells.push_back({String(text, length), data.icon()});
+    }
+
+    return cached;
+}
+
+void Table::damage_rows(int first, int count)
+{
+    if (first < 0 || count <= 0)
+    {
+        return;
+    }
+
+    if (_dirty_first > _dirty_last)
+    {
+        _dirty_first = first;
+        _dirty_last = first + count - 1;
+    }
+    else
+    {
+        _dirty_first = MIN(_dirty_first, first);
+        _dirty_last = MAX(_dirty_last, first + count - 1);
+    }
+}
+
+void Table::invalidate_rows(int first, int count)
+{
+    for (size_t i = 0; i < _rows.count(); i++)
+    {
+        if (_rows[i].row >= first && _rows[i].row < first + count)
+        {
+            _rows[i].row = -1;
+        }
+    }
+
+    damage_rows(first, count);
+}
+
+void Table::invalidate_all()
+{
+    for (size_t i = 0; i < _rows.count(); i++)
+    {
+        _rows[i].row = -1;
+    }
+
+    _body_valid = false;
+    _header_valid = false;
+}
+
+void Table::scroll_body(int offset)
+{
+    int height = _body->height();
+    int width = _body->width();
+
+    if (abs(offset) >= height)
+    {
+        _body_valid = false;
+        return;
+    }
+
+    // Move the rows that stay on screen, only the ones scrolling in have to
+    // be painted.
+    Color *pixels = _body->pixels();
+
+    if (offset > 0)
+    {
+        memmove(pixels, pixels + offset * width, (height - offset) * width * sizeof(Color));
+    }
+    else
+    {
+        memmove(pixels - offset * width, pixels, (height + offset) * width * sizeof(Color));
+    }
+
+    Rectangle exposed = offset > 0
+                            ? Rectangle(0, height - offset, width, offset)
+                            : Rectangle(0, 0, width, -offset);
+
+    int row_y = TABLE_ROW_HEIGHT - _scroll_offset;
+
+    int first = (exposed.y() - row_y) / TABLE_ROW_HEIGHT;
+    int last = (exposed.y() + exposed.height() - 1 - row_y) / TABLE_ROW_HEIGHT;
+
+    if (exposed.y() < row_y)
+    {
+        first = -1;
+    }
+
+    if (last >= 0)
+    {
+        damage_rows(MAX(0, first), last - MAX(0, first) + 1);
+    }
+
+    Painter painter(_body);
+    painter.clear_rectangle(exposed, Colors::TRANSPARENT);
+
+    _header_valid = false;
+}
+
+void Table::paint_cell(Painter &painter, Rectangle bound, Cell &cell)
+{
     painter.push();
     painter.clip(bound);
 
-    if (data.has_icon())
+    if (cell.icon)
     {
         painter.blit_icon(
-            *data.icon(),
+            *cell.icon,
             ICON_18PX,
             Rectangle(bound.x() + 7, bound.y() + 7, 18, 18),
             color(THEME_FOREGROUND));
 
         painter.draw_string(
             *font(),
-            data.as_string(),
+            cell.text.cstring(),
             Vec2i(bound.x() + 7 + 18 + 7, bound.y() + 20),
             color(THEME_FOREGROUND));
     }
@@ -99,7 +250,7 @@ void Table::paint_cell(Painter &painter, int row, int column)
     {
         painter.draw_string(
             *font(),
-            data.as_string(),
+            cell.text.cstring(),
             Vec2i(bound.x() + 7, bound.y() + 20),
             color(THEME_FOREGROUND));
     }
@@ -107,71 +258,158 @@ void Table::paint_cell(Painter &painter, int row, int column)
     painter.pop();
 }
 
-Table::Table(Widget *parent, RefPtr<TableModel> model)
-    : Widget(parent),
-      _model(model)
+void Table::paint_row(Painter &painter, int row)
 {
-    _model_observer = model->observe([this](auto &) {
-        should_repaint();
-        should_relayout();
-    });
+    Rectangle bound = row_bound(row);
 
-    _selected = -1;
-    _scroll_offset = 0;
+    painter.clear_rectangle(bound, Colors::TRANSPARENT);
 
-    _scrollbar = new ScrollBar(this);
+    if (_selected == row)
+    {
+        painter.fill_rectangle(bound, color(THEME_SELECTION));
+        painter.draw_rectangle(bound, color(THEME_SELECTION));
+    }
+    else if (row % 2)
+    {
+        painter.fill_rectangle(bound, color(THEME_FOREGROUND).with_alpha(0.05));
+    }
 
-    _scrollbar->on(Event::VALUE_CHANGE, [this](auto) {
-        _scroll_offset = _scrollbar->value();
-        should_repaint();
-    });
+    CachedRow &cached = cached_row(row);
+
+    for (int column = 0; column < (int)cached.cells.count(); column++)
+    {
+        paint_cell(painter, cell_bound(row, column), cached.cells[column]);
+    }
+
+    if (bound.colide_with(header_bound()))
+    {
+        _header_valid = false;
+    }
 }
 
-void Table::paint(Painter &painter, Rectangle rectangle)
+bool Table::update_body()
 {
-    __unused(rectangle);
+    Rectangle body = body_bound();
 
-    painter.push();
-    painter.clip(bound());
+    if (body.is_empty())
+    {
+        return false;
+    }
 
-    int column_count = _model->columns();
-    int column_width = body_bound().width() / column_count;
+    if (!_body || _body->width() != body.width() || _body->height() != body.height())
+    {
+        auto body_or_result = Bitmap::create_private(body.width(), body.height());
 
-    if (_model->rows() == 0)
+        if (!body_or_result.success())
+        {
+            return false;
+        }
+
+        _body = body_or_result.take_value();
+        _body_valid = false;
+    }
+
+    // The colors change with the focus of the window.
+    Color colors[2] = {
+        color(THEME_FOREGROUND),
+        color(THEME_SELECTION),
+    };
+
+    if (memcmp(colors, _body_colors, sizeof(colors)) != 0)
+    {
+        memcpy(_body_colors, colors, sizeof(colors));
+        _body_valid = false;
+    }
+
+    if (_body_valid && _scroll_offset != _body_scroll_offset)
     {
-        painter.draw_string_within(*font(), _empty_message.cstring(), list_bound().take_top(TABLE_ROW_HEIGHT), Position::CENTER, color(THEME_FOREGROUND));
+        scroll_body(_scroll_offset - _body_scroll_offset);
+    }
+
+    _body_scroll_offset = _scroll_offset;
+
+    Painter painter(_body);
+    painter.transform(Vec2i::zero() - body.position());
+
+    if (!_body_valid)
+    {
+        painter.clear(Colors::TRANSPARENT);
+
+        if (_model->rows() == 0)
+        {
+            painter.draw_string_within(*font(), _empty_message.cstring(), list_bound().take_top(TABLE_ROW_HEIGHT), Position::CENTER, color(THEME_FOREGROUND));
+        }
+
+        for (int row = first_visible_row(); row <= last_visible_row(); row++)
+        {
+            paint_row(painter, row);
+        }
+
+        _body_valid = true;
+        _header_valid = false;
     }
     else
     {
-        for (int row = MAX(0, _scroll_offset / TABLE_ROW_HEIGHT - 1);
-             row < MIN(_model->rows(), ((_scroll_offset + list_bound().height()) / TABLE_ROW_HEIGHT) + 1);
+        for (int row = MAX(_dirty_first, first_visible_row());
+             row <= MIN(_dirty_last, last_visible_row());
              row++)
         {
+            paint_row(painter, row);
+        }
 
-            if (_selected == row)
-            {
-                painter.fill_rectangle(row_bound(row), color(THEME_SELECTION));
-                painter.draw_rectangle(row_bound(row), color(THEME_SELECTION));
-            }
-            else if (row % 2)
-            {
-                painter.fill_rectangle(row_bound(row), color(THEME_FOREGROUND).with_alpha(0.05));
-            }
+        // Rows were removed from the end.
+        if (_dirty_last >= _model->rows())
+        {
+            Rectangle end = row_bound(_model->rows());
+            Rectangle below = Rectangle(body.x(), end.y(), body.width(), body.y() + body.height() - end.y()).clipped_with(body);
+
+            painter.clear_rectangle(below, Colors::TRANSPARENT);
 
-            for (int column = 0; column < column_count; column++)
+            if (below.colide_with(header_bound()))
             {
-                paint_cell(painter, row, column);
+                _header_valid = false;
             }
         }
     }
-    painter.blur_rectangle(header_bound(), 8);
-    painter.fill_rectangle(header_bound(), color(THEME_BACKGROUND).with_alpha(0.9));
+
+    _dirty_first = 0;
+    _dirty_last = -1;
+
+    return true;
+}
+
+void Table::paint_header()
+{
+    Rectangle header = header_bound();
+
+    if (!_header || _header->width() != header.width() || _header->height() != header.height())
+    {
+        auto header_or_result = Bitmap::create_private(header.width(), header.height());
+
+        if (!header_or_result.success())
+        {
+            return;
+        }
+
+        _header = header_or_result.take_value();
+    }
+
+    Painter painter(_header);
+
+    painter.blit_bitmap_no_alpha(*_body, header.moved(header.position() - body_bound().position()), _header->bound());
+    painter.blur_rectangle(_header->bound(), 8);
+    painter.fill_rectangle(_header->bound(), color(THEME_BACKGROUND).with_alpha(0.9));
+
+    painter.transform(Vec2i::zero() - header.position());
+
+    int column_count = _model->columns();
+    int column_width = body_bound().width() / column_count;
 
     for (int column = 0; column < column_count; column++)
     {
         Rectangle header_bound_cell = Rectangle(
-            header_bound().x() + column * column_width,
-            header_bound().y(),
+            header.x() + column * column_width,
+            header.y(),
             column_width,
             TABLE_ROW_HEIGHT);
 
@@ -184,7 +422,100 @@ void Table::paint(Painter &painter, Rectangle rectangle)
         painter.draw_string(*font(), _model->header(column).cstring(), Vec2i(header_bound_cell.x() + 7 + 1, header_bound_cell.y() + 20), color(THEME_FOREGROUND));
     }
 
-    painter.pop();
+    _header_valid = true;
+}
+
+Table::Table(Widget *parent, RefPtr<TableModel> model)
+    : Widget(parent),
+      _model(model)
+{
+    _model_observer = model->observe([this](TableModel &model) {
+        auto &update = model.last_update();
+
+        switch (update.type)
+        {
+        case TableModelUpdate::CHANGED:
+            invalidate_rows(update.first, update.count);
+            break;
+
+        case TableModelUpdate::INSERTED:
+            if (_selected >= update.first)
+            {
+                _selected += update.count;
+            }
+
+            // The rows after the insertion moved down.
+            invalidate_rows(update.first, model.rows() - update.first);
+            should_relayout();
+            break;
+
+        case TableModelUpdate::REMOVED:
+            if (_selected >= update.first + update.count)
+            {
+                _selected -= update.count;
+            }
+            else if (_selected >= update.first)
+            {
+                _selected = -1;
+            }
+
+            // The rows after the removal moved up, the ones past the new
+            // end have to be cleared.
+            invalidate_rows(update.first, model.rows() + update.count - update.first);
+
+            if (model.rows() == 0)
+            {
+                invalidate_all();
+            }
+
+            should_relayout();
+            break;
+
+        default:
+            invalidate_all();
+            should_relayout();
+            break;
+        }
+
+        should_repaint();
+    });
+
+    _selected = -1;
+    _scroll_offset = 0;
+
+    _scrollbar = new ScrollBar(this);
+
+    _scrollbar->on(Event::VALUE_CHANGE, [this](auto) {
+        _scroll_offset = _scrollbar->value();
+        should_repaint();
+    });
+}
+
+void Table::paint(Painter &painter, Rectangle rectangle)
+{
+    if (!update_body())
+    {
+        return;
+    }
+
+    if (!_header_valid)
+    {
+        paint_header();
+    }
+
+    // Only copy the part of the table that has to be repainted.
+    Rectangle body = body_bound();
+    Rectangle dirty = rectangle.clipped_with(body);
+
+    painter.blit_bitmap(*_body, dirty.moved(dirty.position() - body.position()), dirty);
+
+    if (_header && dirty.colide_with(header_bound()))
+    {
+        Rectangle header = header_bound();
+        Rectangle dirty_header = dirty.clipped_with(header);
+
+        painter.blit_bitmap(*_header, dirty_header.moved(dirty_header.position() - header.position()), dirty_header);
+    }
 }
 
 void Table::event(Event *event)
@@ -220,6 +551,24 @@ void Table::event(Event *event)
 
 void Table::do_layout()
 {
+    size_t visible_rows = list_bound().height() / TABLE_ROW_HEIGHT + 3;
+
+    if (_rows.count() != visible_rows)
+    {
+        _rows.clear();
+
+        for (size_t i = 0; i < visible_rows; i++)
+        {
+            _rows.push_back({});
+        }
+    }
+
+    if (_layout_width != list_bound().width())
+    {
+        _layout_width = list_bound().width();
+        invalidate_all();
+    }
+
     _scrollbar->bound(scrollbar_bound());
     _scrollbar->update(TABLE_ROW_HEIGHT * _model->rows(), list_bound().height(), _scroll_offset);
 }
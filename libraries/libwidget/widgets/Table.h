@@ -1,6 +1,8 @@
 #pragma once
 
+#include <libgraphic/Bitmap.h>
 #include <libutils/String.h>
+#include <libutils/Vector.h>
 
 #include <libwidget/model/TableModel.h>
 #include <libwidget/widgets/ScrollBar.h>
@@ -10,6 +12,21 @@ class Table : public Widget
 private:
     static constexpr int TABLE_ROW_HEIGHT = 32;
 
+    // The content of a cell as it is painted, the text is already cut after
+    // the last glyph that fits in the column.
+    struct Cell
+    {
+        String text;
+        RefPtr<Icon> icon;
+    };
+
+    // Only the rows on screen are kept, in a ring indexed by row number.
+    struct CachedRow
+    {
+        int row = -1;
+        Vector<Cell> cells;
+    };
+
     RefPtr<TableModel> _model;
     OwnPtr<Observer<TableModel>> _model_observer;
 
@@ -19,6 +36,22 @@ private:
 
     String _empty_message{"No data to display"};
 
+    Vector<CachedRow> _rows;
+
+    // The body as it was last painted, rows scroll under the header so it
+    // also covers the header area. The blurred header is kept separately.
+    // Both are transparent where nothing is drawn, so whatever is behind the
+    // table shows through.
+    RefPtr<Bitmap> _body;
+    RefPtr<Bitmap> _header;
+    bool _body_valid = false;
+    bool _header_valid = false;
+    int _body_scroll_offset = 0;
+    int _layout_width = -1;
+    int _dirty_first = 0;
+    int _dirty_last = -1;
+    Color _body_colors[2] = {};
+
     Rectangle body_bound() const;
     Rectangle scrollbar_bound() const;
     Rectangle header_bound() const;
@@ -27,7 +60,19 @@ private:
     Rectangle column_bound(int column) const;
     Rectangle cell_bound(int row, int column) const;
     int row_at(Vec2i position) const;
-    void paint_cell(Painter &painter, int row, int column);
+    int first_visible_row() const;
+    int last_visible_row() const;
+
+    CachedRow &cached_row(int row);
+    void damage_rows(int first, int count);
+    void invalidate_rows(int first, int count);
+    void invalidate_all();
+
+    bool update_body();
+    void scroll_body(int offset);
+    void paint_row(Painter &painter, int row);
+    void paint_cell(Painter &painter, Rectangle bound, Cell &cell);
+    void paint_header();
 
 public:
     void empty_message(String message)
@@ -49,6 +94,9 @@ public:
             return;
         }
 
+        damage_rows(_selected, 1);
+        damage_rows(index, 1);
+
         _selected = index;
         should_repaint();
     }
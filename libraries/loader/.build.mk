@@ -0,0 +1,28 @@
+LOADER_BINARY = $(BUILD_DIRECTORY_LIBS)/ld.so
+
+LOADER_SOURCES = $(wildcard libraries/loader/*.cpp)
+
+LOADER_OBJECTS = $(patsubst libraries/%.cpp, $(BUILD_DIRECTORY)/libraries/%.o, $(LOADER_SOURCES))
+
+# The loader stays mapped next to the program, away from where executables
+# and the libraries it maps after them start.
+LOADER_ADDRESS = 0xE0000000
+
+LOADER_CXXFLAGS = \
+	-ffreestanding \
+	-fno-tree-loop-distribute-patterns \
+	-fno-rtti \
+	-fno-exceptions
+
+TARGETS += $(LOADER_BINARY)
+OBJECTS += $(LOADER_OBJECTS)
+
+$(LOADER_BINARY): $(LOADER_OBJECTS)
+	$(DIRECTORY_GUARD)
+	@echo [LOADER] [LD] $@
+	@$(CXX) -static -nostdlib -Wl,-e,__loader_start -Wl,-Ttext-segment=$(LOADER_ADDRESS) -o $@ $^ -lgcc
+
+$(BUILD_DIRECTORY)/libraries/loader/%.o: libraries/loader/%.cpp
+	$(DIRECTORY_GUARD)
+	@echo [LOADER] [CXX] $<
+	@$(CXX) $(CXXFLAGS) $(LOADER_CXXFLAGS) -c -o $@ $<
@@ -0,0 +1,549 @@
+#include <abi/Launchpad.h>
+#include <abi/Paths.h>
+#include <abi/Syscalls.h>
+
+#include <libfile/ELF32.h>
+#include <libfile/ELF64.h>
+
+/* --- Dynamic loader ------------------------------------------------------- */
+
+// The kernel starts this instead of dynamically linked programs. It maps
+// the libraries they need, links everything and jumps to the program.
+//
+// It is the one loading libsystem, so it doesn't use it: everything goes
+// through syscalls and lives in static storage.
+
+#define LOADER_MAX_OBJECTS 16
+
+#ifdef __x86_64__
+using ELF = ELF64;
+#else
+using ELF = ELF32;
+#endif
+
+using Header = ELF::Header;
+using Program = ELF::Program;
+using Symbole = ELF::Symbole;
+using Dynamic = ELF::Dynamic;
+using Relocation = ELF::Relocation;
+using RelocationAddend = ELF::RelocationAddend;
+
+struct LoadedObject
+{
+    const char *name;
+    uintptr_t base;
+
+    Dynamic *dynamic;
+
+    const char *strings;
+    Symbole *symboles;
+    const uint32_t *hash;
+
+    uintptr_t relocations;
+    size_t relocations_size;
+
+    uintptr_t relocations_addend;
+    size_t relocations_addend_size;
+
+    uintptr_t plt_relocations;
+    size_t plt_relocations_size;
+    bool plt_relocations_addend;
+
+    uintptr_t init;
+    uintptr_t init_array;
+    size_t init_array_size;
+};
+
+static LoadedObject _objects[LOADER_MAX_OBJECTS] = {};
+static size_t _objects_count = 0;
+
+/* --- Utilities ------------------------------------------------------------ */
+
+static size_t loader_strlen(const char *string)
+{
+    size_t length = 0;
+
+    while (string[length])
+    {
+        length++;
+    }
+
+    return length;
+}
+
+static bool loader_streq(const char *left, const char *right)
+{
+    while (*left && *left == *right)
+    {
+        left++;
+        right++;
+    }
+
+    return *left == *right;
+}
+
+static void loader_copy(void *destination, const void *source, size_t size)
+{
+    auto to = static_cast<char *>(destination);
+    auto from = static_cast<const char *>(source);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        to[i] = from[i];
+    }
+}
+
+static void loader_write(const char *string)
+{
+    size_t written = 0;
+    hj_handle_write(2, string, loader_strlen(string), &written);
+}
+
+static void __no_return loader_fail(const char *message, const char *name)
+{
+    loader_write("ld.so: ");
+    loader_write(message);
+    loader_write(" ");
+    loader_write(name);
+    loader_write("\n");
+
+    hj_process_exit(PROCESS_FAILURE);
+
+    __builtin_unreachable();
+}
+
+/* --- Objects -------------------------------------------------------------- */
+
+static void object_parse_dynamic(LoadedObject &object)
+{
+    for (Dynamic *dynamic = object.dynamic; dynamic->tag != ELF_DYNAMIC_NULL; dynamic++)
+    {
+        uintptr_t address = object.base + dynamic->value;
+
+        switch (dynamic->tag)
+        {
+        case ELF_DYNAMIC_STRTAB:
+            object.strings = reinterpret_cast<const char *>(address);
+            break;
+
+        case ELF_DYNAMIC_SYMTAB:
+            object.symboles = reinterpret_cast<Symbole *>(address);
+            break;
+
+        case ELF_DYNAMIC_HASH:
+            object.hash = reinterpret_cast<const uint32_t *>(address);
+            break;
+
+        case ELF_DYNAMIC_REL:
+            object.relocations = address;
+            break;
+
+        case ELF_DYNAMIC_RELSZ:
+            object.relocations_size = dynamic->value;
+            break;
+
+        case ELF_DYNAMIC_RELA:
+            object.relocations_addend = address;
+            break;
+
+        case ELF_DYNAMIC_RELASZ:
+            object.relocations_addend_size = dynamic->value;
+            break;
+
+        case ELF_DYNAMIC_JMPREL:
+            object.plt_relocations = address;
+            break;
+
+        case ELF_DYNAMIC_PLTRELSZ:
+            object.plt_relocations_size = dynamic->value;
+            break;
+
+        case ELF_DYNAMIC_PLTREL:
+            object.plt_relocations_addend = dynamic->value == ELF_DYNAMIC_RELA;
+            break;
+
+        case ELF_DYNAMIC_INIT:
+            object.init = address;
+            break;
+
+        case ELF_DYNAMIC_INIT_ARRAY:
+            object.init_array = address;
+            break;
+
+        case ELF_DYNAMIC_INIT_ARRAYSZ:
+            object.init_array_size = dynamic->value;
+            break;
+
+        case ELF_DYNAMIC_TEXTREL:
+            // The text of every object is shared between tasks and mapped
+            // read-only, it can't be patched.
+            loader_fail("text relocations are not supported in", object.name);
+
+        default:
+            break;
+        }
+    }
+
+    if (object.strings == nullptr || object.symboles == nullptr || object.hash == nullptr)
+    {
+        loader_fail("missing dynamic symbol table in", object.name);
+    }
+}
+
+static LoadedObject &object_create(const char *name, uintptr_t base, Program *programs, size_t count, size_t size)
+{
+    if (_objects_count == LOADER_MAX_OBJECTS)
+    {
+        loader_fail("too many libraries, can't load", name);
+    }
+
+    LoadedObject &object = _objects[_objects_count++];
+
+    object.name = name;
+    object.base = base;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto program = reinterpret_cast<Program *>(reinterpret_cast<uintptr_t>(programs) + i * size);
+
+        if (program->type == ELF_PROGRAM_TYPE_DYNAMIC)
+        {
+            object.dynamic = reinterpret_cast<Dynamic *>(base + program->vaddr);
+        }
+    }
+
+    if (object.dynamic == nullptr)
+    {
+        loader_fail("no dynamic section in", name);
+    }
+
+    object_parse_dynamic(object);
+
+    return object;
+}
+
+static LoadedObject *object_by_name(const char *name)
+{
+    for (size_t i = 0; i < _objects_count; i++)
+    {
+        if (loader_streq(_objects[i].name, name))
+        {
+            return &_objects[i];
+        }
+    }
+
+    return nullptr;
+}
+
+static void object_load(const char *name)
+{
+    char path[PATH_LENGTH];
+
+    size_t prefix_length = loader_strlen(LIBRARIES_PATH "/");
+    size_t name_length = loader_strlen(name);
+
+    if (prefix_length + name_length >= PATH_LENGTH)
+    {
+        loader_fail("library name too long", name);
+    }
+
+    loader_copy(path, LIBRARIES_PATH "/", prefix_length);
+    loader_copy(path + prefix_length, name, name_length + 1);
+
+    uintptr_t base = 0;
+
+    if (hj_process_load_library(path, prefix_length + name_length, &base) != SUCCESS)
+    {
+        loader_fail("failed to load", path);
+    }
+
+    // The first segment of a shared object starts at the beginning of the
+    // file, so its headers are mapped too.
+    auto header = reinterpret_cast<Header *>(base);
+
+    if (!header->valid() || header->type != ELF_ETYPE_DYN)
+    {
+        loader_fail("not a shared object", path);
+    }
+
+    auto programs = reinterpret_cast<Program *>(base + header->phoff);
+
+    object_create(name, base, programs, header->phnum, header->phentsize);
+}
+
+// Breadth first, so the order of _objects is also the lookup order.
+static void object_load_dependencies()
+{
+    for (size_t i = 0; i < _objects_count; i++)
+    {
+        LoadedObject &object = _objects[i];
+
+        for (Dynamic *dynamic = object.dynamic; dynamic->tag != ELF_DYNAMIC_NULL; dynamic++)
+        {
+            if (dynamic->tag != ELF_DYNAMIC_NEEDED)
+            {
+                continue;
+            }
+
+            const char *name = object.strings + dynamic->value;
+
+            if (object_by_name(name) == nullptr)
+            {
+                object_load(name);
+            }
+        }
+    }
+}
+
+/* --- Symboles ------------------------------------------------------------- */
+
+static uint32_t symbole_hash(const char *name)
+{
+    uint32_t hash = 0;
+
+    while (*name)
+    {
+        hash = (hash << 4) + static_cast<uint8_t>(*name++);
+
+        uint32_t high = hash & 0xf0000000;
+
+        if (high)
+        {
+            hash ^= high >> 24;
+        }
+
+        hash &= ~high;
+    }
+
+    return hash;
+}
+
+static Symbole *object_lookup(LoadedObject &object, const char *name, uint32_t hash)
+{
+    uint32_t bucket_count = object.hash[0];
+    const uint32_t *buckets = object.hash + 2;
+    const uint32_t *chains = buckets + bucket_count;
+
+    for (uint32_t i = buckets[hash % bucket_count]; i != 0; i = chains[i])
+    {
+        Symbole *symbole = &object.symboles[i];
+
+        if (symbole->shndx == ELF_SYMBOLE_UNDEFINED)
+        {
+            continue;
+        }
+
+        if (symbole->binding() != ELF_SYMBOLE_BINDING_GLOBAL &&
+            symbole->binding() != ELF_SYMBOLE_BINDING_WEAK)
+        {
+            continue;
+        }
+
+        if (loader_streq(object.strings + symbole->name, name))
+        {
+            return symbole;
+        }
+    }
+
+    return nullptr;
+}
+
+// Looks the symbole up in every object in load order, so the program can
+// interpose the definitions of its libraries.
+static uintptr_t symbole_resolve(const char *name, bool weak, LoadedObject *skip)
+{
+    uint32_t hash = symbole_hash(name);
+
+    for (size_t i = 0; i < _objects_count; i++)
+    {
+        if (&_objects[i] == skip)
+        {
+            continue;
+        }
+
+        Symbole *symbole = object_lookup(_objects[i], name, hash);
+
+        if (symbole != nullptr)
+        {
+            return _objects[i].base + symbole->value;
+        }
+    }
+
+    if (!weak)
+    {
+        loader_fail("undefined symbole", name);
+    }
+
+    return 0;
+}
+
+/* --- Relocations ---------------------------------------------------------- */
+
+static uintptr_t relocation_addend(Relocation &relocation, uintptr_t *target)
+{
+    __unused(relocation);
+    return *target;
+}
+
+static uintptr_t relocation_addend(RelocationAddend &relocation, uintptr_t *target)
+{
+    __unused(target);
+    return relocation.addend;
+}
+
+template <typename TRelocation>
+static void object_relocate(LoadedObject &object, uintptr_t table, size_t size)
+{
+    auto relocations = reinterpret_cast<TRelocation *>(table);
+
+    for (size_t i = 0; i < size / sizeof(TRelocation); i++)
+    {
+        TRelocation &relocation = relocations[i];
+
+        auto target = reinterpret_cast<uintptr_t *>(object.base + relocation.offset);
+        uintptr_t addend = relocation_addend(relocation, target);
+
+        Symbole *symbole = nullptr;
+        uintptr_t address = 0;
+
+        if (relocation.symbole() != 0)
+        {
+            symbole = &object.symboles[relocation.symbole()];
+
+            const char *name = object.strings + symbole->name;
+            bool weak = symbole->binding() == ELF_SYMBOLE_BINDING_WEAK;
+
+            // Copies are made into the program from the library defining
+            // the variable, the program's own definition is the copy.
+            LoadedObject *skip = relocation.type() == ELF_RELOCATION_COPY ? &object : nullptr;
+
+            address = symbole_resolve(name, weak, skip);
+        }
+
+        switch (relocation.type())
+        {
+        case ELF_RELOCATION_NONE:
+            break;
+
+        case ELF_RELOCATION_ABSOLUTE:
+            *target = address + addend;
+            break;
+
+        case ELF_RELOCATION_PC_RELATIVE:
+            *reinterpret_cast<uint32_t *>(target) = address + addend - reinterpret_cast<uintptr_t>(target);
+            break;
+
+        case ELF_RELOCATION_COPY:
+            loader_copy(target, reinterpret_cast<void *>(address), symbole->size);
+            break;
+
+        case ELF_RELOCATION_GLOBAL_DATA:
+        case ELF_RELOCATION_JUMP_SLOT:
+            *target = address;
+            break;
+
+        case ELF_RELOCATION_RELATIVE:
+            *target = object.base + addend;
+            break;
+
+        default:
+            loader_fail("unsupported relocation in", object.name);
+        }
+    }
+}
+
+// Everything is bound now, there is no lazy PLT resolution.
+static void object_relocate(LoadedObject &object)
+{
+    object_relocate<Relocation>(object, object.relocations, object.relocations_size);
+    object_relocate<RelocationAddend>(object, object.relocations_addend, object.relocations_addend_size);
+
+    if (object.plt_relocations_addend)
+    {
+        object_relocate<RelocationAddend>(object, object.plt_relocations, object.plt_relocations_size);
+    }
+    else
+    {
+        object_relocate<Relocation>(object, object.plt_relocations, object.plt_relocations_size);
+    }
+}
+
+/* --- Initialization ------------------------------------------------------- */
+
+static void object_initialize(LoadedObject &object)
+{
+    if (object.init)
+    {
+        reinterpret_cast<void (*)()>(object.init)();
+    }
+
+    auto init_array = reinterpret_cast<void (**)(int, char **, char **)>(object.init_array);
+
+    for (size_t i = 0; i < object.init_array_size / sizeof(uintptr_t); i++)
+    {
+        init_array[i](0, nullptr, nullptr);
+    }
+}
+
+/* --- Entry point ---------------------------------------------------------- */
+
+extern "C" uintptr_t __loader_link(int argc, char **argv, char *env, LaunchpadImage *image)
+{
+    __unused(argc);
+    __unused(argv);
+    __unused(env);
+
+    if (image == nullptr || image->program_headers == 0)
+    {
+        loader_fail("is started by the kernel for dynamically linked programs,", "not on its own");
+    }
+
+    auto programs = reinterpret_cast<Program *>(image->program_headers);
+    uintptr_t base = 0;
+
+    for (size_t i = 0; i < image->program_header_count; i++)
+    {
+        auto program = reinterpret_cast<Program *>(image->program_headers + i * image->program_header_size);
+
+        if (program->type == ELF_PROGRAM_TYPE_PHDR)
+        {
+            base = image->program_headers - program->vaddr;
+        }
+    }
+
+    object_create("program", base, programs, image->program_header_count, image->program_header_size);
+
+    object_load_dependencies();
+
+    // Libraries come after what depends on them, going backward relocates
+    // and initializes libsystem first and the program last.
+    for (size_t i = _objects_count; i > 0; i--)
+    {
+        object_relocate(_objects[i - 1]);
+    }
+
+    for (size_t i = _objects_count; i > 0; i--)
+    {
+        object_initialize(_objects[i - 1]);
+    }
+
+    return image->entry;
+}
+
+// The stack is left as the kernel built it, so the program's own entry
+// point finds argc, argv and env where it expects them.
+#ifdef __x86_64__
+asm(".global __loader_start\n"
+    "__loader_start:\n"
+    "    mov 0(%rsp), %rdi\n"
+    "    mov 8(%rsp), %rsi\n"
+    "    mov 16(%rsp), %rdx\n"
+    "    mov 24(%rsp), %rcx\n"
+    "    call __loader_link\n"
+    "    jmp *%rax\n");
+#else
+asm(".global __loader_start\n"
+    "__loader_start:\n"
+    "    call __loader_link\n"
+    "    jmp *%eax\n");
+#endif
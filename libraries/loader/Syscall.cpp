@@ -0,0 +1 @@
+#include <abi/Syscalls.cpp>
@@ -0,0 +1,169 @@
+#!/usr/bin/python3
+
+# Pre-decode a PNG image into the format used by libgraphic/BitmapCache.h,
+# raw RGBA pixels followed by a trailer, so it can be mapped at runtime
+# without being decoded.
+
+import os
+import struct
+import sys
+import zlib
+
+BITMAP_CACHE_MAGIC = 0x48434d42
+BITMAP_CACHE_VERSION = 3
+
+BITMAP_CACHE_KEY_SPAN = 1024
+
+ADAM7 = [(0, 0, 8, 8), (4, 0, 8, 8), (0, 4, 4, 8), (2, 0, 4, 4),
+         (0, 2, 2, 4), (1, 0, 2, 2), (0, 1, 1, 2)]
+
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def unfilter(kind, row, previous, bpp):
+    if kind == 1:
+        for i in range(bpp, len(row)):
+            row[i] = (row[i] + row[i - bpp]) & 0xff
+    elif kind == 2:
+        for i in range(len(row)):
+            row[i] = (row[i] + previous[i]) & 0xff
+    elif kind == 3:
+        for i in range(len(row)):
+            left = row[i - bpp] if i >= bpp else 0
+            row[i] = (row[i] + ((left + previous[i]) >> 1)) & 0xff
+    elif kind == 4:
+        for i in range(len(row)):
+            a = row[i - bpp] if i >= bpp else 0
+            b = previous[i]
+            c = previous[i - bpp] if i >= bpp else 0
+            pa, pb, pc = abs(b - c), abs(a - c), abs(a + b - 2 * c)
+            predictor = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+            row[i] = (row[i] + predictor) & 0xff
+
+
+# Same as hash() in libutils/Hash.h.
+def djb2(data):
+    value = 5381
+
+    for byte in data:
+        value = (value * 33 + byte) & 0xffffffff
+
+    return value
+
+
+# Same as bitmap_cache_key() in libgraphic/BitmapCache.cpp.
+def key_hash(data):
+    if len(data) <= BITMAP_CACHE_KEY_SPAN * 2:
+        return djb2(data)
+
+    return djb2(data[:BITMAP_CACHE_KEY_SPAN] + data[-BITMAP_CACHE_KEY_SPAN:])
+
+
+def decode(data):
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise Exception("not a PNG file")
+
+    offset = 8
+    compressed = b""
+    palette = []
+    transparency = None
+
+    while offset < len(data):
+        length, kind = struct.unpack(">I4s", data[offset:offset + 8])
+        content = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlaced = struct.unpack(">IIBBBBB", content)
+        elif kind == b"PLTE":
+            palette = [list(content[i:i + 3]) + [255] for i in range(0, length, 3)]
+        elif kind == b"tRNS":
+            transparency = content
+        elif kind == b"IDAT":
+            compressed += content
+        elif kind == b"IEND":
+            break
+
+    raw = zlib.decompress(compressed)
+
+    channels = CHANNELS[color]
+    bits = channels * depth
+    bpp = max(1, bits // 8)
+
+    if color == 3 and transparency:
+        for i, alpha in enumerate(transparency[:len(palette)]):
+            palette[i][3] = alpha
+
+    key = None
+
+    if color == 0 and transparency and len(transparency) == 2:
+        key = list(struct.unpack(">H", transparency))
+    elif color == 2 and transparency and len(transparency) == 6:
+        key = list(struct.unpack(">HHH", transparency))
+
+    pixels = bytearray(width * height * 4)
+    position = 0
+
+    for x0, y0, dx, dy in (ADAM7 if interlaced else [(0, 0, 1, 1)]):
+        pass_width = (width - x0 + dx - 1) // dx
+        pass_height = (height - y0 + dy - 1) // dy
+
+        if pass_width <= 0 or pass_height <= 0:
+            continue
+
+        row_size = (pass_width * bits + 7) // 8
+        previous = bytearray(row_size)
+
+        for y in range(pass_height):
+            kind = raw[position]
+            row = bytearray(raw[position + 1:position + 1 + row_size])
+            position += 1 + row_size
+
+            unfilter(kind, row, previous, bpp)
+            previous = row
+
+            for x in range(pass_width):
+                if depth == 16:
+                    samples = [row[(x * channels + i) * 2] << 8 | row[(x * channels + i) * 2 + 1] for i in range(channels)]
+                    bytes = [sample >> 8 for sample in samples]
+                elif depth == 8:
+                    samples = list(row[x * channels:(x + 1) * channels])
+                    bytes = samples
+                else:
+                    bit = x * depth
+                    sample = (row[bit // 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1)
+                    samples = [sample]
+                    bytes = [sample * 255 // ((1 << depth) - 1)]
+
+                if color == 6:
+                    pixel = bytes
+                elif color == 4:
+                    pixel = [bytes[0]] * 3 + [bytes[1]]
+                elif color == 2:
+                    pixel = bytes + [0 if samples == key else 255]
+                elif color == 0:
+                    pixel = [bytes[0]] * 3 + [0 if samples == key else 255]
+                else:
+                    pixel = palette[samples[0]] if samples[0] < len(palette) else [0, 0, 0, 255]
+
+                index = ((y0 + y * dy) * width + x0 + x * dx) * 4
+                pixels[index:index + 4] = bytearray(pixel)
+
+    return width, height, pixels
+
+
+in_filename = sys.argv[1]
+out_filename = sys.argv[2]
+
+infp = open(in_filename, 'rb')
+data = infp.read()
+infp.close()
+
+width, height, pixels = decode(data)
+
+outfp = open(out_filename, 'wb')
+
+outfp.write(pixels)
+outfp.write(struct.pack("<IIIIII", BITMAP_CACHE_MAGIC, BITMAP_CACHE_VERSION, width, height, len(data), key_hash(data)))
+
+outfp.close()
@@ -0,0 +1,393 @@
+#!/usr/bin/python3
+
+# Compile a .markup window description into the format described in
+# libwidget/MarkupBinary.h. Attributes are resolved here exactly like
+# libwidget/Markup.cpp does at runtime, so loading a window only has to
+# walk the nodes.
+
+import struct
+import sys
+
+MARKUP_BINARY_MAGIC = 0x4250524d
+MARKUP_BINARY_VERSION = 2
+
+MARKUP_BINARY_NO_STRING = 0xffffffff
+
+WINDOW, CONTAINER, PANEL, BUTTON, LABEL, IMAGE, SLIDER, PLACEHOLDER = range(8)
+
+WIDGETS = {
+    "Container": CONTAINER,
+    "Panel": PANEL,
+    "Button": BUTTON,
+    "Label": LABEL,
+    "Image": IMAGE,
+    "Slider": SLIDER,
+}
+
+FLAGS = {
+    "fill": 1 << 2,
+    "rounded": 1 << 3,
+    "filled": 1 << 4,
+    "outlined": 1 << 5,
+    "borderless": 1 << 6,
+    "resizable": 1 << 7,
+    "always-focused": 1 << 8,
+    "swallow": 1 << 9,
+    "transparent": 1 << 10,
+}
+
+HAS_LAYOUT = 1 << 0
+HAS_PADDING = 1 << 1
+
+LAYOUT_STACK, LAYOUT_GRID, LAYOUT_VGRID, LAYOUT_HGRID, LAYOUT_VFLOW, LAYOUT_HFLOW = range(6)
+
+POSITIONS = [
+    "left", "center", "right",
+    "top_left", "top_center", "top_right",
+    "bottom_left", "bottom_center", "bottom_right",
+]
+
+WHITESPACE = " \n\r\t"
+ALPHA = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+
+ESCAPES = {'"': '"', '\\': '\\', '/': '/', 'b': '\b', 'f': '\f', 'n': '\n', 'r': '\r', 't': '\t'}
+
+
+class Scanner:
+    def __init__(self, text):
+        self.text = text
+        self.offset = 0
+
+    def current(self):
+        return self.text[self.offset] if self.offset < len(self.text) else '\0'
+
+    def peek(self, offset):
+        index = self.offset + offset
+        return self.text[index] if index < len(self.text) else '\0'
+
+    def forward(self):
+        self.offset += 1
+
+    def ended(self):
+        return self.offset >= len(self.text)
+
+    def skip(self, chr):
+        if self.current() == chr:
+            self.forward()
+            return True
+
+        return False
+
+    def skip_word(self, word):
+        if self.text.startswith(word, self.offset):
+            self.offset += len(word)
+            return True
+
+        return False
+
+    def eat(self, chars):
+        while not self.ended() and self.current() in chars:
+            self.forward()
+
+    def number(self):
+        number = 0
+
+        while not self.ended() and self.current() in "0123456789":
+            number = number * 10 + ord(self.current()) - ord('0')
+            self.forward()
+
+        return number
+
+
+# --- Parser (mirrors libmarkup/Parser.cpp) ----------------------------------- #
+
+def identifier(scan):
+    start = scan.offset
+    scan.eat(ALPHA)
+    return scan.text[start:scan.offset]
+
+
+def string(scan):
+    scan.skip('"')
+    result = ""
+
+    while not scan.ended() and scan.current() != '"':
+        if scan.current() == '\\':
+            scan.forward()
+
+            if scan.current() == 'u':
+                scan.forward()
+                result += chr(int(scan.text[scan.offset:scan.offset + 4], 16))
+                scan.offset += 4
+            else:
+                result += ESCAPES.get(scan.current(), scan.current())
+                scan.forward()
+        else:
+            result += scan.current()
+            scan.forward()
+
+    scan.skip('"')
+
+    return result
+
+
+def node(scan):
+    scan.eat(WHITESPACE)
+    scan.skip('<')
+    scan.eat(WHITESPACE)
+
+    current = {"type": identifier(scan), "attributes": [], "childs": []}
+
+    scan.eat(WHITESPACE)
+
+    while not scan.ended() and scan.current() in ALPHA:
+        name = identifier(scan)
+        value = None
+
+        scan.eat(WHITESPACE)
+
+        if scan.skip('='):
+            scan.eat(WHITESPACE)
+            value = string(scan)
+
+        current["attributes"].append((name, value))
+        scan.eat(WHITESPACE)
+
+    if scan.skip('/'):
+        scan.skip('>')
+        return current
+
+    scan.skip('>')
+    scan.eat(WHITESPACE)
+
+    while not scan.ended() and scan.peek(0) == '<' and scan.peek(1) != '/':
+        current["childs"].append(node(scan))
+        scan.eat(WHITESPACE)
+
+    scan.skip('<')
+    scan.skip('/')
+    scan.eat(WHITESPACE)
+
+    other = identifier(scan)
+
+    if other != current["type"]:
+        print(f"warning: opening tag <{current['type']}> doesn't match closing tag </{other}>", file=sys.stderr)
+
+    scan.eat(WHITESPACE)
+    scan.skip('>')
+
+    return current
+
+
+def has_attribute(node, name):
+    return any(attribute == name for attribute, _ in node["attributes"])
+
+
+def get_attribute(node, name, default=None):
+    for attribute, value in node["attributes"]:
+        if attribute == name:
+            return value if value is not None else default
+
+    return default
+
+
+# --- Attributes (mirrors libwidget/Markup.cpp) ------------------------------- #
+
+def layout_parse(text):
+    result = (LAYOUT_STACK, 0, 0, 0, 0)
+
+    if text is None:
+        return result
+
+    scan = Scanner(text)
+
+    def arguments(count):
+        scan.skip('(')
+        values = []
+
+        for i in range(count):
+            scan.eat(" ")
+            values.append(scan.number())
+            scan.eat(" ")
+
+            if i + 1 < count:
+                scan.skip(',')
+
+        return values
+
+    if scan.skip_word("stack"):
+        result = (LAYOUT_STACK, 0, 0, 0, 0)
+
+    if scan.skip_word("grid"):
+        hcell, vcell, hspacing, vspacing = arguments(4)
+        result = (LAYOUT_GRID, hcell, vcell, hspacing, vspacing)
+
+    if scan.skip_word("vgrid"):
+        result = (LAYOUT_VGRID, 0, 0, 0, arguments(1)[0])
+
+    if scan.skip_word("hgrid"):
+        result = (LAYOUT_HGRID, 0, 0, arguments(1)[0], 0)
+
+    if scan.skip_word("vflow"):
+        result = (LAYOUT_VFLOW, 0, 0, 0, arguments(1)[0])
+
+    if scan.skip_word("hflow"):
+        result = (LAYOUT_HFLOW, 0, 0, arguments(1)[0], 0)
+
+    return result
+
+
+def insets_parse(text):
+    if text is None:
+        return (0, 0, 0, 0)
+
+    scan = Scanner(text)
+
+    if not scan.skip_word("insets"):
+        return (0, 0, 0, 0)
+
+    scan.skip('(')
+    scan.eat(" ")
+
+    args = []
+
+    while len(args) < 4 and not scan.ended() and scan.current() in "0123456789":
+        args.append(scan.number())
+        scan.eat(" ")
+        scan.skip(',')
+        scan.eat(" ")
+
+    if len(args) == 1:
+        return (args[0], args[0], args[0], args[0])
+    elif len(args) == 2:
+        return (args[0], args[0], args[1], args[1])
+    elif len(args) == 3:
+        return (args[0], args[1], args[2], args[2])
+    elif len(args) == 4:
+        return tuple(args)
+
+    return (0, 0, 0, 0)
+
+
+def int_parse(text, default):
+    try:
+        return int(text, 10)
+    except (TypeError, ValueError):
+        return default
+
+
+# --- Emitter ----------------------------------------------------------------- #
+
+class Strings:
+    def __init__(self):
+        self.blob = bytearray()
+        self.offsets = {}
+
+    def add(self, text):
+        if text is None:
+            return MARKUP_BINARY_NO_STRING
+
+        if text not in self.offsets:
+            self.offsets[text] = len(self.blob)
+            self.blob += text.encode("utf-8") + b"\0"
+
+        return self.offsets[text]
+
+
+def compile_node(node, root, strings, nodes):
+    widget = WINDOW if root else WIDGETS.get(node["type"], PLACEHOLDER)
+
+    flags = 0
+
+    for name, flag in FLAGS.items():
+        if has_attribute(node, name):
+            flags |= flag
+
+    layout = (LAYOUT_STACK, 0, 0, 0, 0)
+
+    if has_attribute(node, "layout"):
+        flags |= HAS_LAYOUT
+        layout = layout_parse(get_attribute(node, "layout"))
+
+    padding = (0, 0, 0, 0)
+
+    if has_attribute(node, "padding"):
+        flags |= HAS_PADDING
+        padding = insets_parse(get_attribute(node, "padding"))
+
+    position = 0
+    text = None
+    icon = None
+    path = None
+    title = None
+    width = 0
+    height = 0
+
+    if widget == WINDOW:
+        width = int_parse(get_attribute(node, "width"), 250)
+        height = int_parse(get_attribute(node, "height"), 250)
+        icon = get_attribute(node, "icon")
+        title = get_attribute(node, "title")
+    elif widget == BUTTON:
+        if has_attribute(node, "text"):
+            text = get_attribute(node, "text", "Button")
+
+        if has_attribute(node, "icon"):
+            icon = get_attribute(node, "icon", "duck")
+    elif widget == LABEL:
+        text = get_attribute(node, "text", "Label")
+        position_name = get_attribute(node, "position", "left")
+        position = POSITIONS.index(position_name) if position_name in POSITIONS else 0
+    elif widget == IMAGE:
+        path = get_attribute(node, "path", "null")
+
+    nodes.append(struct.pack(
+        "<BBBBHH4i4i6I2i",
+        widget, layout[0], position, 0,
+        flags, len(node["childs"]),
+        *layout[1:], *padding,
+        strings.add(node["type"]),
+        strings.add(get_attribute(node, "id")),
+        strings.add(text),
+        strings.add(icon),
+        strings.add(path),
+        strings.add(title),
+        width, height))
+
+    for child in node["childs"]:
+        compile_node(child, False, strings, nodes)
+
+
+# Same as hash() in libutils/Hash.h.
+def djb2(data):
+    value = 5381
+
+    for byte in data:
+        value = (value * 33 + byte) & 0xffffffff
+
+    return value
+
+
+in_filename = sys.argv[1]
+out_filename = sys.argv[2]
+
+with open(in_filename, 'rb') as infp:
+    source = infp.read()
+
+text = source.decode("utf-8")
+
+if text.startswith("\ufeff"):
+    text = text[1:]
+
+strings = Strings()
+nodes = []
+
+compile_node(node(Scanner(text)), True, strings, nodes)
+
+with open(out_filename, 'wb') as outfp:
+    outfp.write(struct.pack("<IIIIII", MARKUP_BINARY_MAGIC, MARKUP_BINARY_VERSION, len(source), djb2(source), len(nodes), len(strings.blob)))
+
+    for packed in nodes:
+        outfp.write(packed)
+
+    outfp.write(strings.blob)